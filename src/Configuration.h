@@ -57,6 +57,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MAXVARS             1024                    // 8 + MAXVARLEN + MAXDIM * 2  (ie, 56 bytes) - these do not incl array members
 #define VARS_HASHMAP_SIZE   1371                    // Size of the variables hash table
                                                     //  - first prime number at least 1/3 greater than MAXVARS.
+#define VARCACHE_SIZE       2048                    // Size of the cache of resolved variable references in the program
+                                                    //  - must be a power of 2.
+#define LITCACHE_SIZE       1024                    // Size of the cache of decoded numeric and string literals in the program
+                                                    //  - must be a power of 2.
+#define LITPOOL_SIZE        (64 * 1024)             // Size of the memory holding the cached string literals (in bytes)
 
 // more static memory allocations (less important)
 #define MAXFORLOOPS         50                      // each entry uses 17 bytes
@@ -68,6 +73,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MAXSUBFUN           512                     // each entry takes up 4 bytes
 #define FUN_HASHMAP_SIZE    683                     // Size of the functions hash table
                                                     //  - first prime number at least 1/3 greater than MAXSUBFUN.
+#define MAXJMPTBL           8192                    // each entry takes up 40 bytes
+#define JMPTBL_HASHMAP_SIZE 10937                   // Size of the control-flow jump hash table
+                                                    //  - first prime number at least 1/3 greater than MAXJMPTBL.
 
 // operating characteristics
 #define MAXVARLEN           32                      // maximum length of a variable name
@@ -81,6 +89,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INPBUF_SIZE         512                     // Size of the input buffer, inpbuf[].
 #define TKNBUF_SIZE         512                     // Size of the token buffer, tknbuf[].
 
+// minimum periods between runs of the "background" tasks (in milliseconds)
+#define CONSOLE_PUMP_PERIOD  1                      // also the latency of the break key
+#define CONSOLE_FLUSH_PERIOD 16                     // about once per frame at 60Hz
+#define SERIAL_PUMP_PERIOD   1
+#define EVENTS_PUMP_PERIOD   5
+#define GRAPHICS_PUMP_PERIOD 2                      // windows are only refreshed once per frame anyway
+#define AUDIO_PUMP_PERIOD    5                      // must be well within the ~46ms audio ring buffer
+
 
 // define the maximum number of arguments to PRINT, INPUT, WRITE, ON, DIM, ERASE, DATA and READ
 // each entry uses zero bytes.  The number is limited by the length of a command line
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../common/error.h"
 #include "../core/Commands.h"
 #include "../core/MMBasic.h"
+#include "../core/jmptbl.h"
 #include "../core/tokentbl.h"
 
 void cmd_do(void) {
@@ -98,9 +99,14 @@ void cmd_do(void) {
     dostack[doindex].doptr = nextstmt;
     dostack[doindex].level = LocalIndex;
 
-    // now find the matching LOOP command
+    // now find the matching LOOP command, if it was resolved by PrepareProgram() then this is a simple lookup
+    const struct s_jmptbl *jmp = jmptbl_find(nextstmt);
     i = 1; p = nextstmt;
     while(1) {
+        if(jmp && jmp->end) {
+            dostack[doindex].loopptr = p = jmp->end;
+            break;
+        }
         p = GetNextCommand(p, &tp, "No matching LOOP");
         const CommandToken cmd = commandtbl_decode(p);
         if (cmd == cmdtoken) i++;                                   // entered a nested DO or WHILE loop
@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
 #include "../common/mmb4l.h"
+#include "../common/console.h"
 #include "../common/cstring.h"
 #include "../common/path.h"
 #include "../common/program.h"
@@ -174,6 +175,7 @@ void cmd_edit(void) {
     char command[CMD_SIZE] = { 0 };
     bool blocking = false;
     ON_FAILURE_ERROR(get_editor_command(file_path, line > 1 ? line : 1, command, &blocking));
+    console_flush();
     errno = 0;
     if (FAILED(system(command))) ERROR_EDITOR_FAILED;
 
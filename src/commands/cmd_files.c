@@ -59,6 +59,7 @@ void cmd_files_internal(const char *p) {
         snprintf(command, STRINGSIZE, "ls");
     }
 
+    console_flush();
     (void) system(command);
     // if (result != 0) ERROR_SYSTEM_COMMAND_FAILED;
 
@@ -96,11 +96,7 @@ static MmResult cmd_framebuffer_copy(const char *p) {
     if (FAILED(result)) return result;
     MmSurface* dst_surface = &graphics_surfaces[dst_id];
 
-    // MMB4L ignores the background flag B for the moment.
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
     bool background = false;
-#pragma GCC diagnostic pop
     if (argc == 5) {
         const char *tp;
         if ((tp = checkstring(argv[4], "B"))) {
@@ -123,8 +119,14 @@ static MmResult cmd_framebuffer_copy(const char *p) {
         return kGraphicsReadAndWriteSurfaceSame;
     }
 
-    return graphics_blit(0, 0, 0, 0, src_surface->width, src_surface->height, src_surface,
-                         dst_surface, 0x0, -1);
+    // Unless the background flag B is specified wait for the previous frame to be
+    // presented before copying, this is the nearest MMB4L has to waiting for the
+    // frame blanking period.
+    if (!background) ON_FAILURE_RETURN(graphics_sync(true));
+
+    ON_FAILURE_RETURN(graphics_blit(0, 0, 0, 0, src_surface->width, src_surface->height,
+                                    src_surface, dst_surface, 0x0, -1));
+    return graphics_sync(false);
 }
 
 /** FRAMEBUFFER CREATE */
@@ -170,17 +172,20 @@ static MmResult cmd_framebuffer_merge(const char *p) {
 
     // Merge L with N.
     src_surface = &graphics_surfaces[GRAPHICS_SURFACE_L];
-    return graphics_blit(0, 0, 0, 0, src_surface->width, src_surface->height, src_surface,
-                         dst_surface, 0x4, GRAPHICS_RGB121_COLOURS[transparent]);
+    result = graphics_blit(0, 0, 0, 0, src_surface->width, src_surface->height, src_surface,
+                           dst_surface, 0x4, GRAPHICS_RGB121_COLOURS[transparent]);
+    if (FAILED(result)) return result;
+
+    return graphics_sync(false);
 }
 
 /** FRAMEBUFFER WAIT */
 static MmResult cmd_framebuffer_wait(const char *p) {
     skipspace(p);
     if (!parse_is_end(p)) return kUnexpectedText;
-    // Empty implementation for now.
-    // On the real PicoMiteVGA this waits until the start of the next frame blanking period.
-    return kOk;
+    // On the real PicoMiteVGA this waits until the start of the next frame blanking period,
+    // MMB4L instead waits until any changes to the display have been presented.
+    return graphics_sync(true);
 }
 
 /** FRAMEBUFFER WRITE {N|F|L} */
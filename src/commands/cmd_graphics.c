@@ -83,7 +83,9 @@ static MmResult cmd_graphics_cls(const char *p) {
 /**
  * GRAPHICS COPY src_id TO dst_id [, when] [, transparent]
  *
- * @param  when         Ignored for the moment by MMB4L.
+ * @param  when         I - copy immediately (the default).
+ *                      B - copy "in the background", i.e. without a render thread sync point.
+ *                      D - wait for the previous frame to be presented before copying.
  * @param  transparent  If T or 1 then treat BLACK as transparent when copying.
  */
 MmResult cmd_graphics_copy(const char *p) {
@@ -106,13 +108,14 @@ MmResult cmd_graphics_copy(const char *p) {
     //     return kGraphicsSurfaceSizeMismatch;
     // }
 
+    char when = 'I';
     if (has_arg(4)) {
         const char *p = argv[4];
-        switch (toupper(*p)) {
+        when = toupper(*p);
+        switch (when) {
             case 'I':
             case 'B':
             case 'D':
-                // Ignore for now
                 break;
             default:
                 return kSyntax;
@@ -125,7 +128,9 @@ MmResult cmd_graphics_copy(const char *p) {
         if (toupper(*p) == 'T' || *p == '1') transparent = RGB_BLACK;
     }
 
-    return graphics_copy(src_surface, dst_surface, transparent);
+    if (when == 'D') ON_FAILURE_RETURN(graphics_sync(true));
+    ON_FAILURE_RETURN(graphics_copy(src_surface, dst_surface, transparent));
+    return when == 'B' ? kOk : graphics_sync(false);
 }
 
 /** GRAPHICS TITLE id, title$ */
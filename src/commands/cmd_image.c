@@ -126,7 +126,7 @@ static MmResult cmd_image_resize_fast(const char *p) {
             start1 += write_surface->width;
         }
         free(buffer);
-        write_surface->dirty = true;
+        graphics_surface_dirty_all(write_surface);
     }
 
     return kOk;
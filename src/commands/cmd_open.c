@@ -66,16 +66,35 @@ static void cmd_open_file(int argc, char **argv) {
         mode = "rb";  // note binary mode
     } else if (strcasecmp(argv[2], "RANDOM") == 0) {
         mode = "x";  // a special mode for MMfopen()
+    } else if (strcasecmp(argv[2], "MAP") == 0) {
+        mode = "m";  // read-only memory mapping, another special mode
     } else {
         ERROR_INVALID("file access mode");
     }
 
+    FileBuffering buffering = kFileBufferFull;
+    if (argc == 7) {
+        if (strcasecmp(argv[6], "BUFFERED") == 0) {
+            buffering = kFileBufferFull;
+        } else if (strcasecmp(argv[6], "LINE") == 0) {
+            buffering = kFileBufferLine;
+        } else if (strcasecmp(argv[6], "UNBUFFERED") == 0) {
+            buffering = kFileBufferNone;
+        } else {
+            ERROR_INVALID("file buffering");
+        }
+    }
+
     MmResult result = kOk;
     int fnbr = parse_file_number(argv[4], false);
     if (fnbr == -1) {
         result = kFileInvalidFileNumber;
     } else {
         result = file_open(filename, mode, fnbr);
+        if (SUCCEEDED(result)) {
+            result = file_set_buffering(fnbr, buffering);
+            if (FAILED(result)) (void) file_close(fnbr);
+        }
     }
     ON_FAILURE_ERROR(result);
 }
@@ -98,7 +117,7 @@ static void cmd_open_serial(int argc, char **argv) {
 }
 
 /**
- * OPEN fname$ FOR mode AS [#]fnbr
+ * OPEN fname$ FOR mode AS [#]fnbr [, {BUFFERED | LINE | UNBUFFERED}]
  * OPEN comspec$ AS [#]fnbr
  * OPEN comspec$ AS GPS [,timezone_offset] [,monitor]
  */
@@ -106,7 +125,7 @@ void cmd_open(void) {
     char separators[4] = { tokenFOR, tokenAS, ',', '\0' };
     getargs(&cmdline, 7, separators);
 
-    if (argc == 5 && *argv[1] == tokenFOR && *argv[3] == tokenAS) {
+    if ((argc == 5 || argc == 7) && *argv[1] == tokenFOR && *argv[3] == tokenAS) {
         cmd_open_file(argc, argv);
     } else if (argc > 2 && argc < 8 && *argv[1] == tokenAS && strcasecmp(argv[2], "GPS") == 0) {
         cmd_open_gps(argc, argv);
@@ -252,6 +252,11 @@ static void cmd_option_set(const char *p) {
             ON_FAILURE_ERROR(audio_term());
             break;
 
+        case kOptionRender:
+        case kOptionVSync:
+            graphics_reset_renderers();
+            break;
+
         case kOptionSimulate:
             switch (mmb_options.simulate) {
                 case kSimulateGameMite:
@@ -49,14 +49,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../common/error.h"
 #include "../common/interrupt.h"
 #include "../common/mmtime.h"
+#include "../common/wait.h"
 
 static void cmd_pause_in_interrupt(int64_t duration_ns) {
     int64_t wakeup = mmtime_now_ns() + duration_ns;
     while (mmtime_now_ns() < wakeup) {
         CheckAbort();
 
-        // A short sleep so we do not continue to thrash CPU when paused.
-        nanosleep(&ONE_MICROSECOND, NULL);
+        // Block until there is input, a background task is due or the PAUSE
+        // has expired, so we do not continue to thrash CPU when paused.
+        wait_for_work(wakeup);
     }
     return;
 }
@@ -84,8 +86,9 @@ static void cmd_pause_in_main_program(int64_t duration_ns) {
             return;
         }
 
-        // A short sleep so we do not continue to thrash CPU when paused.
-        nanosleep(&ONE_MICROSECOND, NULL);
+        // Block until there is input, a SETTICK or background task is due or
+        // the PAUSE has expired, so we do not continue to thrash CPU when paused.
+        wait_for_work(wakeup);
     }
 }
 
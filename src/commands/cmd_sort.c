@@ -43,159 +43,266 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "../common/mmb4l.h"
 #include "../common/error.h"
+#include "../common/utility.h"
 
-static void integersort(int64_t *iarray, int n, int64_t *index, int flags,
-                 int startpoint) {
-    int i, j = n, s = 1;
-    int64_t t;
-    if ((flags & 1) == 0) {
-        while (s) {
-            s = 0;
-            for (i = 1; i < j; i++) {
-                if (iarray[i] < iarray[i - 1]) {
-                    t = iarray[i];
-                    iarray[i] = iarray[i - 1];
-                    iarray[i - 1] = t;
-                    s = 1;
-                    if (index != NULL) {
-                        t = index[i - 1 + startpoint];
-                        index[i - 1 + startpoint] = index[i + startpoint];
-                        index[i + startpoint] = t;
-                    }
-                }
-            }
+/** Arrays smaller than this are sorted by insertion sort. */
+#define SORT_INSERTION_THRESHOLD  16
+
+/**
+ * Compares the elements originally at positions 'a' and 'b' of the array
+ * being sorted, returning < 0, 0 or > 0.
+ */
+typedef int (*SortCompareFn)(const void *ctx, int a, int b);
+
+typedef struct {
+    const MMFLOAT *farray;
+    int reverse;
+} FloatSortContext;
+
+typedef struct {
+    const unsigned char *sarray;
+    int offset;
+    int reverse;
+    int case_insensitive;
+} StringSortContext;
+
+/**
+ * Compares two elements, breaking ties on their original position so that
+ * the sort is stable; the old bubble sorts never reordered equal elements
+ * and programs rely on that for the contents of the index array.
+ */
+static inline int sort_compare(SortCompareFn cmp, const void *ctx, int a, int b) {
+    int result = cmp(ctx, a, b);
+    return result ? result : a - b;
+}
+
+static void sort_insertion(int *perm, int lo, int hi, SortCompareFn cmp, const void *ctx) {
+    for (int i = lo + 1; i < hi; i++) {
+        const int x = perm[i];
+        int j = i;
+        while (j > lo && sort_compare(cmp, ctx, perm[j - 1], x) > 0) {
+            perm[j] = perm[j - 1];
             j--;
         }
-    } else {
-        while (s) {
-            s = 0;
-            for (i = 1; i < j; i++) {
-                if (iarray[i] > iarray[i - 1]) {
-                    t = iarray[i];
-                    iarray[i] = iarray[i - 1];
-                    iarray[i - 1] = t;
-                    s = 1;
-                    if (index != NULL) {
-                        t = index[i - 1 + startpoint];
-                        index[i - 1 + startpoint] = index[i + startpoint];
-                        index[i + startpoint] = t;
-                    }
-                }
-            }
-            j--;
+        perm[j] = x;
+    }
+}
+
+static void sort_sift_down(int *perm, int lo, int root, int n, SortCompareFn cmp, const void *ctx) {
+    const int x = perm[lo + root];
+    for (;;) {
+        int child = 2 * root + 1;
+        if (child >= n) break;
+        if (child + 1 < n && sort_compare(cmp, ctx, perm[lo + child], perm[lo + child + 1]) < 0) {
+            child++;
         }
+        if (sort_compare(cmp, ctx, x, perm[lo + child]) >= 0) break;
+        perm[lo + root] = perm[lo + child];
+        root = child;
     }
+    perm[lo + root] = x;
+}
+
+static void sort_heapsort(int *perm, int lo, int hi, SortCompareFn cmp, const void *ctx) {
+    const int n = hi - lo;
+    for (int i = n / 2 - 1; i >= 0; i--) sort_sift_down(perm, lo, i, n, cmp, ctx);
+    for (int i = n - 1; i > 0; i--) {
+        const int t = perm[lo];
+        perm[lo] = perm[lo + i];
+        perm[lo + i] = t;
+        sort_sift_down(perm, lo, 0, i, cmp, ctx);
+    }
+}
+
+static inline void sort_swap(int *perm, int i, int j) {
+    const int t = perm[i];
+    perm[i] = perm[j];
+    perm[j] = t;
+}
+
+/**
+ * Introsort of perm[lo..hi): quicksort with median-of-three pivots, falling
+ * back to heapsort if the recursion gets too deep and insertion sort for
+ * short runs.
+ */
+static void sort_introsort(int *perm, int lo, int hi, int depth, SortCompareFn cmp,
+                           const void *ctx) {
+    while (hi - lo > SORT_INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            sort_heapsort(perm, lo, hi, cmp, ctx);
+            return;
+        }
+
+        const int mid = lo + (hi - 1 - lo) / 2;
+        if (sort_compare(cmp, ctx, perm[mid], perm[lo]) < 0) sort_swap(perm, mid, lo);
+        if (sort_compare(cmp, ctx, perm[hi - 1], perm[lo]) < 0) sort_swap(perm, hi - 1, lo);
+        if (sort_compare(cmp, ctx, perm[hi - 1], perm[mid]) < 0) sort_swap(perm, hi - 1, mid);
+        const int pivot = perm[mid];
+
+        // Hoare partition; the pivot element stops both scans.
+        int i = lo - 1;
+        int j = hi;
+        for (;;) {
+            do i++; while (sort_compare(cmp, ctx, perm[i], pivot) < 0);
+            do j--; while (sort_compare(cmp, ctx, perm[j], pivot) > 0);
+            if (i >= j) break;
+            sort_swap(perm, i, j);
+        }
+
+        // Recurse into the smaller partition and loop on the larger.
+        if (j + 1 - lo < hi - (j + 1)) {
+            sort_introsort(perm, lo, j + 1, depth, cmp, ctx);
+            lo = j + 1;
+        } else {
+            sort_introsort(perm, j + 1, hi, depth, cmp, ctx);
+            hi = j + 1;
+        }
+    }
+    sort_insertion(perm, lo, hi, cmp, ctx);
+}
+
+static void sort_perm(int *perm, int n, SortCompareFn cmp, const void *ctx) {
+    int depth = 0;
+    for (int m = n; m > 1; m >>= 1) depth += 2;
+    sort_introsort(perm, 0, n, depth, cmp, ctx);
+}
+
+/**
+ * Reorders the index array to match a sort.
+ *
+ * @param  perm   perm[i] is the original position of the element now at position i.
+ * @param  tmp    scratch space for 'n' elements.
+ */
+static void sort_apply_index(const int *perm, int n, int64_t *index, int startpoint, int64_t *tmp) {
+    if (index == NULL) return;
+    for (int i = 0; i < n; i++) tmp[i] = index[startpoint + perm[i]];
+    memcpy(&index[startpoint], tmp, n * sizeof(int64_t));
+}
+
+/**
+ * LSD radix sort of integers, a byte at a time; stable and O(n).
+ */
+static void integersort(int64_t *iarray, int n, int64_t *index, int flags,
+                 int startpoint) {
+    if (n < 2) return;
+    uint64_t *keys = malloc(2 * n * sizeof(uint64_t));
+    int *perm = malloc(2 * n * sizeof(int));
+    if (!keys || !perm) {
+        free(keys);
+        free(perm);
+        ERROR_OUT_OF_MEMORY;
+    }
+
+    // Map to unsigned keys with the same ordering, inverted for a descending sort.
+    const uint64_t mask = (flags & 1) ? ~(uint64_t) 0 : 0;
+    for (int i = 0; i < n; i++) {
+        keys[i] = ((uint64_t) iarray[i] ^ ((uint64_t) 1 << 63)) ^ mask;
+        perm[i] = i;
+    }
+
+    uint64_t *src_keys = keys, *dst_keys = keys + n;
+    int *src_perm = perm, *dst_perm = perm + n;
+    for (int shift = 0; shift < 64; shift += 8) {
+        int count[257] = { 0 };
+        for (int i = 0; i < n; i++) count[((src_keys[i] >> shift) & 0xFF) + 1]++;
+        if (count[((src_keys[0] >> shift) & 0xFF) + 1] == n) continue; // All the same, skip this byte.
+        for (int b = 0; b < 256; b++) count[b + 1] += count[b];
+        for (int i = 0; i < n; i++) {
+            const int dst = count[(src_keys[i] >> shift) & 0xFF]++;
+            dst_keys[dst] = src_keys[i];
+            dst_perm[dst] = src_perm[i];
+        }
+        uint64_t *tk = src_keys; src_keys = dst_keys; dst_keys = tk;
+        int *tp = src_perm; src_perm = dst_perm; dst_perm = tp;
+    }
+
+    int64_t *tmp = (int64_t *) dst_keys; // Finished with this half.
+    for (int i = 0; i < n; i++) tmp[i] = iarray[src_perm[i]];
+    memcpy(iarray, tmp, n * sizeof(int64_t));
+    sort_apply_index(src_perm, n, index, startpoint, tmp);
+
+    free(keys);
+    free(perm);
+}
+
+static int floatsort_compare(const void *ctx, int a, int b) {
+    const FloatSortContext *c = (const FloatSortContext *) ctx;
+    const MMFLOAT fa = c->farray[a];
+    const MMFLOAT fb = c->farray[b];
+    if (fa < fb) return -c->reverse;
+    if (fa > fb) return c->reverse;
+    return 0;
 }
 
 static void floatsort(MMFLOAT *farray, int n, int64_t *index, int flags,
                int startpoint) {
-    int i, j = n, s = 1;
-    int64_t t;
-    MMFLOAT f;
-    if ((flags & 1) == 0) {
-        while (s) {
-            s = 0;
-            for (i = 1; i < j; i++) {
-                if (farray[i] < farray[i - 1]) {
-                    f = farray[i];
-                    farray[i] = farray[i - 1];
-                    farray[i - 1] = f;
-                    s = 1;
-                    if (index != NULL) {
-                        t = index[i - 1 + startpoint];
-                        index[i - 1 + startpoint] = index[i + startpoint];
-                        index[i + startpoint] = t;
-                    }
-                }
-            }
-            j--;
-        }
+    if (n < 2) return;
+    int *perm = malloc(n * sizeof(int));
+    MMFLOAT *tmp = malloc(n * max(sizeof(MMFLOAT), sizeof(int64_t)));
+    if (!perm || !tmp) {
+        free(perm);
+        free(tmp);
+        ERROR_OUT_OF_MEMORY;
+    }
+
+    for (int i = 0; i < n; i++) perm[i] = i;
+    FloatSortContext ctx = { farray, 1 - ((flags & 1) << 1) };
+    sort_perm(perm, n, floatsort_compare, &ctx);
+
+    for (int i = 0; i < n; i++) tmp[i] = farray[perm[i]];
+    memcpy(farray, tmp, n * sizeof(MMFLOAT));
+    sort_apply_index(perm, n, index, startpoint, (int64_t *) tmp);
+
+    free(perm);
+    free(tmp);
+}
+
+static int stringsort_compare(const void *ctx, int a, int b) {
+    const StringSortContext *c = (const StringSortContext *) ctx;
+    const unsigned char *s1 = c->sarray + a * c->offset;
+    const unsigned char *s2 = c->sarray + b * c->offset;
+    const int len = *s1 < *s2 ? *s1 : *s2;  // get the smaller length
+    int k = 0;
+    if (c->case_insensitive) {
+        for (int i = 1; i <= len && k == 0; i++) k = toupper(s1[i]) - toupper(s2[i]);
     } else {
-        while (s) {
-            s = 0;
-            for (i = 1; i < j; i++) {
-                if (farray[i] > farray[i - 1]) {
-                    f = farray[i];
-                    farray[i] = farray[i - 1];
-                    farray[i - 1] = f;
-                    s = 1;
-                    if (index != NULL) {
-                        t = index[i - 1 + startpoint];
-                        index[i - 1 + startpoint] = index[i + startpoint];
-                        index[i + startpoint] = t;
-                    }
-                }
-            }
-            j--;
-        }
+        k = memcmp(s1 + 1, s2 + 1, len);
     }
+    // if up to this point the strings match
+    // make the decision based on which one is shorter
+    if (k == 0) k = *s1 - *s2;
+    return k < 0 ? -c->reverse : (k > 0 ? c->reverse : 0);
 }
 
 static void stringsort(unsigned char *sarray, int n, int offset, int64_t *index,
                        int flags, int startpoint) {
-    int ii, i, s = 1, isave;
-    int k;
-    unsigned char *s1, *s2, *p1, *p2;
-    unsigned char temp;
-    int reverse = 1 - ((flags & 1) << 1);
-    while (s) {
-        s = 0;
-        for (i = 1; i < n; i++) {
-            s2 = i * offset + sarray;
-            s1 = (i - 1) * offset + sarray;
-            ii = *s1 < *s2 ? *s1 : *s2;  // get the smaller  length
-            p1 = s1 + 1;
-            p2 = s2 + 1;
-            k = 0;  // assume the strings match
-            while ((ii--) && (k == 0)) {
-                if (flags & 2) {
-                    if (toupper(*p1) > toupper(*p2)) {
-                        k = reverse;  // earlier in the array is bigger
-                    }
-                    if (toupper(*p1) < toupper(*p2)) {
-                        k = -reverse;  // later in the array is bigger
-                    }
-                } else {
-                    if (*p1 > *p2) {
-                        k = reverse;  // earlier in the array is bigger
-                    }
-                    if (*p1 < *p2) {
-                        k = -reverse;  // later in the array is bigger
-                    }
-                }
-                p1++;
-                p2++;
-            }
-            // if up to this point the strings match
-            // make the decision based on which one is shorter
-            if (k == 0) {
-                if (*s1 > *s2) k = reverse;
-                if (*s1 < *s2) k = -reverse;
-            }
-            if (k == 1) {  // if earlier is bigger swap them round
-                ii = *s1 > *s2 ? *s1 : *s2;  // get the bigger length
-                ii++;
-                p1 = s1;
-                p2 = s2;
-                while (ii--) {
-                    temp = *p1;
-                    *p1 = *p2;
-                    *p2 = temp;
-                    p1++;
-                    p2++;
-                }
-                s = 1;
-                if (index != NULL) {
-                    isave = index[i - 1 + startpoint];
-                    index[i - 1 + startpoint] = index[i + startpoint];
-                    index[i + startpoint] = isave;
-                }
-            }
+    int i;
+    unsigned char *s2;
+
+    if (n >= 2) {
+        int *perm = malloc(n * sizeof(int));
+        unsigned char *tmp = malloc((size_t) n * max((size_t) offset, sizeof(int64_t)));
+        if (!perm || !tmp) {
+            free(perm);
+            free(tmp);
+            ERROR_OUT_OF_MEMORY;
         }
+
+        for (i = 0; i < n; i++) perm[i] = i;
+        StringSortContext ctx = { sarray, offset, 1 - ((flags & 1) << 1), flags & 2 };
+        sort_perm(perm, n, stringsort_compare, &ctx);
+
+        for (i = 0; i < n; i++) memcpy(tmp + i * offset, sarray + perm[i] * offset, offset);
+        memcpy(sarray, tmp, (size_t) n * offset);
+        sort_apply_index(perm, n, index, startpoint, (int64_t *) tmp);
+
+        free(perm);
+        free(tmp);
     }
 
     // Handle empty strings according to flag bit 2.
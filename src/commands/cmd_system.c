@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
 #include "../common/mmb4l.h"
+#include "../common/console.h"
 #include "../common/cstring.h"
 #include "../common/parse.h"
 #include "../common/utility.h"
@@ -191,6 +192,9 @@ void cmd_system_setenv(const char *p) {
  */
 static MmResult cmd_system_to_buf(char *cmd, char *buf, size_t *sz, int64_t *exit_status) {
 
+    // Our buffered output must precede anything the command writes.
+    console_flush();
+
     if (!buf) {
         // Special handling when we are not capturing the output.
         *exit_status = system(cmd);
@@ -37,6 +37,9 @@ void CheckAbort(void) { }
 // Defined in "commands/cmd_read.c"
 void cmd_read_clear_cache()  { }
 
+// Defined in "functions/fun_json.c"
+void fun_json_clear_cache()  { }
+
 // Defined in "commands/cmd_run.c"
 extern char cmd_run_args[STRINGSIZE];
 
@@ -45,7 +45,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "audio.h"
 
 #include <SDL.h>
-#include <assert.h>
 #include <dirent.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -76,6 +75,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MAX_TRACKS 100
 #define TONE_VOLUME 100
 
+/**
+ * Number of stereo frames SDL requests per callback and that
+ * audio_background_tasks() renders at a time; must be a power of 2.
+ */
+#if !defined(AUDIO_PERIOD_FRAMES)
+#define AUDIO_PERIOD_FRAMES 512
+#endif
+
+/** Capacity of the ring buffer between the renderer and the SDL callback. */
+#define AUDIO_RING_FRAMES (8 * AUDIO_PERIOD_FRAMES)
+
+/** The renderer stops topping up the ring buffer once it holds this many frames. */
+#define AUDIO_RING_TARGET_FRAMES (4 * AUDIO_PERIOD_FRAMES)
+
+#define AUDIO_FRAME_BYTES (2 * sizeof(float))
+
 #if 0
 #define LOCK_AUDIO(s)    printf("%s: lock audio\n", s); SDL_LockAudio()
 #define UNLOCK_AUDIO(s)  printf("%s: unlock audio\n", s); SDL_UnlockAudio()
@@ -165,10 +180,49 @@ static AudioBuffer *audio_effect_fill_buf = NULL;
 static AudioBuffer *audio_effect_play_buf = NULL;
 static uint64_t audio_effect_pos = 0;
 
+////////////////////////////////////////////////////////////////////////////////
+// Ring buffer of rendered stereo frames.
+//
+// Single producer (audio_background_tasks() on the main thread) and single
+// consumer (audio_callback() on the SDL audio thread). The read and write
+// positions are free-running frame counts, only the producer advances
+// 'audio_ring_write' and only the consumer advances 'audio_ring_read'; they
+// are only reset whilst holding the audio lock.
+////////////////////////////////////////////////////////////////////////////////
+static float audio_ring[AUDIO_RING_FRAMES * 2];
+static SDL_atomic_t audio_ring_read = {0};
+static SDL_atomic_t audio_ring_write = {0};
+static float audio_block[AUDIO_PERIOD_FRAMES * 2];
+
 static void audio_callback(void *userdata, Uint8 *stream, int len);
 
 static MmResult audio_play_next_track();
 
+/** Gets the number of rendered frames waiting to be consumed by the SDL callback. */
+static inline unsigned audio_ring_count() {
+    return (unsigned)SDL_AtomicGet(&audio_ring_write) - (unsigned)SDL_AtomicGet(&audio_ring_read);
+}
+
+/**
+ * Discards any rendered frames not yet consumed by the SDL callback.
+ *
+ * This should only be called whilst holding the audio lock.
+ */
+static void audio_ring_clear() {
+    SDL_AtomicSet(&audio_ring_read, 0);
+    SDL_AtomicSet(&audio_ring_write, 0);
+}
+
+/** Appends 'frames' stereo frames to the ring buffer; the caller guarantees there is space. */
+static void audio_ring_push(const float *src, unsigned frames) {
+    const unsigned write = (unsigned)SDL_AtomicGet(&audio_ring_write);
+    const unsigned start = write & (AUDIO_RING_FRAMES - 1);
+    const unsigned first = min(frames, AUDIO_RING_FRAMES - start);
+    memcpy(audio_ring + start * 2, src, first * AUDIO_FRAME_BYTES);
+    memcpy(audio_ring, src + first * 2, (frames - first) * AUDIO_FRAME_BYTES);
+    SDL_AtomicSet(&audio_ring_write, (int)(write + frames));
+}
+
 static void *audio_malloc(size_t sz, void *pUserData) { return GetMemory(sz); }
 
 static void *audio_realloc(void *p, size_t sz, void *pUserData) { return ReAllocMemory((p), (sz)); }
@@ -193,6 +247,8 @@ static drmp3_bool32 audio_on_seek(void *pUserData, int offset, drmp3_seek_origin
 /**
  * Configures the SDL Audio sample rate and number of channels.
  *
+ * Note that the ring buffer and render functions assume 'num_channels' == 2.
+ *
  * This should only be called whilst holding the audio lock on audio device 1.
  * If the sample rate or number of channels has changed then the lock will be
  * released on audio device 1, it will be closed, a new device 1 created in its
@@ -208,12 +264,13 @@ static MmResult audio_configure(int sample_rate, int num_channels) {
         UNLOCK_AUDIO("audio_configure"); // Release lock on the old audio.
 
         SDL_CloseAudio();
+        audio_ring_clear(); // Frames rendered for the old device.
 
         audio_current_spec = (SDL_AudioSpec){
             .format = AUDIO_F32,
             .channels = num_channels,
             .freq = sample_rate,
-            .samples = 1,  // TODO: Support a bigger sample buffer.
+            .samples = AUDIO_PERIOD_FRAMES,
             .callback = audio_callback,
         };
 
@@ -246,7 +303,7 @@ MmResult audio_init() {
             .format = AUDIO_F32,
             .channels = 2,
             .freq = AUDIO_SAMPLE_RATE,
-            .samples = 1,  // TODO: Support a bigger sample buffer.
+            .samples = AUDIO_PERIOD_FRAMES,
             .callback = audio_callback,
         };
 
@@ -392,6 +449,7 @@ MmResult audio_stop() {
     audio_free_buffers();
     audio_effect_free_buffers();
     audio_free_mod_buf();
+    audio_ring_clear();
     for (int snd = 0; snd < MAXSOUNDS; ++snd) {
         for (int channel = LEFT_CHANNEL; channel <= RIGHT_CHANNEL; ++channel) {
             audio_phase_m[channel][snd] = 0.0f;
@@ -418,152 +476,152 @@ MmResult audio_term() {
     return result;
 }
 
-static float audio_callback_tone(int channel) {
-    if (audio_tone_duration <= 0) {
-        return 0.0f;
-    } else {
-        audio_tone_duration--;
-        const int volume =
-            (sine_table[(int)audio_phase_ac[channel][0]] - 2000) * mapping[TONE_VOLUME] / 2000;
-        audio_phase_ac[channel][0] += audio_phase_m[channel][0];
-        if (audio_phase_ac[channel][0] >= 4096.0) audio_phase_ac[channel][0] -= 4096.0;
-        return (float)volume / 2000.0f;
+static void audio_render_tone(float *out, unsigned frames) {
+    for (unsigned i = 0; i < frames; ++i, out += 2) {
+        for (int channel = LEFT_CHANNEL; channel <= RIGHT_CHANNEL; ++channel) {
+            if (audio_tone_duration <= 0) {
+                out[channel] = 0.0f;
+            } else {
+                audio_tone_duration--;
+                const int volume =
+                    (sine_table[(int)audio_phase_ac[channel][0]] - 2000) * mapping[TONE_VOLUME] / 2000;
+                audio_phase_ac[channel][0] += audio_phase_m[channel][0];
+                if (audio_phase_ac[channel][0] >= 4096.0) audio_phase_ac[channel][0] -= 4096.0;
+                out[channel] = (float)volume / 2000.0f;
+            }
+        }
     }
 }
 
-static float audio_callback_mod(int channel) {
-    if (audio_play_buf->byte_count == 0) return 0.0f;
+// Mixes the effect WAV into a block of the main MOD track.
+static void audio_render_effect(float *out, unsigned frames) {
+    const bool mono = audio_effect_struct.channels == 1;
+    for (unsigned i = 0; i < frames; ++i, out += 2) {
+        if (audio_effect_play_buf->byte_count == 0) return;
+        const float *buf = (const float *)audio_effect_play_buf->data;
 
-    float value = 0.0f;
-    // Main MOD trac.
-    {
-        int16_t *buf = (int16_t *)audio_play_buf->data;
+        out[LEFT_CHANNEL] += buf[audio_effect_pos] * audio_filter_volume[LEFT_CHANNEL];
+        if (!mono) audio_effect_pos++;
+        out[RIGHT_CHANNEL] += buf[audio_effect_pos++] * audio_filter_volume[RIGHT_CHANNEL];
+
+        if (audio_effect_pos >= audio_effect_play_buf->byte_count) {
+            audio_effect_play_buf->byte_count = 0;
+            SWAP(AudioBuffer *, audio_effect_fill_buf, audio_effect_play_buf);
+            audio_effect_pos = 0;
+        }
+    }
+}
 
-        if (audio_pos < audio_play_buf->byte_count) {
-            value = (float)buf[audio_pos++] / 32768.0f * audio_filter_volume[channel];
+static void audio_render_mod(float *out, unsigned frames) {
+    float *start = out;
+    for (unsigned i = 0; i < frames; ++i, out += 2) {
+        if (audio_play_buf->byte_count == 0) {
+            out[LEFT_CHANNEL] = 0.0f;
+            out[RIGHT_CHANNEL] = 0.0f;
+            continue;
         }
+        const int16_t *buf = (const int16_t *)audio_play_buf->data;
 
-        if (audio_pos == audio_play_buf->byte_count) {
+        out[LEFT_CHANNEL] = (float)buf[audio_pos++] / 32768.0f * audio_filter_volume[LEFT_CHANNEL];
+        out[RIGHT_CHANNEL] = (float)buf[audio_pos++] / 32768.0f * audio_filter_volume[RIGHT_CHANNEL];
+
+        if (audio_pos >= audio_play_buf->byte_count) {
             audio_play_buf->byte_count = 0;
             SWAP(AudioBuffer *, audio_fill_buf, audio_play_buf);
             audio_pos = 0;
         }
     }
 
-    float effect_value = 0.0f;
-    // Effect WAV trac.
-    if (audio_effect_state == P_WAV && audio_effect_play_buf->byte_count > 0) {
-        float *buf = (float *)audio_effect_play_buf->data;
-
-        if (audio_effect_pos < audio_effect_play_buf->byte_count) {
-            effect_value = buf[audio_effect_pos++] * audio_filter_volume[channel];
-            if (audio_effect_state == P_WAV && channel == LEFT_CHANNEL &&
-                audio_effect_struct.channels == 1) {
-                // Handle mono WAV playback.
-                audio_effect_pos--;
-            }
-        }
+    if (audio_effect_state == P_WAV) audio_render_effect(start, frames);
+}
 
-        if (audio_effect_pos == audio_effect_play_buf->byte_count) {
-            audio_effect_play_buf->byte_count = 0;
-            SWAP(AudioBuffer *, audio_effect_fill_buf, audio_effect_play_buf);
-            audio_effect_pos = 0;
-        }
+static unsigned audio_track_channels() {
+    switch (audio_state) {
+        case P_FLAC:
+            return audio_flac_struct->channels;
+        case P_MP3:
+            return audio_mp3_struct.channels;
+        case P_WAV:
+            return audio_wav_struct.channels;
+        default:
+            return 2;
     }
-
-    return value + effect_value;
 }
 
-// Callback for FLAC, MP3 and WAV files.
-static float audio_callback_track(int channel) {
-    if (audio_play_buf->byte_count == 0) return 0.0f;
-
-    float value = 0.0f;
-    float *buf = (float *)audio_play_buf->data;
-
-    if (audio_pos < audio_play_buf->byte_count) {
-        value = buf[audio_pos++] * audio_filter_volume[channel];
-        if (channel == LEFT_CHANNEL) {
-            // Handle mono playback.
-            switch (audio_state) {
-                case P_FLAC:
-                    if (audio_flac_struct->channels == 1) audio_pos--;
-                    break;
-                case P_MP3:
-                    if (audio_mp3_struct.channels == 1) audio_pos--;
-                    break;
-                case P_WAV:
-                    if (audio_wav_struct.channels == 1) audio_pos--;
-                    break;
-                default:
-                    break;
-            }
+// Renders FLAC, MP3 and WAV files.
+static void audio_render_track(float *out, unsigned frames) {
+    const bool mono = audio_track_channels() == 1;
+    for (unsigned i = 0; i < frames; ++i, out += 2) {
+        if (audio_play_buf->byte_count == 0) {
+            out[LEFT_CHANNEL] = 0.0f;
+            out[RIGHT_CHANNEL] = 0.0f;
+            continue;
         }
-    }
+        const float *buf = (const float *)audio_play_buf->data;
 
-    if (audio_pos == audio_play_buf->byte_count) {
-        audio_play_buf->byte_count = 0;
-        SWAP(AudioBuffer *, audio_fill_buf, audio_play_buf);
-        audio_pos = 0;
-    }
+        out[LEFT_CHANNEL] = buf[audio_pos] * audio_filter_volume[LEFT_CHANNEL];
+        if (!mono) audio_pos++;
+        out[RIGHT_CHANNEL] = buf[audio_pos++] * audio_filter_volume[RIGHT_CHANNEL];
 
-    return value;
+        if (audio_pos >= audio_play_buf->byte_count) {
+            audio_play_buf->byte_count = 0;
+            SWAP(AudioBuffer *, audio_fill_buf, audio_play_buf);
+            audio_pos = 0;
+        }
+    }
 }
 
-static float audio_callback_sound(int channel) {
+static void audio_render_sound(float *out, unsigned frames) {
     static int noisedwell[2][MAXSOUNDS] = {0};
     static uint32_t noise[2][MAXSOUNDS] = {0};
 
-    int volume = 0;
-    int delta;
+    for (unsigned f = 0; f < frames; ++f, out += 2) {
+        for (int channel = LEFT_CHANNEL; channel <= RIGHT_CHANNEL; ++channel) {
+            int volume = 0;
+            int delta;
 
-    for (int i = 0; i < MAXSOUNDS; ++i) {
-        if (audio_sound[channel][i] == null_table) continue;
+            for (int i = 0; i < MAXSOUNDS; ++i) {
+                if (audio_sound[channel][i] == null_table) continue;
 
-        if (audio_sound[channel][i] != white_noise_table) {
-            delta = audio_sound[channel][i][(int)audio_phase_ac[channel][i]];
-            audio_phase_ac[channel][i] += audio_phase_m[channel][i];
-            if (audio_phase_ac[channel][i] >= 4096.0) audio_phase_ac[channel][i] -= 4096.0;
-        } else {
-            if (noisedwell[channel][i] <= 0) {
-                noisedwell[channel][i] = (int)audio_phase_m[channel][i];
-                noise[channel][i] = rand() % 3700 + 100;
+                if (audio_sound[channel][i] != white_noise_table) {
+                    delta = audio_sound[channel][i][(int)audio_phase_ac[channel][i]];
+                    audio_phase_ac[channel][i] += audio_phase_m[channel][i];
+                    if (audio_phase_ac[channel][i] >= 4096.0) audio_phase_ac[channel][i] -= 4096.0;
+                } else {
+                    if (noisedwell[channel][i] <= 0) {
+                        noisedwell[channel][i] = (int)audio_phase_m[channel][i];
+                        noise[channel][i] = rand() % 3700 + 100;
+                    }
+                    if (noisedwell[channel][i]) noisedwell[channel][i]--;
+                    delta = noise[channel][i];
+                }
+                delta = (delta - 2000) * mapping[audio_sound_volume[channel][i]] / 2000;
+                volume += delta;
             }
-            if (noisedwell[channel][i]) noisedwell[channel][i]--;
-            delta = noise[channel][i];
+
+            out[channel] = (float)volume / 2000.0f;
         }
-        delta = (delta - 2000) * mapping[audio_sound_volume[channel][i]] / 2000;
-        volume += delta;
     }
-
-    return (float)volume / 2000.0f;
 }
 
-// For the moment 'len' is expected to always be 8 bytes (2 samples) for stereo.
+/**
+ * Consumes frames from the ring buffer, if the ring buffer runs dry then the
+ * remainder of the stream is filled with silence.
+ */
 static void audio_callback(void *userdata, Uint8 *stream, int len) {
-    assert(len == 8);
-    float *fstream = (float *)stream;
-    for (int i = 0; i < 2; ++i) {
-        switch (audio_state) {
-            case P_TONE:
-                fstream[i] = audio_callback_tone(i);
-                break;
-            case P_MOD:
-                fstream[i] = audio_callback_mod(i);
-                break;
-            case P_MP3:
-            case P_WAV:
-            case P_FLAC:
-                fstream[i] = audio_callback_track(i);
-                break;
-            case P_SOUND:
-                fstream[i] = audio_callback_sound(i);
-                break;
-            default:
-                fstream[i] = 0.0f;
-                break;
-        }
-    }
+    float *out = (float *)stream;
+    const unsigned frames = (unsigned)len / AUDIO_FRAME_BYTES;
+    const unsigned read = (unsigned)SDL_AtomicGet(&audio_ring_read);
+    const unsigned available = (unsigned)SDL_AtomicGet(&audio_ring_write) - read;
+    const unsigned count = min(frames, available);
+
+    const unsigned start = read & (AUDIO_RING_FRAMES - 1);
+    const unsigned first = min(count, AUDIO_RING_FRAMES - start);
+    memcpy(out, audio_ring + start * 2, first * AUDIO_FRAME_BYTES);
+    memcpy(out + first * 2, audio_ring, (count - first) * AUDIO_FRAME_BYTES);
+    SDL_AtomicSet(&audio_ring_read, (int)(read + count));
+
+    if (count < frames) memset(out + count * 2, 0, (frames - count) * AUDIO_FRAME_BYTES);
 }
 
 static inline bool audio_is_last_track() {
@@ -588,6 +646,7 @@ MmResult audio_play_next() {
             if (audio_is_last_track()) {
                 console_puts("Last track is playing\r\n");
             } else {
+                audio_ring_clear();
                 result = audio_play_next_track();
             }
             break;
@@ -633,6 +692,8 @@ MmResult audio_pause() {
             break;
     }
 
+    if (SUCCEEDED(result)) audio_ring_clear();
+
     UNLOCK_AUDIO("audio_pause");
     return result;
 }
@@ -660,6 +721,7 @@ MmResult audio_play_previous() {
                 console_puts("First track is playing\r\n");
             } else {
                 audio_track_current -= 2;
+                audio_ring_clear();
                 result = audio_play_next_track();
             }
             break;
@@ -1179,31 +1241,9 @@ MmResult audio_play_wav(const char *filename, const char *interrupt) {
     return audio_play_file(filename, ".WAV", interrupt);
 }
 
-MmResult audio_background_tasks() {
-    if (!audio_initialised) return kOk;
-
-    SDL_LockAudio();
-
-    switch (audio_state) {
-        case P_FLAC:
-        case P_MOD:
-        case P_MP3:
-        case P_WAV:
-            break;
-        case P_TONE:
-            if (audio_tone_duration <= 0) {
-                interrupt_fire(kInterruptAudio1);
-                (void) audio_stop();
-            }
-            SDL_UnlockAudio();
-            return kOk;
-        default:
-            // Nothing to do.
-            SDL_UnlockAudio();
-            return kOk;
-    }
-
-    // Fill the main trac buffer empty.
+/** Decodes into the main track and effect fill buffers if they are empty. */
+static void audio_fill_buffers() {
+    // Fill the main track buffer if empty.
     if (audio_fill_buf->byte_count == 0) {
         char *buf = audio_fill_buf->data;
         switch (audio_state) {
@@ -1250,23 +1290,87 @@ MmResult audio_background_tasks() {
 
     // Fill the effect buffer if empty.
     if (audio_effect_state == P_WAV && audio_effect_fill_buf->byte_count == 0) {
-        char *buf = audio_effect_fill_buf->data;
-        switch (audio_effect_state) {
-            case P_WAV: {
-                audio_effect_fill_buf->byte_count =
-                    drwav_read_pcm_frames_f32(&audio_effect_struct, WAV_BUFFER_SIZE / 2,
-                                              (float *)buf) *
-                    audio_effect_struct.channels;
-                break;
+        audio_effect_fill_buf->byte_count =
+            drwav_read_pcm_frames_f32(&audio_effect_struct, WAV_BUFFER_SIZE / 2,
+                                      (float *)audio_effect_fill_buf->data) *
+            audio_effect_struct.channels;
+    }
+}
+
+static inline bool audio_track_finished() {
+    return audio_fill_buf->byte_count == 0 && audio_play_buf->byte_count == 0;
+}
+
+/**
+ * Renders the next AUDIO_PERIOD_FRAMES frames of the current source.
+ *
+ * @return  false if there is nothing to render because nothing is playing,
+ *          playback is paused or the current source is exhausted.
+ */
+static bool audio_render_block(float *block) {
+    switch (audio_state) {
+        case P_TONE:
+            if (audio_tone_duration <= 0) return false;
+            audio_render_tone(block, AUDIO_PERIOD_FRAMES);
+            return true;
+        case P_SOUND:
+            audio_render_sound(block, AUDIO_PERIOD_FRAMES);
+            return true;
+        case P_MOD:
+            audio_fill_buffers();
+            if (audio_track_finished()) return false;
+            audio_render_mod(block, AUDIO_PERIOD_FRAMES);
+            return true;
+        case P_FLAC:
+        case P_MP3:
+        case P_WAV:
+            audio_fill_buffers();
+            if (audio_track_finished()) return false;
+            audio_render_track(block, AUDIO_PERIOD_FRAMES);
+            return true;
+        default:
+            return false;
+    }
+}
+
+MmResult audio_background_tasks() {
+    if (!audio_initialised) return kOk;
+
+    // Top up the ring buffer; this does not need the audio lock.
+    while (audio_ring_count() + AUDIO_PERIOD_FRAMES <= AUDIO_RING_TARGET_FRAMES
+           && audio_render_block(audio_block)) {
+        audio_ring_push(audio_block, AUDIO_PERIOD_FRAMES);
+    }
+
+    switch (audio_state) {
+        case P_FLAC:
+        case P_MOD:
+        case P_MP3:
+        case P_WAV:
+            break;
+        case P_TONE:
+            // Wait for the SDL callback to consume the end of the tone.
+            if (audio_tone_duration <= 0 && audio_ring_count() == 0) {
+                interrupt_fire(kInterruptAudio1);
+                (void) audio_stop();
             }
+            return kOk;
+        default:
+            // Nothing to do.
+            return kOk;
+    }
 
-            default:
-                break;
-        }
+    // Check if WAV effect playback has finished.
+    if (audio_effect_state == P_WAV && audio_effect_fill_buf->byte_count == 0 &&
+        audio_effect_play_buf->byte_count == 0) {
+        (void)audio_stop_effect();
+        interrupt_fire(kInterruptAudio2);
     }
 
-    // Check if FLAC, MOD, MP3 or WAV playback has finished.
-    if (audio_fill_buf->byte_count == 0 && audio_play_buf->byte_count == 0) {
+    // Check if FLAC, MOD, MP3 or WAV playback has finished; the next track is
+    // started immediately, but the last track must be consumed by the SDL
+    // callback before playback stops.
+    if (audio_track_finished() && (!audio_is_last_track() || audio_ring_count() == 0)) {
         switch (audio_state) {
             case P_FLAC:
                 (void)drflac_close(audio_flac_struct);
@@ -1282,22 +1386,15 @@ MmResult audio_background_tasks() {
                 break;
         }
 
+        LOCK_AUDIO("audio_background_tasks");
         MmResult result = audio_play_next_track();
         if (FAILED(result)) {
             audio_stop();
             interrupt_fire(kInterruptAudio1);
         }
+        UNLOCK_AUDIO("audio_background_tasks");
     }
 
-    // Check if WAV effect playback has finished.
-    if (audio_effect_state == P_WAV && audio_effect_fill_buf->byte_count == 0 &&
-        audio_effect_play_buf->byte_count == 0) {
-        (void)audio_stop_effect();
-        interrupt_fire(kInterruptAudio2);
-    }
-
-    SDL_UnlockAudio();
-
     return kOk;
 }
 
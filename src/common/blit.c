@@ -0,0 +1,283 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+blit.c
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "blit.h"
+
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BLIT_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define BLIT_NEON
+#include <arm_neon.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar kernels, also used for the tails of the SIMD kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+static void blit_copy_transparent_scalar(uint32_t *dst, const uint32_t *src, int n,
+                                         uint32_t transparent) {
+    for (int i = 0; i < n; ++i) {
+        if (src[i] != transparent) dst[i] = src[i];
+    }
+}
+
+static void blit_reverse_scalar(uint32_t *dst, const uint32_t *src, int n) {
+    for (int i = 0; i < n; ++i) dst[n - 1 - i] = src[i];
+}
+
+static void blit_reverse_transparent_scalar(uint32_t *dst, const uint32_t *src, int n,
+                                            uint32_t transparent) {
+    for (int i = 0; i < n; ++i) {
+        if (src[i] != transparent) dst[n - 1 - i] = src[i];
+    }
+}
+
+static const BlitKernels blit_kernels_scalar = {
+    "scalar",
+    blit_copy_transparent_scalar,
+    blit_reverse_scalar,
+    blit_reverse_transparent_scalar,
+};
+
+#if defined(BLIT_X86)
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels, 4 pixels at a time.
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("sse2")))
+static inline __m128i blit_select_sse2(__m128i s, __m128i d, __m128i t) {
+    const __m128i mask = _mm_cmpeq_epi32(s, t);
+    return _mm_or_si128(_mm_and_si128(mask, d), _mm_andnot_si128(mask, s));
+}
+
+__attribute__((target("sse2")))
+static void blit_copy_transparent_sse2(uint32_t *dst, const uint32_t *src, int n,
+                                       uint32_t transparent) {
+    const __m128i t = _mm_set1_epi32((int)transparent);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), blit_select_sse2(s, d, t));
+    }
+    blit_copy_transparent_scalar(dst + i, src + i, n - i, transparent);
+}
+
+__attribute__((target("sse2")))
+static void blit_reverse_sse2(uint32_t *dst, const uint32_t *src, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + n - i - 4), _mm_shuffle_epi32(s, 0x1B));
+    }
+    blit_reverse_scalar(dst, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void blit_reverse_transparent_sse2(uint32_t *dst, const uint32_t *src, int n,
+                                          uint32_t transparent) {
+    const __m128i t = _mm_set1_epi32((int)transparent);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(src + i)), 0x1B);
+        const __m128i d = _mm_loadu_si128((const __m128i *)(dst + n - i - 4));
+        _mm_storeu_si128((__m128i *)(dst + n - i - 4), blit_select_sse2(s, d, t));
+    }
+    blit_reverse_transparent_scalar(dst, src + i, n - i, transparent);
+}
+
+static const BlitKernels blit_kernels_sse2 = {
+    "sse2",
+    blit_copy_transparent_sse2,
+    blit_reverse_sse2,
+    blit_reverse_transparent_sse2,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels, 8 pixels at a time.
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx2")))
+static inline __m256i blit_reverse_avx2_lanes(__m256i s) {
+    return _mm256_permutevar8x32_epi32(s, _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Note that _mm256_blendv_epi8() is not used because GCC miscompiles it when
+// building with -funsigned-char.
+__attribute__((target("avx2")))
+static inline __m256i blit_select_avx2(__m256i s, __m256i d, __m256i t) {
+    const __m256i mask = _mm256_cmpeq_epi32(s, t);
+    return _mm256_or_si256(_mm256_and_si256(mask, d), _mm256_andnot_si256(mask, s));
+}
+
+__attribute__((target("avx2")))
+static void blit_copy_transparent_avx2(uint32_t *dst, const uint32_t *src, int n,
+                                       uint32_t transparent) {
+    const __m256i t = _mm256_set1_epi32((int)transparent);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), blit_select_avx2(s, d, t));
+    }
+    blit_copy_transparent_scalar(dst + i, src + i, n - i, transparent);
+}
+
+__attribute__((target("avx2")))
+static void blit_reverse_avx2(uint32_t *dst, const uint32_t *src, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + n - i - 8), blit_reverse_avx2_lanes(s));
+    }
+    blit_reverse_scalar(dst, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void blit_reverse_transparent_avx2(uint32_t *dst, const uint32_t *src, int n,
+                                          uint32_t transparent) {
+    const __m256i t = _mm256_set1_epi32((int)transparent);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i s =
+            blit_reverse_avx2_lanes(_mm256_loadu_si256((const __m256i *)(src + i)));
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + n - i - 8));
+        _mm256_storeu_si256((__m256i *)(dst + n - i - 8), blit_select_avx2(s, d, t));
+    }
+    blit_reverse_transparent_scalar(dst, src + i, n - i, transparent);
+}
+
+static const BlitKernels blit_kernels_avx2 = {
+    "avx2",
+    blit_copy_transparent_avx2,
+    blit_reverse_avx2,
+    blit_reverse_transparent_avx2,
+};
+
+#endif // #if defined(BLIT_X86)
+
+#if defined(BLIT_NEON)
+
+////////////////////////////////////////////////////////////////////////////////
+// NEON kernels, 4 pixels at a time.
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32x4_t blit_reverse_neon_lanes(uint32x4_t s) {
+    const uint32x4_t r = vrev64q_u32(s);
+    return vcombine_u32(vget_high_u32(r), vget_low_u32(r));
+}
+
+static void blit_copy_transparent_neon(uint32_t *dst, const uint32_t *src, int n,
+                                       uint32_t transparent) {
+    const uint32x4_t t = vdupq_n_u32(transparent);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint32x4_t s = vld1q_u32(src + i);
+        const uint32x4_t d = vld1q_u32(dst + i);
+        vst1q_u32(dst + i, vbslq_u32(vceqq_u32(s, t), d, s));
+    }
+    blit_copy_transparent_scalar(dst + i, src + i, n - i, transparent);
+}
+
+static void blit_reverse_neon(uint32_t *dst, const uint32_t *src, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_u32(dst + n - i - 4, blit_reverse_neon_lanes(vld1q_u32(src + i)));
+    }
+    blit_reverse_scalar(dst, src + i, n - i);
+}
+
+static void blit_reverse_transparent_neon(uint32_t *dst, const uint32_t *src, int n,
+                                          uint32_t transparent) {
+    const uint32x4_t t = vdupq_n_u32(transparent);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint32x4_t s = blit_reverse_neon_lanes(vld1q_u32(src + i));
+        const uint32x4_t d = vld1q_u32(dst + n - i - 4);
+        vst1q_u32(dst + n - i - 4, vbslq_u32(vceqq_u32(s, t), d, s));
+    }
+    blit_reverse_transparent_scalar(dst, src + i, n - i, transparent);
+}
+
+static const BlitKernels blit_kernels_neon = {
+    "neon",
+    blit_copy_transparent_neon,
+    blit_reverse_neon,
+    blit_reverse_transparent_neon,
+};
+
+#endif // #if defined(BLIT_NEON)
+
+const BlitKernels *blit_kernels_for(BlitIsa isa) {
+    switch (isa) {
+        case kBlitIsaScalar:
+            return &blit_kernels_scalar;
+#if defined(BLIT_X86)
+        case kBlitIsaSse2:
+            return __builtin_cpu_supports("sse2") ? &blit_kernels_sse2 : NULL;
+        case kBlitIsaAvx2:
+            return __builtin_cpu_supports("avx2") ? &blit_kernels_avx2 : NULL;
+#endif
+#if defined(BLIT_NEON)
+        case kBlitIsaNeon:
+            return &blit_kernels_neon;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+const BlitKernels *blit_kernels() {
+    static const BlitKernels *selected = NULL;
+    if (!selected) {
+        for (int isa = kBlitIsaCount - 1; isa >= kBlitIsaScalar && !selected; --isa) {
+            selected = blit_kernels_for((BlitIsa)isa);
+        }
+    }
+    return selected;
+}
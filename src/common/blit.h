@@ -0,0 +1,89 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+blit.h
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#if !defined(MMB4L_BLIT_H)
+#define MMB4L_BLIT_H
+
+#include <stdint.h>
+
+/** Instruction sets with a set of blit row kernels. */
+typedef enum {
+    kBlitIsaScalar,
+    kBlitIsaSse2,
+    kBlitIsaAvx2,
+    kBlitIsaNeon,
+    kBlitIsaCount
+} BlitIsa;
+
+/**
+ * Kernels for copying a single row of 32-bit pixels.
+ *
+ * In every case 'dst' and 'src' point at the leftmost pixel of their row and
+ * must not overlap.
+ */
+typedef struct {
+    const char *name;
+
+    /** Copies 'n' pixels except those equal to 'transparent'. */
+    void (*copy_transparent)(uint32_t *dst, const uint32_t *src, int n, uint32_t transparent);
+
+    /** Copies 'n' pixels in reverse order, i.e. dst[n - 1 - i] = src[i]. */
+    void (*reverse)(uint32_t *dst, const uint32_t *src, int n);
+
+    /** Copies 'n' pixels in reverse order except those equal to 'transparent'. */
+    void (*reverse_transparent)(uint32_t *dst, const uint32_t *src, int n, uint32_t transparent);
+} BlitKernels;
+
+/**
+ * Gets the kernels for a given instruction set.
+ *
+ * @return  NULL if the kernels were not compiled in or the CPU does not
+ *          support the instruction set.
+ */
+const BlitKernels *blit_kernels_for(BlitIsa isa);
+
+/** Gets the fastest kernels supported by the CPU. */
+const BlitKernels *blit_kernels();
+
+#endif // #if !defined(MMB4L_BLIT_H)
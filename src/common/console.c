@@ -44,9 +44,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assert.h>
 #include <ctype.h>
+#include <stdarg.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdio_ext.h>
+#include <string.h>
 #include <termios.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -60,14 +63,25 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "rx_buf.h"
 
 #define CONSOLE_RX_BUF_SIZE 256
+#define CONSOLE_TX_BUF_SIZE (16 * 1024)
+
+/** UTF-8 expansion of a character > 127 for the current OPTION CODEPAGE. */
+typedef struct {
+    char bytes[4];
+    size_t len;
+} CodepageEntry;
 
 static struct termios orig_termios;
 static char console_rx_buf_data[CONSOLE_RX_BUF_SIZE];
 static RxBuf console_rx_buf;
 static bool console_no_title = false;
+static const char *console_codepage = NULL;  // Codepage that the table was built for.
+static CodepageEntry console_codepage_table[128];
 
 int ListCnt = 0;
 int MMCharPos = 0;
+uint64_t console_tx_bytes = 0;
+uint64_t console_tx_flushes = 0;
 
 void console_init(bool no_title) {
     rx_buf_init(
@@ -75,22 +89,40 @@ void console_init(bool no_title) {
             console_rx_buf_data,
             sizeof(console_rx_buf_data));
     console_no_title = no_title;
+
+    // Output is fully buffered and only written to the terminal by
+    // console_flush(), or if the buffer fills.
+    (void) setvbuf(stdout, NULL, _IOFBF, CONSOLE_TX_BUF_SIZE);
 }
 
-void console_bell(void) {
-    printf("\07");
+/** Writes a formatted string to the console buffer without flushing it. */
+__attribute__((format(printf, 1, 2)))
+static void console_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int count = vprintf(format, args);
+    va_end(args);
+    if (count > 0) console_tx_bytes += count;
+}
+
+void console_flush(void) {
+    if (__fpending(stdout) == 0) return;
     fflush(stdout);
+    console_tx_flushes++;
+}
+
+void console_bell(void) {
+    console_printf("\07");
 }
 
 void console_clear(void) {
-    printf("\033[2J");      // Clear screen.
-    console_home_cursor();  // Which will also call fflush().
+    console_printf("\033[2J");  // Clear screen.
+    console_home_cursor();
 }
 
 void console_cursor_up(int i) {
     assert(i > 0);
-    printf("\033[%dA", i);
-    fflush(stdout);
+    console_printf("\033[%dA", i);
 }
 
 void console_disable_raw_mode(void) {
@@ -109,25 +141,18 @@ void console_enable_raw_mode(void) {
     //fcntl(STDIN_FILENO, F_SETFL, fcntl(0, F_GETFL) | O_NONBLOCK);
 }
 
-void console_pump_input(void) {
-    char ch;
+int console_pump_input(void) {
+    char tmp[64];
     errno = 0;
-    ssize_t result = read(STDIN_FILENO, &ch, 1);
-    switch (result) {
-        case -1:
-            error_throw(errno);
-        case 0:
-            return;
-        case 1:
-            // Read one character, drop out of the switch.
-            // printf("<%d>", (int) ch);
-            break;
-        default:
-            assert(false);
-            break;
-    }
+    ssize_t count = read(STDIN_FILENO, tmp, sizeof(tmp));
+    if (count == -1) error_throw(errno);
 
-    console_put_keypress(ch);
+    for (ssize_t i = 0; i < count; ++i) {
+        console_put_keypress(tmp[i]);
+        // Anything following the break key would be discarded anyway.
+        if (MMAbort) break;
+    }
+    return (int) count;
 }
 
 void console_put_keypress(char ch) {
@@ -202,7 +227,12 @@ void console_ungetc(char ch) {
 int console_match_chars(char *pattern) {
     if (*pattern == '\0') return 1;
 
-    if (rx_buf_size(&console_rx_buf) == 0) CheckAbort(); // Which calls console_pump_input();
+    if (rx_buf_size(&console_rx_buf) == 0) {
+        // Pump directly because CheckAbort() only pumps the console when the
+        // background task is due.
+        console_pump_input();
+        CheckAbort();
+    }
 
     int ch = rx_buf_get(&console_rx_buf);
     if (ch == -1) {
@@ -242,7 +272,10 @@ static char ESCAPE_MAP[] = {
 
 int console_getc(void) {
 
-    CheckAbort(); // Which calls console_pump_input();
+    // Make sure any prompt is visible before checking for the response.
+    console_flush();
+    console_pump_input();
+    CheckAbort();
     int ch = rx_buf_get(&console_rx_buf);
 
     switch (ch) {
@@ -273,51 +306,75 @@ int console_getc(void) {
     return ch;
 }
 
-static char console_putc_noflush(char c) {
-    if (mmb_options.codepage && c > 127) {
-        const char *ptr = mmb_options.codepage + 4 * (c - 128);
-        putc(*ptr++, stdout);           // 1st byte.
-        if (ptr) putc(*ptr++, stdout);  // Optional 2nd byte.
-        if (ptr) putc(*ptr++, stdout);  // Optional 3rd byte.
-        if (ptr) putc(*ptr++, stdout);  // Optional 4th byte.
+/** Builds the table of UTF-8 expansions for the current OPTION CODEPAGE. */
+static void console_build_codepage_table(void) {
+    console_codepage = mmb_options.codepage;
+    if (!console_codepage) return;
+    for (size_t i = 0; i < 128; ++i) {
+        CodepageEntry *entry = &console_codepage_table[i];
+        memcpy(entry->bytes, console_codepage + 4 * i, 4);
+        // The 1st byte is always used, the other 3 are optional.
+        entry->len = 1;
+        while (entry->len < 4 && entry->bytes[entry->len]) entry->len++;
+    }
+}
+
+/** Updates MMCharPos and ListCnt for a character written to the console. */
+static inline void console_track_position(char c) {
+    if (isprint(c)) {
         MMCharPos++;
     } else {
-        putc(c, stdout);
-        if (isprint(c))
+        switch (c) {
+            case '\b':
+                MMCharPos--;
+                break;
+            case '\r':
+            case '\n':
+                MMCharPos = 1;
+                ListCnt++;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+size_t console_write(const char *buf, size_t sz) {
+    if (mmb_options.codepage != console_codepage) console_build_codepage_table();
+
+    // Runs of characters that need no expansion are written in one call.
+    const char *run = buf;
+    const char *end = buf + sz;
+    for (const char *p = buf; p < end; ++p) {
+        const unsigned char c = (unsigned char) *p;
+        if (console_codepage && c > 127) {
+            if (p > run) fwrite(run, 1, p - run, stdout);
+            const CodepageEntry *entry = &console_codepage_table[c - 128];
+            fwrite(entry->bytes, 1, entry->len, stdout);
+            console_tx_bytes += entry->len;
             MMCharPos++;
-        else {
-            switch (c) {
-                case '\b':
-                    MMCharPos--;
-                    break;
-                case '\r':
-                case '\n':
-                    MMCharPos = 1;
-                    ListCnt++;
-                    break;
-                default:
-                    break;
-            }
+            run = p + 1;
+        } else {
+            console_tx_bytes++;
+            console_track_position(c);
         }
     }
-    return c;
+    if (end > run) fwrite(run, 1, end - run, stdout);
+    return sz;
 }
 
 char console_putc(char c) {
-    char rval = console_putc_noflush(c);
-    fflush(stdout);
-    return rval;
+    (void) console_write(&c, 1);
+    return c;
 }
 
 void console_puts(const char *s) {
-    while (*s) (void) console_putc_noflush(*s++);
-    fflush(stdout);
+    (void) console_write(s, strlen(s));
 }
 
 void console_set_title(const char *title, bool command) {
     if (!command && console_no_title) return;
-    printf("\x1b]0;%s\x7", title);
-    fflush(stdout);
+    console_printf("\x1b]0;%s\x7", title);
 }
 
 enum ReadCursorPositionState {
@@ -332,8 +389,8 @@ int console_get_cursor_pos(int *x, int *y, int timeout_ms) {
     rx_buf_clear(&console_rx_buf);
 
     // Send escape code to report cursor position.
-    printf("\033[6n");
-    fflush(stdout);
+    console_printf("\033[6n");
+    console_flush();
 
     // Read characters one at a time to match the expected pattern ESC[n;mR
     // - fails if the pattern has not been matched within the timeout.
@@ -419,18 +476,16 @@ int console_get_size(int *width, int *height, int timeout_ms) {
 }
 
 void console_home_cursor(void) {
-    printf("\x1b[H");
-    fflush(stdout);
+    console_printf("\x1b[H");
 }
 
 void console_set_cursor_pos(int x, int y) {
-    printf("\033[%d;%dH", y + 1, x + 1); // VT100 origin is (1,1) not (0,0).
-    fflush(stdout);
+    console_printf("\033[%d;%dH", y + 1, x + 1); // VT100 origin is (1,1) not (0,0).
 }
 
 int console_set_size(int width, int height) {
-    printf("\033[8;%d;%dt", height, width);
-    fflush(stdout);
+    console_printf("\033[8;%d;%dt", height, width);
+    console_flush();
 
     // Wait 250ms for the change to take effect.
     // Note that if the requested height and width are not possible (e.g. too big)
@@ -451,35 +506,22 @@ const int ANSI_COLOURS[] = { 0, 4, 2, 6, 1, 5, 3, 7, 10, 14, 12, 16, 11, 15, 13,
 
 void console_background(int colour) {
     int ansi_colour = ANSI_COLOURS[colour];
-    printf("\033[%dm", ansi_colour + (ansi_colour < 10 ? 40 : 90));
-    fflush(stdout);
+    console_printf("\033[%dm", ansi_colour + (ansi_colour < 10 ? 40 : 90));
 }
 
 void console_foreground(int colour) {
     int ansi_colour = ANSI_COLOURS[colour];
-    printf("\033[%dm", ansi_colour + (ansi_colour < 10 ? 30 : 80));
-    fflush(stdout);
+    console_printf("\033[%dm", ansi_colour + (ansi_colour < 10 ? 30 : 80));
 }
 
 void console_invert(int invert) {
-    printf(invert ? "\033[7m" : "\033[27m");
-    fflush(stdout);
+    console_printf(invert ? "\033[7m" : "\033[27m");
 }
 
 void console_reset() {
-    printf("\033[0m");
-    fflush(stdout);
+    console_printf("\033[0m");
 }
 
 void console_show_cursor(bool show) {
-    printf(show ? "\033[?25h" : "\033[?25l");
-    fflush(stdout);
-}
-
-size_t console_write(const char *buf, size_t sz) {
-    for (size_t idx = 0; idx < sz; ++idx) {
-        console_putc_noflush(buf[idx]);
-    }
-    fflush(stdout);
-    return sz;
+    console_printf(show ? "\033[?25h" : "\033[?25l");
 }
@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // the values returned by the standard control keys
 #define TAB 0x9
@@ -113,6 +114,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 extern int ListCnt;
 extern int MMCharPos;
+extern uint64_t console_tx_bytes;    // Bytes written to the console.
+extern uint64_t console_tx_flushes;  // Times buffered output has been flushed.
 
 /** @param  no_title  Set true to make console_set_title() a NOP. */
 void console_init(bool no_title);
@@ -120,10 +123,24 @@ void console_init(bool no_title);
 void console_background(int colour);
 void console_bell();
 void console_cursor_up(int i);
-void console_pump_input(void);
+/**
+ * Reads any available console input into the receive buffer.
+ *
+ * @return  The number of bytes read, 0 if there was nothing to read.
+ */
+int console_pump_input(void);
 void console_clear(void);
 void console_disable_raw_mode(void);
 void console_enable_raw_mode(void);
+
+/**
+ * Writes any buffered output to the terminal.
+ *
+ * Console output is buffered and only flushed between statements by the FLUSH
+ * background task, before waiting for or checking for input, and when a
+ * program ends; call this where output must be seen immediately.
+ */
+void console_flush(void);
 void console_foreground(int colour);
 
 /**
@@ -161,10 +178,10 @@ void console_invert(int invert);
 /** Gets the number of characters waiting in the console input queue. */
 int console_kbhit(void);
 
-/** Writes a character to the console. */
+/** Writes a character to the console buffer. */
 char console_putc(char c);
 
-/** Write a NULL terminated string to the console. */
+/** Write a NULL terminated string to the console buffer. */
 void console_puts(const char *s);
 
 void console_reset(void);
@@ -200,6 +217,12 @@ void console_set_title(const char *title, bool command);
 /** Shows or hides cursor. */
 void console_show_cursor(bool show);
 
+/**
+ * Writes bytes to the console buffer, expanding characters > 127 to UTF-8
+ * according to OPTION CODEPAGE.
+ *
+ * @return  'sz'.
+ */
 size_t console_write(const char *buf, size_t sz);
 
 /** Adds a character to the console input buffer. */
@@ -75,6 +75,10 @@ const char* events_last_error() {
     return emsg && *emsg ? emsg : NO_ERROR;
 }
 
+bool events_is_initialised() {
+    return events_initialised;
+}
+
 void events_pump() {
     if (!events_initialised) return;
 
@@ -134,7 +138,7 @@ void events_pump() {
                     case SDL_WINDOWEVENT_EXPOSED: {
                         MmSurfaceId window_id = graphics_find_window(event.window.windowID);
                         if (window_id == -1) ON_FAILURE_ERROR(kInternalFault);
-                        graphics_surfaces[window_id].dirty = true;
+                        graphics_surface_dirty_all(&graphics_surfaces[window_id]);
                     }
 
                     default:
@@ -47,8 +47,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "mmresult.h"
 
+#include <stdbool.h>
+
 MmResult events_init();
 const char *events_last_error();
+bool events_is_initialised();
 void events_pump();
 
 #endif // #if !defined(MMBASIC_EVENTS_H)
@@ -45,6 +45,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "mmb4l.h"
@@ -60,11 +65,52 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 FileEntry file_table[MAXOPENFILES + 1] = { 0 };
 
 /**
- * @param  filename  filename in C-string style, not MMBasic style.
+ * Maps the whole of a file read-only into memory.
+ *
+ * The mapping is private to MMB4L and does not come from the MMBasic heap.
  */
+static MmResult file_open_map(const char *filename, int fnbr) {
+    errno = 0;
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) return errno;
+
+    struct stat st;
+    const char *map_ptr = NULL;
+    MmResult result = kOk;
+    if (FAILED(fstat(fd, &st))) {
+        result = errno;
+    } else if (!S_ISREG(st.st_mode)) {
+        result = EINVAL; // Only regular files can be mapped.
+    } else if (st.st_size > 0) {
+        void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            result = errno;
+        } else {
+            map_ptr = addr;
+            (void) madvise(addr, st.st_size, MADV_SEQUENTIAL);
+        }
+    }
+    (void) close(fd); // The mapping remains valid after the descriptor is closed.
+    if (FAILED(result)) return result;
+
+    FileEntry *entry = &file_table[fnbr];
+    entry->type = fet_map;
+    entry->map_ptr = map_ptr;
+    entry->writing = false;
+    entry->read_pos = 0;
+    entry->read_len = 0;
+    entry->append = false;
+    entry->position = 0L;
+    entry->size = (long) st.st_size;
+    entry->seek_pending = false;
+
+    return kOk;
+}
+
 MmResult file_open(const char *filename, const char *mode, int fnbr) {
     if (fnbr < 1 || fnbr > MAXOPENFILES) return kFileInvalidFileNumber;
     if (file_table[fnbr].type != fet_closed) return kFileAlreadyOpen;
+    if (*mode == 'm') return file_open_map(filename, fnbr);
 
     // random writing is not allowed when a file is opened for append so open it
     // first for read+update and if that does not work open it for
@@ -87,12 +133,103 @@ MmResult file_open(const char *filename, const char *mode, int fnbr) {
         if (!f) return errno;
     }
 
-    file_table[fnbr].type = fet_file;
-    file_table[fnbr].file_ptr = f;
+    // Cache the size so that LOF() does not have to query the file,
+    // it is then kept up to date as the file is written.
+    struct stat st;
+    errno = 0;
+    if (FAILED(fstat(fileno(f), &st))) {
+        MmResult result = errno;
+        (void) fclose(f);
+        return result;
+    }
+    const long size = S_ISREG(st.st_mode) ? (long) st.st_size : -1L;
+
+    FileEntry *entry = &file_table[fnbr];
+    entry->type = fet_file;
+    entry->file_ptr = f;
+    entry->writing = false;
+    entry->read_pos = 0;
+    entry->read_len = 0;
+    entry->append = (*mode == 'a');
+    entry->position = (*mode == 'x' || entry->append) ? max(size, 0L) : 0L;
+    entry->size = size;
+    entry->seek_pending = false;
+
+    return kOk;
+}
 
+MmResult file_set_buffering(int fnbr, FileBuffering buffering) {
+    if (fnbr < 1 || fnbr > MAXOPENFILES) return kFileInvalidFileNumber;
+    if (file_table[fnbr].type == fet_closed) return kFileNotOpen;
+    if (file_table[fnbr].type != fet_file) return kOk; // Serial I/O ports and mapped files are unbuffered.
+
+    int mode;
+    switch (buffering) {
+        case kFileBufferFull: mode = _IOFBF; break;
+        case kFileBufferLine: mode = _IOLBF; break;
+        case kFileBufferNone: mode = _IONBF; break;
+        default: return kInternalFault;
+    }
+    errno = 0;
+    if (FAILED(setvbuf(file_table[fnbr].file_ptr, NULL, mode, BUFSIZ))) return errno;
     return kOk;
 }
 
+/** Moves the stream to the logical file position, discarding any read-ahead. */
+static void file_sync_position(FileEntry *entry) {
+    errno = 0;
+    // Not all files are seekable, e.g. named pipes, but those are also never SEEKed
+    // nor both read and written.
+    if (FAILED(fseek(entry->file_ptr, entry->position, SEEK_SET)) && errno != ESPIPE) {
+        error_throw(errno);
+    }
+    entry->read_pos = 0;
+    entry->read_len = 0;
+    entry->seek_pending = false;
+}
+
+/** Prepares a file for reading after it may have been written or SEEKed. */
+static inline void file_begin_read(FileEntry *entry) {
+    if (entry->seek_pending) {
+        file_sync_position(entry); // Also flushes any buffered output.
+    } else if (entry->writing) {
+        errno = 0;
+        if (FAILED(fflush(entry->file_ptr))) error_throw(errno);
+    }
+    entry->writing = false;
+}
+
+/** Prepares a file for writing after it may have been read or SEEKed. */
+static inline void file_begin_write(FileEntry *entry) {
+    if (entry->writing && !entry->seek_pending) return;
+    file_sync_position(entry);
+    entry->writing = true;
+}
+
+/** Updates the cached position and size after writing to a file. */
+static inline void file_end_write(FileEntry *entry, size_t count) {
+    if (entry->append && entry->size != -1L) entry->position = entry->size;
+    entry->position += (long) count;
+    if (entry->size != -1L && entry->position > entry->size) entry->size = entry->position;
+}
+
+/**
+ * Refills a file's read-ahead buffer if it is empty.
+ *
+ * @return  the number of bytes in the buffer, 0 at end of file.
+ */
+static int file_fill(FileEntry *entry) {
+    if (entry->read_pos < entry->read_len) return entry->read_len - entry->read_pos;
+    file_begin_read(entry);
+    FILE *f = entry->file_ptr;
+    errno = 0;
+    size_t count = fread(entry->read_buf, 1, FILE_READ_AHEAD_SIZE, f);
+    if (count < FILE_READ_AHEAD_SIZE && ferror(f)) error_throw(errno);
+    entry->read_pos = 0;
+    entry->read_len = (int) count;
+    return entry->read_len;
+}
+
 MmResult file_close(int fnbr) {
     if (fnbr < 1 || fnbr > MAXOPENFILES) return kFileInvalidFileNumber;
 
@@ -102,15 +239,28 @@ MmResult file_close(int fnbr) {
 
         case fet_file: {
             errno = 0;
-            int result = fclose(file_table[fnbr].file_ptr);
+            int result = fclose(file_table[fnbr].file_ptr); // Also flushes any buffered output.
             file_table[fnbr].type = fet_closed;
             file_table[fnbr].file_ptr = NULL;
+            file_table[fnbr].read_pos = 0;
+            file_table[fnbr].read_len = 0;
             if (FAILED(result)) return errno;
             break;
         }
 
         case fet_serial:
             return serial_close(fnbr);
+
+        case fet_map: {
+            errno = 0;
+            int result = file_table[fnbr].map_ptr
+                    ? munmap((void *) file_table[fnbr].map_ptr, file_table[fnbr].size)
+                    : 0;
+            file_table[fnbr].type = fet_closed;
+            file_table[fnbr].map_ptr = NULL;
+            if (FAILED(result)) return errno;
+            break;
+        }
     }
 
     return kOk;
@@ -122,6 +272,39 @@ void file_close_all(void) {
     }
 }
 
+MmResult file_flush(int fnbr) {
+    if (fnbr < 0 || fnbr > MAXOPENFILES) return kFileInvalidFileNumber;
+
+    errno = 0;
+    if (fnbr == 0) {
+        console_flush();
+        return kOk;
+    }
+
+    switch (file_table[fnbr].type) {
+        case fet_closed:
+            return kFileNotOpen;
+
+        case fet_file:
+            if (FAILED(fflush(file_table[fnbr].file_ptr))) return errno;
+            break;
+
+        case fet_serial:
+            return serial_flush(fnbr);
+
+        case fet_map:
+            break; // Mapped files are read-only.
+    }
+
+    return kOk;
+}
+
+void file_flush_all(void) {
+    for (int fnbr = 1; fnbr <= MAXOPENFILES; fnbr++) {
+        if (file_table[fnbr].type == fet_file) (void) fflush(file_table[fnbr].file_ptr);
+    }
+}
+
 int file_getc(int fnbr) {
     if (fnbr < 0 || fnbr > MAXOPENFILES) {
         error_throw(kFileInvalidFileNumber);
@@ -135,20 +318,20 @@ int file_getc(int fnbr) {
             return -1;
 
         case fet_file: {
-            errno = 0;
-            char ch;
-            if (fread(&ch, 1, 1, file_table[fnbr].file_ptr) == 0) {
-                if (ferror(file_table[fnbr].file_ptr) == 0) {
-                    ch = -1;
-                } else {
-                    error_throw(errno);
-                }
-            }
-            return (int) ch;
+            FileEntry *entry = &file_table[fnbr];
+            if (entry->read_pos == entry->read_len && file_fill(entry) == 0) return -1;
+            entry->position++;
+            return (unsigned char) entry->read_buf[entry->read_pos++];
         }
 
         case fet_serial:
             return serial_getc(fnbr);
+
+        case fet_map: {
+            FileEntry *entry = &file_table[fnbr];
+            if (entry->position >= entry->size) return -1;
+            return (unsigned char) entry->map_ptr[entry->position++];
+        }
     }
 
     ERROR_INTERNAL_FAULT;
@@ -167,10 +350,8 @@ int file_loc(int fnbr) {
             return -1;
 
         case fet_file:
-            errno = 0;
-            long int result = ftell(file_table[fnbr].file_ptr);
-            if (result == -1L) error_throw(errno);
-            return (int) (result + 1);
+        case fet_map:
+            return (int) (file_table[fnbr].position + 1);
             break;
 
         case fet_serial:
@@ -193,6 +374,7 @@ int file_lof(int fnbr) {
             return -1;
 
         case fet_file: {
+            if (file_table[fnbr].size != -1L) return (int) file_table[fnbr].size;
             errno = 0;
             FILE *f = file_table[fnbr].file_ptr;
             long int current = ftell(f);
@@ -201,12 +383,19 @@ int file_lof(int fnbr) {
             long int result = ftell(f);
             if (result == -1L) error_throw(errno);
             if (FAILED(fseek(f, current, SEEK_SET))) error_throw(errno);
+            file_table[fnbr].writing = false;
             return result;
             break;
         }
 
         case fet_serial:
-            return 0; // Serial I/O ports are unbuffered.
+            // As on other MMBasic platforms this is the free space in the
+            // transmit buffer.
+            return serial_tx_space(fnbr);
+            break;
+
+        case fet_map:
+            return (int) file_table[fnbr].size;
             break;
     }
 
@@ -226,18 +415,22 @@ int file_putc(int fnbr, int ch) {
             return -1;
 
         case fet_file: {
+            file_begin_write(&file_table[fnbr]);
             errno = 0;
-            if (fwrite(&ch, 1, 1, file_table[fnbr].file_ptr) == 0) {
+            if (putc(ch, file_table[fnbr].file_ptr) == EOF) {
                 if (ferror(file_table[fnbr].file_ptr)) error_throw(errno);
                 assert(false); // Always expect ferror to have been set.
             }
-            // TODO: Do I really want to be flushing every character ?
-            if (FAILED(fflush(file_table[fnbr].file_ptr))) error_throw(errno);
+            file_end_write(&file_table[fnbr], 1);
             return (int) ch;
         }
 
         case fet_serial:
             return serial_putc(fnbr, ch);
+
+        case fet_map:
+            error_throw(EBADF); // Mapped files are read-only.
+            return -1;
     }
 
     ERROR_INTERNAL_FAULT;
@@ -256,26 +449,50 @@ int file_eof(int fnbr) {
             error_throw(kFileNotOpen);
             return 0;
 
-        case fet_file: {
-            FILE *f = file_table[fnbr].file_ptr;
-            errno = 0;
-            int ch = fgetc(f); // Try to read beyond the end of the file.
-            if (ch == EOF) {
-                if (ferror(f)) error_throw(errno);
-            } else {
-                if (ungetc(ch, f) == EOF) error_throw(errno);
-            }
-            return ch == EOF;
-        }
+        case fet_file:
+            return file_fill(&file_table[fnbr]) == 0;
 
         case fet_serial:
             return serial_eof(fnbr);
+
+        case fet_map:
+            return file_table[fnbr].position >= file_table[fnbr].size;
     }
 
     ERROR_INTERNAL_FAULT;
     return 1;
 }
 
+int file_peek(int fnbr, const char **data) {
+    if (fnbr < 1 || fnbr > MAXOPENFILES) {
+        error_throw(kFileInvalidFileNumber);
+        return 0;
+    }
+    FileEntry *entry = &file_table[fnbr];
+    switch (entry->type) {
+        case fet_closed:
+            error_throw(kFileNotOpen);
+            return 0;
+
+        case fet_file: {
+            int count = file_fill(entry);
+            *data = entry->read_buf + entry->read_pos;
+            return count;
+        }
+
+        case fet_map:
+            // The data is returned directly from the mapping without copying.
+            *data = entry->map_ptr + entry->position;
+            return (int) min(max(entry->size - entry->position, 0L), (long) INT_MAX);
+
+        case fet_serial:
+            break;
+    }
+
+    ERROR_INTERNAL_FAULT;
+    return 0;
+}
+
 size_t file_read(int fnbr, char *buf, size_t sz) {
     if (fnbr < 0 || fnbr > MAXOPENFILES) {
         ON_FAILURE_ERROR_EX(kFileInvalidFileNumber, 0);
@@ -288,15 +505,36 @@ size_t file_read(int fnbr, char *buf, size_t sz) {
             return 0;
 
         case fet_file: {
+            // Use any read-ahead first, then read the remainder directly.
+            FileEntry *entry = &file_table[fnbr];
+            size_t result = min(sz, (size_t) (entry->read_len - entry->read_pos));
+            memcpy(buf, entry->read_buf + entry->read_pos, result);
+            entry->read_pos += (int) result;
+            entry->position += (long) result;
+            if (result == sz) return result;
+            file_begin_read(entry);
             errno = 0;
-            size_t result = fread(buf, 1, sz, file_table[fnbr].file_ptr);
-            if (result < sz && ferror(file_table[fnbr].file_ptr)) error_throw(errno);
-            return result;
+            size_t count = fread(buf + result, 1, sz - result, entry->file_ptr);
+            if (count < sz - result && ferror(entry->file_ptr)) error_throw(errno);
+            entry->position += (long) count;
+            // The stream has moved past the end of the read-ahead buffer, so
+            // its contents no longer precede 'position'.
+            entry->read_pos = 0;
+            entry->read_len = 0;
+            return result + count;
         }
 
         case fet_serial:
-            assert(false); // return serial_write(fnbr, buf, sz);
-            break;
+            return serial_read(fnbr, buf, sz);
+
+        case fet_map: {
+            FileEntry *entry = &file_table[fnbr];
+            size_t result = (size_t) max(entry->size - entry->position, 0L);
+            if (result > sz) result = sz;
+            memcpy(buf, entry->map_ptr + entry->position, result);
+            entry->position += (long) result;
+            return result;
+        }
     }
 
     ON_FAILURE_ERROR_EX(kInternalFault, 0);
@@ -318,12 +556,37 @@ void file_seek(int fnbr, int idx) {
         error_throw(kFileNotOpen);
         return;
     }
-    FILE *f = file_table[fnbr].file_ptr;
 
-    errno = 0;
-    if (FAILED(fflush(f))) error_throw(errno);
-    if (FAILED(fsync(fileno(f)))) error_throw(errno);
-    if (FAILED(fseek(f, idx - 1, SEEK_SET))) error_throw(errno); // MMBasic indexes from 1, not 0.
+    FileEntry *entry = &file_table[fnbr];
+    const long position = idx - 1; // MMBasic indexes from 1, not 0.
+    if (entry->type == fet_map) {
+        entry->position = position;
+        return;
+    }
+
+    // The stream is not moved until the next read or write, and not at all
+    // if the new position is within the read-ahead buffer.
+    const long buf_start = entry->position - entry->read_pos;
+    if (!entry->writing && !entry->seek_pending && entry->read_len > 0
+            && position >= buf_start && position <= buf_start + entry->read_len) {
+        entry->read_pos = (int) (position - buf_start);
+    } else {
+        entry->read_pos = 0;
+        entry->read_len = 0;
+        entry->seek_pending = true;
+    }
+    entry->position = position;
+}
+
+void file_skip(int fnbr, int count) {
+    FileEntry *entry = &file_table[fnbr];
+    if (entry->type == fet_map) {
+        entry->position += count;
+        return;
+    }
+    assert(entry->type == fet_file && count <= entry->read_len - entry->read_pos);
+    entry->read_pos += count;
+    entry->position += count;
 }
 
 int file_find_free(void) {
@@ -347,19 +610,24 @@ size_t file_write(int fnbr, const char *buf, size_t sz) {
             return 0;
 
         case fet_file: {
+            file_begin_write(&file_table[fnbr]);
             errno = 0;
             size_t result = fwrite(buf, 1, sz, file_table[fnbr].file_ptr);
             if (result != sz) {
                 if (ferror(file_table[fnbr].file_ptr)) error_throw(errno);
                 assert(false); // Always expect ferror to have been set.
             }
-            if (FAILED(fflush(file_table[fnbr].file_ptr))) error_throw(errno);
+            file_end_write(&file_table[fnbr], result);
             return result;
         }
 
         case fet_serial:
             return serial_write(fnbr, buf, sz);
             break;
+
+        case fet_map:
+            error_throw(EBADF); // Mapped files are read-only.
+            return 0;
     }
 
     ERROR_INTERNAL_FAULT;
@@ -51,17 +51,40 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../Configuration.h"
 #include "mmresult.h"
-#include "rx_buf.h"
 
-enum FileEntryType { fet_closed, fet_file, fet_serial };
+enum FileEntryType { fet_closed, fet_file, fet_serial, fet_map };
+
+/** Size of the per-file read-ahead buffer. */
+#define FILE_READ_AHEAD_SIZE  4096
+
+/** When is data written to a file passed on to the operating system. */
+typedef enum {
+    kFileBufferFull,  // When the buffer is full, or on FLUSH, CLOSE, END or error.
+    kFileBufferLine,  // As for kFileBufferFull and additionally at the end of each line.
+    kFileBufferNone   // Immediately.
+} FileBuffering;
 
 typedef struct {
     enum FileEntryType type;
     union {
         FILE *file_ptr;
         int serial_fd;
+        const char *map_ptr;  // Read-only memory mapping of the whole file, NULL if it is empty.
     };
-    RxBuf rx_buf;
+    // Was the last operation on 'file_ptr' a write ? If so then it must be
+    // flushed before reading, if not then it must be repositioned before writing.
+    bool writing;
+    // Read-ahead buffer for 'file_ptr', the underlying stream is positioned
+    // at the end of this data so (read_len - read_pos) bytes ahead of the
+    // logical file position.
+    char read_buf[FILE_READ_AHEAD_SIZE];
+    int read_pos;       // Index of the next byte to read.
+    int read_len;       // Number of bytes in the buffer.
+    // Also used for memory mapped files.
+    long position;      // Logical file position, from 0.
+    long size;          // File size, or -1 if not known, e.g. for a named pipe.
+    bool append;        // Are all writes made at the end of the file ?
+    bool seek_pending;  // Must 'file_ptr' be moved to 'position' before the next read or write ?
 } FileEntry;
 
 extern FileEntry file_table[MAXOPENFILES + 1];
@@ -71,16 +94,60 @@ void MMgetline(int fnbr, char *p); // main.c
 /** Finds the first available free file number. */
 int file_find_free(void);
 
+/**
+ * Opens a file.
+ *
+ * @param  filename  filename in C-string style, not MMBasic style.
+ * @param  mode      an fopen() mode, or the special modes:
+ *                     "x" - read+write, creating the file if necessary and
+ *                           starting at the end of the file.
+ *                     "m" - read-only memory mapping of the file.
+ * @param  fnbr      file number to open.
+ */
 MmResult file_open(const char *filename, const char *mode, int fnbr);
 MmResult file_close(int fnbr);
 void file_close_all(void);
 int file_eof(int fnbr);
+
+/** Writes any buffered output for a file; file number 0 is the console. */
+MmResult file_flush(int fnbr);
+
+/** Writes any buffered output for all open files, ignoring any errors. */
+void file_flush_all(void);
 int file_getc(int fnbr);
 int file_loc(int fnbr);
 int file_lof(int fnbr);
 int file_putc(int fnbr, int ch);
+
+/**
+ * Gets the data available in a file's read-ahead buffer, refilling it if empty.
+ * The data is not consumed, call file_skip() to do so.
+ *
+ * @param  fnbr  file number, must be a file or memory mapped file, not a serial port or the console.
+ * @param  data  on exit, pointer to the buffered data.
+ * @return       number of bytes available, 0 at end of file.
+ */
+int file_peek(int fnbr, const char **data);
+
 size_t file_read(int fnbr, char *buf, size_t sz);
 void file_seek(int fnbr, int idx);
+
+/**
+ * Consumes data previously returned by file_peek().
+ *
+ * @param  fnbr   file number.
+ * @param  count  number of bytes to consume, must not exceed the value returned by file_peek().
+ */
+void file_skip(int fnbr, int count);
+
+/**
+ * Sets when data written to a file is passed on to the operating system,
+ * by default this is kFileBufferFull.
+ *
+ * Must be called immediately after file_open() before any data is read or written.
+ */
+MmResult file_set_buffering(int fnbr, FileBuffering buffering);
+
 size_t file_write(int fnbr, const char *buf, size_t sz);
 
 #endif
@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
 #include "bitset.h"
+#include "blit.h"
 #include "cstring.h"
 #include "error.h"
 #include "events.h"
@@ -230,46 +231,97 @@ MmSurfaceId graphics_find_window(uint32_t sdl_window_id) {
 }
 
 /**
- * Refreshes the simulated CMM2 display by clearing it to the background
- * colour and then alpha blending surfaces 0 followed by 1 onto it.
- * This behaviour is specific to CMM2 simulation.
+ * Texture holding the pixels of CMM2 page 1, created on demand using the
+ * renderer for window 0; the texture of window 0 itself only ever holds
+ * the pixels of window 0 so each can be updated independently.
  */
-static MmResult graphics_refresh_cmm2_window() {
-    if (graphics_colour_depth != 12) return kOk; // Use default window refresh.
-    assert(mmb_options.simulate == kSimulateCmm2 || mmb_options.simulate == kSimulateMmb4w);
-    MmSurface* window = &graphics_surfaces[0];
-    MmSurface* page1 = &graphics_surfaces[1];
-    assert(window->type == kGraphicsWindow);
-    assert(page1->type == kGraphicsBuffer);
-    if (!window->dirty && !page1->dirty) return kOk;
+static SDL_Texture *graphics_cmm2_page1_texture = NULL;
+
+/** Gets the dirty rectangle of a surface as an SDL_Rect. */
+static inline SDL_Rect graphics_dirty_sdl_rect(const MmSurface *surface) {
+    return (SDL_Rect) { surface->dirty_x1, surface->dirty_y1,
+                        surface->dirty_x2 - surface->dirty_x1 + 1,
+                        surface->dirty_y2 - surface->dirty_y1 + 1 };
+}
+
+/** Uploads the dirty rectangle of a surface to a texture of the same size. */
+static inline void graphics_update_texture(SDL_Texture *texture, MmSurface *surface) {
+    if (!surface->dirty) return;
+    const SDL_Rect rect = graphics_dirty_sdl_rect(surface);
+    SDL_UpdateTexture(texture, &rect, surface->pixels + rect.y * surface->width + rect.x,
+                      surface->width * 4);
+    surface->dirty = false;
+}
 
-    SDL_Renderer *renderer = window->renderer;
-    SDL_Texture *texture = window->texture;
+/**
+ * Composes the simulated CMM2 display by clearing it to the background
+ * colour and then alpha blending surfaces 0 followed by 1 onto it.
+ * The caller is responsible for calling SDL_RenderPresent().
+ *
+ * @param  renderer    renderer for window 0.
+ * @param  texture     texture for window 0.
+ * @param  page0       pixels of page 0 (which is the "window").
+ * @param  page1       pixels of page 1.
+ * @param  background  colour of the background layer.
+ */
+static MmResult graphics_compose_cmm2(SDL_Renderer *renderer, SDL_Texture *texture,
+                                      MmSurface *page0, MmSurface *page1,
+                                      MmGraphicsColour background) {
+    if (!graphics_cmm2_page1_texture) {
+        graphics_cmm2_page1_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                                        SDL_TEXTUREACCESS_STREAMING,
+                                                        page1->width, page1->height);
+        if (!graphics_cmm2_page1_texture) return kGraphicsApiError;
+        SDL_SetTextureBlendMode(graphics_cmm2_page1_texture, SDL_BLENDMODE_BLEND);
+        graphics_surface_dirty_all(page1);
+    }
 
     // TODO: Do this on setup instead of each refresh.
     SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
 
     // Clear to the background colour.
     SDL_SetRenderDrawColor(renderer,
-                           (graphics_cmm2_background >> 16) & 0b11111111,
-                           (graphics_cmm2_background >> 8) & 0b11111111,
-                           graphics_cmm2_background & 0b11111111,
+                           (background >> 16) & 0b11111111,
+                           (background >> 8) & 0b11111111,
+                           background & 0b11111111,
                            SDL_ALPHA_OPAQUE);
     SDL_RenderClear(renderer);
 
-    // Blend in pixels from page 0 (which is the "window").
-    SDL_UpdateTexture(texture, NULL, window->pixels, window->width * 4);
+    // Blend in pixels from page 0.
+    graphics_update_texture(texture, page0);
     SDL_RenderCopy(renderer, texture, NULL, NULL);
 
     // Blend in pixels from page 1.
-    SDL_UpdateTexture(texture, NULL, page1->pixels, page1->width * 4);
-    SDL_RenderCopy(renderer, texture, NULL, NULL);
+    graphics_update_texture(graphics_cmm2_page1_texture, page1);
+    SDL_RenderCopy(renderer, graphics_cmm2_page1_texture, NULL, NULL);
 
-    SDL_RenderPresent(renderer);
-    if (SDL_GetWindowFlags(window->window) & SDL_WINDOW_HIDDEN) SDL_ShowWindow(window->window);
+    return kOk;
+}
+
+/** Are we simulating the three layer CMM2 display? */
+static inline bool graphics_is_cmm2_display() {
+    return (mmb_options.simulate == kSimulateCmm2 || mmb_options.simulate == kSimulateMmb4w)
+            && graphics_colour_depth == 12;
+}
+
+/**
+ * Refreshes the simulated CMM2 display.
+ * This behaviour is specific to CMM2 simulation.
+ */
+static MmResult graphics_refresh_cmm2_window() {
+    if (graphics_colour_depth != 12) return kOk; // Use default window refresh.
+    assert(mmb_options.simulate == kSimulateCmm2 || mmb_options.simulate == kSimulateMmb4w);
+    MmSurface* window = &graphics_surfaces[0];
+    MmSurface* page1 = &graphics_surfaces[1];
+    assert(window->type == kGraphicsWindow);
+    assert(page1->type == kGraphicsBuffer);
+    if (!window->dirty && !page1->dirty) return kOk;
 
-    window->dirty = false;
-    page1->dirty = false;
+    ON_FAILURE_RETURN(graphics_compose_cmm2(window->renderer, window->texture, window, page1,
+                                            graphics_cmm2_background));
+
+    SDL_RenderPresent(window->renderer);
+    if (SDL_GetWindowFlags(window->window) & SDL_WINDOW_HIDDEN) SDL_ShowWindow(window->window);
 
     return kOk;
 }
@@ -287,14 +339,14 @@ static inline MmResult graphics_copy_internal(MmSurface *src, MmSurface *dst) {
 
     if (src != dst) {
         memcpy(dst->pixels, src->pixels, src->width * src->height * sizeof(uint32_t));
-        dst->dirty = true;
+        graphics_surface_dirty_all(dst);
     }
 
     return kOk;
 }
 
 /**
- * Copies frame buffer N (surface 1) to the display (surface 0).
+ * Copies the dirty rectangle of frame buffer N (surface 1) to the display (surface 0).
  */
 static MmResult graphics_refresh_gamemite_window() {
     MmSurface *buffer_N = &graphics_surfaces[GRAPHICS_SURFACE_N];
@@ -302,7 +354,9 @@ static MmResult graphics_refresh_gamemite_window() {
     MmResult result = kOk;
     if (graphics_surface_exists(GRAPHICS_SURFACE_N)) {
         MmSurface *window = &graphics_surfaces[0];
-        result = graphics_copy_internal(buffer_N, window);
+        const SDL_Rect rect = graphics_dirty_sdl_rect(buffer_N);
+        result = graphics_blit(rect.x, rect.y, rect.x, rect.y, rect.w, rect.h, buffer_N, window,
+                               0x0, -1);
     }
     if (SUCCEEDED(result)) buffer_N->dirty = false;
     return kOk;
@@ -312,6 +366,7 @@ static MmResult graphics_refresh_gamemite_window() {
  * Copies frame buffer N (surface 1) to the display (surface 0)
  * and then merges frame buffer L (surface 3) with it,
  * ignoring transparent pixels from L.
+ * Only the union of the dirty rectangles of N and L is copied and merged.
  * This behaviour is specific to the PicoMite VGA.
  */
 static MmResult graphics_refresh_picomite_vga_window() {
@@ -321,17 +376,26 @@ static MmResult graphics_refresh_picomite_vga_window() {
     if (!buffer_N->dirty && !buffer_L->dirty) return kOk;
 
     MmSurface *window = &graphics_surfaces[0];
-    const uint32_t w = buffer_N->width;
-    const uint32_t h = buffer_N->height;
+    MmSurface region = { .width = buffer_N->width, .height = buffer_N->height };
+    if (buffer_N->dirty) {
+        graphics_surface_dirty_rect(&region, buffer_N->dirty_x1, buffer_N->dirty_y1,
+                                    buffer_N->dirty_x2, buffer_N->dirty_y2);
+    }
+    if (buffer_L->dirty) {
+        graphics_surface_dirty_rect(&region, buffer_L->dirty_x1, buffer_L->dirty_y1,
+                                    buffer_L->dirty_x2, buffer_L->dirty_y2);
+    }
+    const SDL_Rect rect = graphics_dirty_sdl_rect(&region);
     MmResult result = kOk;
 
-    if (graphics_surface_exists(GRAPHICS_SURFACE_N)) {
-        result = graphics_copy_internal(buffer_N, window);
+    if (region.dirty && graphics_surface_exists(GRAPHICS_SURFACE_N)) {
+        result = graphics_blit(rect.x, rect.y, rect.x, rect.y, rect.w, rect.h, buffer_N, window,
+                               0x0, -1);
     }
 
-    if (SUCCEEDED(result) && graphics_surface_exists(GRAPHICS_SURFACE_L)) {
-        result = graphics_blit(0, 0, 0, 0, w, h, buffer_L, window, kBlitWithTransparency,
-                               buffer_L->transparent);
+    if (SUCCEEDED(result) && region.dirty && graphics_surface_exists(GRAPHICS_SURFACE_L)) {
+        result = graphics_blit(rect.x, rect.y, rect.x, rect.y, rect.w, rect.h, buffer_L, window,
+                               kBlitWithTransparency, buffer_L->transparent);
     }
 
     if (SUCCEEDED(result)) {
@@ -342,44 +406,367 @@ static MmResult graphics_refresh_picomite_vga_window() {
     return result;
 }
 
-void graphics_refresh_windows() {
-    // if (SDL_GetTicks64() > frameEnd) {
-    if (SDL_GetTicks() > frameEnd) {
-        switch (mmb_options.simulate) {
-            case kSimulateCmm2:
-            case kSimulateMmb4w:
-                ON_FAILURE_ERROR(graphics_refresh_cmm2_window());
-                break;
-            case kSimulateGameMite:
-                ON_FAILURE_ERROR(graphics_refresh_gamemite_window());
-                break;
-            case kSimulatePicoMiteVga:
-                ON_FAILURE_ERROR(graphics_refresh_picomite_vga_window());
-                break;
-            default:
-                break;
+/**
+ * Creates the SDL renderer and streaming texture for a window and clears it to black.
+ *
+ * This must be called on the thread that will use the renderer, i.e. the interpreter
+ * thread for kRenderInline and the render thread for kRenderThread.
+ */
+static MmResult graphics_create_renderer(SDL_Window *window, int width, int height, bool vsync,
+                                         SDL_Renderer **renderer, SDL_Texture **texture) {
+    MmResult result = kOk;
+
+    *renderer = SDL_CreateRenderer(window, -1, vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+    if (!*renderer) result = kGraphicsApiError;
+
+    *texture = NULL;
+    if (SUCCEEDED(result)) {
+        *texture = SDL_CreateTexture(*renderer, SDL_PIXELFORMAT_ARGB8888,
+                                     SDL_TEXTUREACCESS_STREAMING, width, height);
+        if (!*texture) result = kGraphicsApiError;
+    }
+
+    if (SUCCEEDED(result)) {
+        result = SUCCEEDED(SDL_SetRenderDrawColor(*renderer, 0, 0, 0, SDL_ALPHA_OPAQUE))
+                ? kOk : kGraphicsApiError;
+    }
+
+    if (SUCCEEDED(result)) {
+        result = SUCCEEDED(SDL_RenderClear(*renderer)) ? kOk : kGraphicsApiError;
+    }
+
+    if (SUCCEEDED(result)) {
+        SDL_RenderPresent(*renderer);
+    } else {
+        SDL_DestroyTexture(*texture);
+        *texture = NULL;
+        SDL_DestroyRenderer(*renderer);
+        *renderer = NULL;
+    }
+
+    return result;
+}
+
+/** Destroys the renderers/textures created on the interpreter thread for kRenderInline. */
+static void graphics_destroy_inline_renderers() {
+    SDL_DestroyTexture(graphics_cmm2_page1_texture);
+    graphics_cmm2_page1_texture = NULL;
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+        MmSurface *s = &graphics_surfaces[id];
+        if (s->type != kGraphicsWindow || !s->renderer) continue;
+        SDL_DestroyTexture((SDL_Texture *) s->texture);
+        s->texture = NULL;
+        SDL_DestroyRenderer((SDL_Renderer *) s->renderer);
+        s->renderer = NULL;
+    }
+}
+
+/*
+ * When mmb_options.render == kRenderThread windows are presented by a dedicated
+ * render thread so that texture uploads and SDL_RenderPresent(), which may block
+ * waiting for vsync, do not stall the interpreter:
+ *
+ *  - the interpreter copies the dirty regions of each window (and CMM2 page 1)
+ *    into a snapshot surface in 'graphics_render_frames[]', increments
+ *    'graphics_render_published' and signals 'graphics_render_cond_published'.
+ *  - the render thread uploads the dirty regions of the snapshots to textures that
+ *    it owns, then releases the mutex before presenting, increments
+ *    'graphics_render_presented' and signals 'graphics_render_cond_presented'.
+ *
+ * Together the snapshot and texture double-buffer each window. The render thread
+ * owns all the SDL renderers and textures, those in 'graphics_surfaces[]' are NULL.
+ */
+static SDL_Thread *graphics_render_thread = NULL;
+static SDL_mutex *graphics_render_mutex = NULL;
+static SDL_cond *graphics_render_cond_published = NULL;
+static SDL_cond *graphics_render_cond_presented = NULL;
+static bool graphics_render_quit = false;
+static bool graphics_render_vsync = true;
+static bool graphics_render_cmm2 = false;
+static MmGraphicsColour graphics_render_cmm2_background = RGB_BLACK;
+static uint64_t graphics_render_published = 0;
+static uint64_t graphics_render_presented = 0;
+static MmSurface graphics_render_frames[GRAPHICS_MAX_SURFACES] = { 0 };
+
+/** Maximum time to wait in graphics_sync() for the render thread to present a frame. */
+#define GRAPHICS_RENDER_SYNC_TIMEOUT_MS  250
+
+static int graphics_render_thread_main(void *data) {
+    SDL_Renderer *present[GRAPHICS_MAX_SURFACES];
+
+    SDL_LockMutex(graphics_render_mutex);
+    for (;;) {
+        while (!graphics_render_quit && graphics_render_presented == graphics_render_published) {
+            SDL_CondWait(graphics_render_cond_published, graphics_render_mutex);
         }
+        if (graphics_render_quit) break;
+
+        const uint64_t published = graphics_render_published;
+        MmSurface *page1 = &graphics_render_frames[1];
+        size_t count = 0;
+        for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+            MmSurface *frame = &graphics_render_frames[id];
+            if (frame->type != kGraphicsWindow) continue;
+            const bool cmm2 = id == 0 && graphics_render_cmm2 && page1->pixels;
+            if (!frame->dirty && !(cmm2 && page1->dirty)) continue;
+
+            if (!frame->renderer) {
+                SDL_Renderer *renderer;
+                SDL_Texture *texture;
+                if (FAILED(graphics_create_renderer(frame->window, frame->width, frame->height,
+                                                    graphics_render_vsync, &renderer,
+                                                    &texture))) {
+                    continue;
+                }
+                frame->renderer = renderer;
+                frame->texture = texture;
+                graphics_surface_dirty_all(frame);
+            }
 
-        // TODO: Optimise by using linked-list of windows.
-        for (int id = 0; id <= GRAPHICS_MAX_ID; ++id) {
-            MmSurface* s = &graphics_surfaces[id];
-            if (s->type == kGraphicsWindow && s->dirty) {
-                SDL_UpdateTexture((SDL_Texture *) s->texture, NULL, s->pixels, s->width * 4);
-                SDL_RenderCopy((SDL_Renderer *) s->renderer, (SDL_Texture *) s->texture, NULL,
-                               NULL);
-
-                // Window must be shown before calling SDL_RenderPresent().
-                if (SDL_GetWindowFlags(s->window) & SDL_WINDOW_HIDDEN) {
-                    SDL_ShowWindow(s->window);
-                    SDL_RaiseWindow(s->window);
+            if (cmm2) {
+                if (FAILED(graphics_compose_cmm2(frame->renderer, frame->texture, frame, page1,
+                                                 graphics_render_cmm2_background))) {
+                    continue;
                 }
+            } else {
+                graphics_update_texture(frame->texture, frame);
+                SDL_RenderCopy(frame->renderer, frame->texture, NULL, NULL);
+            }
+            present[count++] = frame->renderer;
+        }
+
+        // Do not hold the mutex whilst presenting as it may block waiting for vsync.
+        SDL_UnlockMutex(graphics_render_mutex);
+        for (size_t i = 0; i < count; ++i) SDL_RenderPresent(present[i]);
+        SDL_LockMutex(graphics_render_mutex);
 
-                SDL_RenderPresent((SDL_Renderer *) s->renderer);
-                s->dirty = false;
+        graphics_render_presented = published;
+        SDL_CondBroadcast(graphics_render_cond_presented);
+    }
+
+    // Renderers and textures must be destroyed by the thread that created them.
+    SDL_DestroyTexture(graphics_cmm2_page1_texture);
+    graphics_cmm2_page1_texture = NULL;
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+        MmSurface *frame = &graphics_render_frames[id];
+        if (!frame->renderer) continue;
+        SDL_DestroyTexture(frame->texture);
+        frame->texture = NULL;
+        SDL_DestroyRenderer(frame->renderer);
+        frame->renderer = NULL;
+    }
+    SDL_UnlockMutex(graphics_render_mutex);
+
+    return 0;
+}
+
+static MmResult graphics_render_start() {
+    if (!graphics_render_mutex) {
+        graphics_render_mutex = SDL_CreateMutex();
+        graphics_render_cond_published = SDL_CreateCond();
+        graphics_render_cond_presented = SDL_CreateCond();
+        if (!graphics_render_mutex || !graphics_render_cond_published
+                || !graphics_render_cond_presented) {
+            return kGraphicsApiError;
+        }
+    }
+
+    graphics_destroy_inline_renderers();
+    graphics_render_quit = false;
+    graphics_render_vsync = mmb_options.vsync;
+    graphics_render_published = 0;
+    graphics_render_presented = 0;
+    graphics_render_thread = SDL_CreateThread(graphics_render_thread_main, "MMB4L render", NULL);
+    return graphics_render_thread ? kOk : kGraphicsApiError;
+}
+
+/**
+ * Stops the render thread (if running) and discards the window snapshots.
+ * Windows will be fully re-uploaded the next time they are refreshed.
+ */
+static void graphics_render_stop() {
+    if (!graphics_render_thread) return;
+
+    SDL_LockMutex(graphics_render_mutex);
+    graphics_render_quit = true;
+    SDL_CondSignal(graphics_render_cond_published);
+    SDL_UnlockMutex(graphics_render_mutex);
+    SDL_WaitThread(graphics_render_thread, NULL);
+    graphics_render_thread = NULL;
+
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+        free(graphics_render_frames[id].pixels);
+        memset(&graphics_render_frames[id], 0, sizeof(MmSurface));
+    }
+}
+
+/**
+ * Copies the dirty rectangle of a surface into its snapshot.
+ * The caller must hold 'graphics_render_mutex'.
+ */
+static MmResult graphics_render_snapshot(MmSurface *surface) {
+    MmSurface *frame = &graphics_render_frames[surface->id];
+    if (!frame->pixels) {
+        frame->pixels = malloc(surface->width * surface->height * sizeof(uint32_t));
+        if (!frame->pixels) return kOutOfMemory;
+        frame->id = surface->id;
+        frame->type = surface->type;
+        frame->window = surface->window;
+        frame->width = surface->width;
+        frame->height = surface->height;
+        graphics_surface_dirty_all(surface);
+    }
+    if (!surface->dirty) return kOk;
+
+    const SDL_Rect rect = graphics_dirty_sdl_rect(surface);
+    for (int y = rect.y; y < rect.y + rect.h; ++y) {
+        const size_t offset = y * surface->width + rect.x;
+        memcpy(frame->pixels + offset, surface->pixels + offset, rect.w * sizeof(uint32_t));
+    }
+    graphics_surface_dirty_rect(frame, surface->dirty_x1, surface->dirty_y1, surface->dirty_x2,
+                                surface->dirty_y2);
+    surface->dirty = false;
+    return kOk;
+}
+
+/** Publishes snapshots of any changed windows to the render thread. */
+static MmResult graphics_render_publish() {
+    if (!graphics_render_thread) {
+        // Do not start the render thread until there is something to render.
+        MmSurfaceId id = 0;
+        while (id <= GRAPHICS_MAX_ID && graphics_surfaces[id].type != kGraphicsWindow) id++;
+        if (id > GRAPHICS_MAX_ID) return kOk;
+        ON_FAILURE_RETURN(graphics_render_start());
+    }
+
+    MmResult result = kOk;
+    bool published = false;
+    SDL_LockMutex(graphics_render_mutex);
+    graphics_render_cmm2 = graphics_is_cmm2_display();
+    graphics_render_cmm2_background = graphics_cmm2_background;
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID && SUCCEEDED(result); ++id) {
+        MmSurface *s = &graphics_surfaces[id];
+        if (s->type == kGraphicsWindow) {
+            // Window must be shown before the render thread calls SDL_RenderPresent().
+            if (SDL_GetWindowFlags(s->window) & SDL_WINDOW_HIDDEN) {
+                SDL_ShowWindow(s->window);
+                SDL_RaiseWindow(s->window);
             }
+        } else if (!(id == 1 && graphics_render_cmm2 && s->type == kGraphicsBuffer)) {
+            continue;
+        }
+        if (!s->dirty && graphics_render_frames[id].pixels) continue;
+        result = graphics_render_snapshot(s);
+        published = true;
+    }
+    if (published) {
+        graphics_render_published++;
+        SDL_CondSignal(graphics_render_cond_published);
+    }
+    SDL_UnlockMutex(graphics_render_mutex);
+
+    return result;
+}
+
+/** Presents any changed windows on the interpreter thread. */
+static MmResult graphics_render_inline() {
+    graphics_render_stop();
+
+    // Renderers are created on demand, e.g. after switching from kRenderThread.
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+        MmSurface* s = &graphics_surfaces[id];
+        if (s->type == kGraphicsWindow && !s->renderer) {
+            SDL_Renderer *renderer;
+            SDL_Texture *texture;
+            ON_FAILURE_RETURN(graphics_create_renderer(s->window, s->width, s->height,
+                                                       mmb_options.vsync, &renderer, &texture));
+            s->renderer = renderer;
+            s->texture = texture;
+            graphics_surface_dirty_all(s);
         }
-        // frameEnd = SDL_GetTicks64() + 15;
-        frameEnd = SDL_GetTicks() + 15;
+    }
+
+    switch (mmb_options.simulate) {
+        case kSimulateCmm2:
+        case kSimulateMmb4w:
+            ON_FAILURE_RETURN(graphics_refresh_cmm2_window());
+            break;
+        default:
+            break;
+    }
+
+    // TODO: Optimise by using linked-list of windows.
+    for (int id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+        MmSurface* s = &graphics_surfaces[id];
+        if (s->type == kGraphicsWindow && s->dirty) {
+            graphics_update_texture((SDL_Texture *) s->texture, s);
+            SDL_RenderCopy((SDL_Renderer *) s->renderer, (SDL_Texture *) s->texture, NULL,
+                           NULL);
+
+            // Window must be shown before calling SDL_RenderPresent().
+            if (SDL_GetWindowFlags(s->window) & SDL_WINDOW_HIDDEN) {
+                SDL_ShowWindow(s->window);
+                SDL_RaiseWindow(s->window);
+            }
+
+            SDL_RenderPresent((SDL_Renderer *) s->renderer);
+        }
+    }
+
+    return kOk;
+}
+
+static MmResult graphics_refresh_windows_now() {
+    switch (mmb_options.simulate) {
+        case kSimulateGameMite:
+            ON_FAILURE_RETURN(graphics_refresh_gamemite_window());
+            break;
+        case kSimulatePicoMiteVga:
+            ON_FAILURE_RETURN(graphics_refresh_picomite_vga_window());
+            break;
+        default:
+            break;
+    }
+
+    // frameEnd = SDL_GetTicks64() + 15;
+    frameEnd = SDL_GetTicks() + 15;
+
+    return mmb_options.render == kRenderThread
+            ? graphics_render_publish()
+            : graphics_render_inline();
+}
+
+void graphics_refresh_windows() {
+    // if (SDL_GetTicks64() > frameEnd) {
+    if (SDL_GetTicks() > frameEnd) {
+        ON_FAILURE_ERROR(graphics_refresh_windows_now());
+    }
+}
+
+MmResult graphics_sync(bool wait) {
+    if (mmb_options.render != kRenderThread) return kOk;
+
+    ON_FAILURE_RETURN(graphics_refresh_windows_now());
+    if (!wait) return kOk;
+
+    SDL_LockMutex(graphics_render_mutex);
+    const uint64_t target = graphics_render_published;
+    const uint32_t deadline = SDL_GetTicks() + GRAPHICS_RENDER_SYNC_TIMEOUT_MS;
+    while (graphics_render_presented < target && SDL_GetTicks() < deadline) {
+        SDL_CondWaitTimeout(graphics_render_cond_presented, graphics_render_mutex,
+                            GRAPHICS_RENDER_SYNC_TIMEOUT_MS);
+    }
+    SDL_UnlockMutex(graphics_render_mutex);
+
+    return kOk;
+}
+
+void graphics_reset_renderers() {
+    graphics_render_stop();
+    graphics_destroy_inline_renderers();
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) {
+        MmSurface *s = &graphics_surfaces[id];
+        if (s->type == kGraphicsWindow) graphics_surface_dirty_all(s);
     }
 }
 
@@ -520,37 +907,21 @@ MmResult graphics_window_create(MmSurfaceId id, int width, int height, int x, in
         if (!window) result = kGraphicsApiError;
     }
 
-    // Create SDL renderer with V-Sync enabled.
+    // Create SDL renderer and texture; for kRenderThread these are instead created on
+    // demand by the render thread.
     SDL_Renderer *renderer = NULL;
-    if (SUCCEEDED(result)) {
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
-        if (!renderer) result = kGraphicsApiError;
-    }
-
-    // Create SDL streaming texture.
     SDL_Texture *texture = NULL;
-    if (SUCCEEDED(result)) {
-        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
-                                    SDL_TEXTUREACCESS_STREAMING, width, height);
-        if (!texture) result = kGraphicsApiError;
+    if (SUCCEEDED(result) && mmb_options.render == kRenderInline) {
+        result = graphics_create_renderer(window, width, height, mmb_options.vsync, &renderer,
+                                          &texture);
     }
 
-    if (SUCCEEDED(result)) {
-        result = SUCCEEDED(SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE))
-                ? kOk : kGraphicsApiError;
-    }
-
-    if (SUCCEEDED(result)) {
-        result = SUCCEEDED(SDL_RenderClear(renderer)) ? kOk : kGraphicsApiError;
-    }
-
-    if (SUCCEEDED(result)) SDL_RenderPresent(renderer);
-
     if (SUCCEEDED(result)) {
         s->window = window;
         s->renderer = renderer;
         s->texture = texture;
         s->interrupt_addr = interrupt_addr;
+        graphics_surface_dirty_all(s); // The texture starts uninitialised.
     } else {
         SDL_DestroyTexture((SDL_Texture *) s->texture);
         s->texture = NULL;
@@ -577,6 +948,15 @@ MmResult graphics_surface_destroy(MmSurface *surface) {
     //       is currently rendered to a surface other than 'graphic_current'.
     if (surface->type == kGraphicsSprite) (void) sprite_hide(surface);
 
+    // The render thread has snapshots of the windows and CMM2 page 1.
+    if (surface->type == kGraphicsWindow || surface->id == 1) graphics_render_stop();
+
+    // The CMM2 page 1 texture belongs to the renderer for window 0 and mirrors page 1.
+    if (graphics_cmm2_page1_texture && (surface->id == 0 || surface->id == 1)) {
+        SDL_DestroyTexture(graphics_cmm2_page1_texture);
+        graphics_cmm2_page1_texture = NULL;
+    }
+
     SDL_DestroyTexture((SDL_Texture *) surface->texture);
     SDL_DestroyRenderer((SDL_Renderer *) surface->renderer);
     SDL_DestroyWindow((SDL_Window *) surface->window);
@@ -628,7 +1008,7 @@ static inline void graphics_set_pixel_safe(MmSurface *surface, int x, int y, MmG
 
 MmResult graphics_draw_pixel(MmSurface *surface, int x, int y, MmGraphicsColour colour) {
     graphics_set_pixel_safe(surface, x, y, colour);
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, x, y, x, y);
     return kOk;
 }
 
@@ -917,7 +1297,8 @@ MmResult graphics_draw_bitmap(MmSurface *surface, int x1, int y1, int width, int
         }
     }
 
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, x1, y1, x1 + width * scale - 1,
+                                y1 + height * scale - 1);
 
     return kOk;
 }
@@ -1036,6 +1417,15 @@ MmResult graphics_draw_filled_circle(int x, int y, int radius, int r,
 MmResult graphics_draw_circle(MmSurface *surface, int x, int y, int radius, int w,
                               MmGraphicsColour colour, MmGraphicsColour fill, MMFLOAT aspect) {
     if (!surface || surface->type == kGraphicsNone) return kGraphicsInvalidWriteSurface;
+
+    // Bounding box of the outline; the thick and filled cases are drawn using
+    // graphics_draw_rectangle() which marks its own dirty rectangles.
+    const int dirty_rx = max(radius, (int)((MMFLOAT)radius * aspect)) + 1;
+    const int dirty_x1 = x - dirty_rx;
+    const int dirty_y1 = y - radius - 1;
+    const int dirty_x2 = x + dirty_rx;
+    const int dirty_y2 = y + radius + 1;
+
     int a, b, P;
     int A, B;
     int asp;
@@ -1141,7 +1531,7 @@ MmResult graphics_draw_circle(MmSurface *surface, int x, int y, int radius, int
         }
     }
 
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, dirty_x1, dirty_y1, dirty_x2, dirty_y2);
     return kOk;
 }
 
@@ -1153,6 +1543,7 @@ MmResult graphics_draw_line(MmSurface *surface, int x1, int y1, int x2, int y2,
     if (x1 == x2) {
         return graphics_draw_rectangle(surface, x1, y1, x2 + width - 1, y2, colour);  // vert line
     }
+    graphics_surface_dirty_rect(surface, min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2));
     int dx, dy, sx, sy, err, e2;
     dx = abs(x2 - x1);
     sx = x1 < x2 ? 1 : -1;
@@ -1175,7 +1566,6 @@ MmResult graphics_draw_line(MmSurface *surface, int x1, int y1, int x2, int y2,
     }
     graphics_draw_buffered(surface, 0, 0, 0, 1);
     // if (Option.Refresh)Display_Refresh();
-    surface->dirty = true;
 
     return kOk;
 }
@@ -1250,7 +1640,7 @@ MmResult graphics_draw_rectangle(MmSurface *surface, int x1, int y1, int x2, int
     for (int y = y1; y <= y2; y++) {
         for (int x = x1; x <= x2; x++) graphics_set_pixel(surface, x, y, colour);
     }
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, x1, y1, x2, y2);
     return kOk;
 }
 
@@ -1434,7 +1824,7 @@ MmResult graphics_load_bmp(MmSurface *surface, char *filename, int x, int y) {
     if (FAILED(result)) return result;
     spbmp_init(spbmp_file_read_cb, spbmp_set_pixel_cb, spbmp_abort_check_cb);
     SpBmpResult bmp_result = spbmp_load(file_table[fnbr].file_ptr, x, y, surface);
-    surface->dirty = true;
+    graphics_surface_dirty_all(surface);
     if (FAILED(bmp_result)) {
         (void) file_close(fnbr);
         result = kGraphicsLoadBitmapFailed;
@@ -1479,7 +1869,7 @@ MmResult graphics_load_png(MmSurface *surface, char *filename, int x, int y, int
     // optiony = savey;
     upng_free(upng);
     // clearrepeat();
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, x, y, x + w - 1, y + h - 1);
     return kOk;
 }
 
@@ -1649,79 +2039,50 @@ MmResult graphics_blit(int src_x, int src_y, int dst_x, int dst_y, int w, int h,
         src_y = 0;
     }
 
-    uint32_t *src = src_surface->pixels + (src_y * src_surface->width) + src_x;
+    const uint32_t *src = src_surface->pixels + (src_y * src_surface->width) + src_x;
     uint32_t *dst = dst_surface->pixels;
-    int pdelta = 0; // Added to dst after writing each pixel.
     int ldelta = 0; // Added to dst after writing each line.
 
-    dst_surface->dirty = true;
+    // A 'transparent' colour outside the range of uint32_t can never match a pixel.
+    const bool transparency = (flags & kBlitWithTransparency)
+            && transparent >= 0 && transparent <= UINT32_MAX;
 
-    switch (flags & 0x3) {
-        case kBlitNormal: {
-            dst += (dst_y * dst_surface->width) + dst_x;
-            if (flags & kBlitWithTransparency) {
-                pdelta = 1;
-                ldelta = dst_surface->width - w;
-            } else {
-                // Optimised using memcpy.
-                for (int i = 0; i < h; ++i) {
-                    memcpy(dst, src, w << 2);
-                    src += src_surface->width;
-                    dst += dst_surface->width;
-                }
-                // Set height == width == 0 to skip copying by later code.
-                w = 0;
-                h = 0;
-            }
-            break;
-        }
+    graphics_surface_dirty_rect(dst_surface, dst_x, dst_y, dst_x + w - 1, dst_y + h - 1);
 
+    switch (flags & 0x3) {
+        case kBlitNormal:
         case kBlitHorizontalFlip:
-        {
-            dst += (dst_y * dst_surface->width) + dst_x + w - 1;
-            pdelta = -1;
-            ldelta = dst_surface->width + w;
+            dst += (dst_y * dst_surface->width) + dst_x;
+            ldelta = dst_surface->width;
             break;
-        }
 
         case kBlitVerticalFlip:
-        {
-            // TODO: could be optimised using memcpy.
-            dst += ((dst_y + h - 1) * dst_surface->width) + dst_x;
-            pdelta = 1;
-            ldelta = -(dst_surface->width + w);
-            break;
-        }
-
         case kBlitHorizontalFlip | kBlitVerticalFlip:
-        {
-            dst += ((dst_y + h - 1) * dst_surface->width) + dst_x + w - 1;
-            pdelta = -1;
-            ldelta = -(dst_surface->width - w);
+            dst += ((dst_y + h - 1) * dst_surface->width) + dst_x;
+            ldelta = -dst_surface->width;
             break;
-        }
 
         default:
             return kInternalFault;
     }
 
-    // printf("src_surface->pixels: %p\n", src_surface->pixels);
-    // printf("src:                 %p\n", src);
-    // printf("dst_surface->pixels: %p\n", dst_surface->pixels);
-    // printf("dst:                 %p\n", dst);
-    // printf("pdelta:              %d\n", pdelta);
-    // printf("ldelta:              %d\n", ldelta);
-
+    // Each row is copied by a kernel selected for the CPU at runtime.
+    const BlitKernels *kernels = blit_kernels();
     for (int i = 0; i < h; ++i) {
-        for (int j = 0; j < w; ++j) {
-            if ((flags & kBlitWithTransparency) && *src == transparent) {
-                src++;
+        if (flags & kBlitHorizontalFlip) {
+            if (transparency) {
+                kernels->reverse_transparent(dst, src, w, (uint32_t)transparent);
+            } else {
+                kernels->reverse(dst, src, w);
+            }
+        } else {
+            if (transparency) {
+                kernels->copy_transparent(dst, src, w, (uint32_t)transparent);
             } else {
-                *dst = *src++;
+                memcpy(dst, src, w << 2);
             }
-            dst += pdelta;
         }
-        src += src_surface->width - w;
+        src += src_surface->width;
         dst += ldelta;
     }
 
@@ -1747,7 +2108,7 @@ MmResult graphics_blit_memory_compressed(MmSurface *surface, char *data, int x,
         }
     }
 
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, x, y, x + w - 1, y + h - 1);
 
     return kOk;
 }
@@ -1777,7 +2138,7 @@ MmResult graphics_blit_memory_uncompressed(MmSurface *surface, char *data, int x
         }
     }
 
-    surface->dirty = true;
+    graphics_surface_dirty_rect(surface, x, y, x + w - 1, y + h - 1);
 
     return kOk;
 }
@@ -2197,7 +2558,7 @@ MmResult graphics_scroll(MmSurface *surface, int x, int y, MmGraphicsColour fill
                 : graphics_scroll_down(surface, -y, fill);
     }
 
-    if (SUCCEEDED(result)) surface->dirty = true;
+    if (SUCCEEDED(result)) graphics_surface_dirty_all(surface);
     return result;
 }
 
@@ -157,6 +157,16 @@ typedef struct MmSurfaceStruct {
     MmSurfaceId id; 
     GraphicsSurfaceType type;
     bool dirty;
+
+    /**
+     * Inclusive bounding box of the pixels changed since the surface was last refreshed,
+     * only meaningful if 'dirty' is set; use graphics_surface_dirty_rect() to update.
+     */
+    int dirty_x1;
+    int dirty_y1;
+    int dirty_x2;
+    int dirty_y2;
+
     MmWindowPtr window;
     MmRendererPtr renderer;
     MmTexturePtr texture;
@@ -210,6 +220,23 @@ MmSurfaceId graphics_find_window(uint32_t window_id);
 /** Redraws all 'dirty' windows (if the time is right). */
 void graphics_refresh_windows();
 
+/**
+ * Sync point between the interpreter and the render thread, e.g. for FRAMEBUFFER
+ * and PAGE COPY; has no effect unless OPTION RENDER THREAD is set.
+ *
+ * Immediately publishes any changes to the windows to the render thread rather than
+ * waiting for the next periodic refresh.
+ *
+ * @param  wait  if true then also wait for those changes to be presented.
+ */
+MmResult graphics_sync(bool wait);
+
+/**
+ * Discards all SDL renderers so they will be recreated on demand according to the
+ * current OPTION RENDER and OPTION VSYNC settings.
+ */
+void graphics_reset_renderers();
+
 /** Terminates 'graphics' module, closes all windows, frees all resources. */
 MmResult graphics_term();
 
@@ -250,6 +277,40 @@ static inline bool graphics_surface_exists(MmSurfaceId id) {
     return id >= 0 && id <= GRAPHICS_MAX_ID && graphics_surfaces[id].type != kGraphicsNone;
 }
 
+/**
+ * Marks a rectangle of a surface as changed since it was last refreshed.
+ *
+ * The rectangle is clipped to the surface and grows any existing dirty rectangle.
+ *
+ * @param  x1, y1  Top left coordinates (inclusive).
+ * @param  x2, y2  Bottom right coordinates (inclusive).
+ */
+static inline void graphics_surface_dirty_rect(MmSurface *surface, int x1, int y1, int x2,
+                                               int y2) {
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= surface->width) x2 = surface->width - 1;
+    if (y2 >= surface->height) y2 = surface->height - 1;
+    if (x1 > x2 || y1 > y2) return;
+    if (!surface->dirty) {
+        surface->dirty = true;
+        surface->dirty_x1 = x1;
+        surface->dirty_y1 = y1;
+        surface->dirty_x2 = x2;
+        surface->dirty_y2 = y2;
+    } else {
+        if (x1 < surface->dirty_x1) surface->dirty_x1 = x1;
+        if (y1 < surface->dirty_y1) surface->dirty_y1 = y1;
+        if (x2 > surface->dirty_x2) surface->dirty_x2 = x2;
+        if (y2 > surface->dirty_y2) surface->dirty_y2 = y2;
+    }
+}
+
+/** Marks the whole of a surface as changed since it was last refreshed. */
+static inline void graphics_surface_dirty_all(MmSurface *surface) {
+    graphics_surface_dirty_rect(surface, 0, 0, surface->width - 1, surface->height - 1);
+}
+
 /**
  * Blits rectangle from one surface to another.
  *
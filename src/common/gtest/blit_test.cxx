@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 Thomas Hugo Williams
+ * License MIT <https://opensource.org/licenses/MIT>
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h> // Needed for EXPECT_THAT.
+
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+
+#include "../blit.h"
+
+} // extern "C"
+
+#define TRANSPARENT  0xFF00FF00
+#define MAX_WIDTH    67
+
+class BlitTest : public ::testing::TestWithParam<BlitIsa> {
+
+protected:
+
+    void SetUp() override {
+        kernels = blit_kernels_for(GetParam());
+        if (!kernels) GTEST_SKIP() << "Kernels not supported";
+        scalar = blit_kernels_for(kBlitIsaScalar);
+
+        srand(42);
+        src.resize(MAX_WIDTH + 8);
+        dst.resize(MAX_WIDTH + 8);
+        for (size_t i = 0; i < src.size(); ++i) {
+            // Roughly one in three source pixels is transparent.
+            src[i] = (rand() % 3 == 0) ? TRANSPARENT : (uint32_t) rand();
+            dst[i] = (uint32_t) rand();
+        }
+    }
+
+    const BlitKernels *kernels;
+    const BlitKernels *scalar;
+    std::vector<uint32_t> src;
+    std::vector<uint32_t> dst;
+};
+
+TEST_P(BlitTest, CopyTransparent_MatchesScalar) {
+    for (int offset = 0; offset < 4; ++offset) {
+        for (int n = 0; n <= MAX_WIDTH; ++n) {
+            std::vector<uint32_t> expected = dst;
+            std::vector<uint32_t> actual = dst;
+
+            scalar->copy_transparent(expected.data() + 1, src.data() + offset, n, TRANSPARENT);
+            kernels->copy_transparent(actual.data() + 1, src.data() + offset, n, TRANSPARENT);
+
+            EXPECT_THAT(actual, ::testing::ElementsAreArray(expected))
+                << "n = " << n << ", offset = " << offset;
+        }
+    }
+}
+
+TEST_P(BlitTest, Reverse_MatchesScalar) {
+    for (int offset = 0; offset < 4; ++offset) {
+        for (int n = 0; n <= MAX_WIDTH; ++n) {
+            std::vector<uint32_t> expected = dst;
+            std::vector<uint32_t> actual = dst;
+
+            scalar->reverse(expected.data() + 1, src.data() + offset, n);
+            kernels->reverse(actual.data() + 1, src.data() + offset, n);
+
+            EXPECT_THAT(actual, ::testing::ElementsAreArray(expected))
+                << "n = " << n << ", offset = " << offset;
+        }
+    }
+}
+
+TEST_P(BlitTest, ReverseTransparent_MatchesScalar) {
+    for (int offset = 0; offset < 4; ++offset) {
+        for (int n = 0; n <= MAX_WIDTH; ++n) {
+            std::vector<uint32_t> expected = dst;
+            std::vector<uint32_t> actual = dst;
+
+            scalar->reverse_transparent(expected.data() + 1, src.data() + offset, n, TRANSPARENT);
+            kernels->reverse_transparent(actual.data() + 1, src.data() + offset, n, TRANSPARENT);
+
+            EXPECT_THAT(actual, ::testing::ElementsAreArray(expected))
+                << "n = " << n << ", offset = " << offset;
+        }
+    }
+}
+
+TEST_P(BlitTest, Reverse) {
+    const uint32_t in[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    uint32_t out[11] = { 0 };
+
+    kernels->reverse(out, in, 11);
+
+    EXPECT_THAT(out, ::testing::ElementsAre(11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1));
+}
+
+TEST_P(BlitTest, ReverseTransparent) {
+    const uint32_t in[] = { 1, 0, 3, 0, 5, 6, 0, 8, 9, 0, 11 };
+    uint32_t out[11] = { 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99 };
+
+    kernels->reverse_transparent(out, in, 11, 0);
+
+    EXPECT_THAT(out, ::testing::ElementsAre(11, 99, 9, 8, 99, 6, 5, 99, 3, 99, 1));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllIsas, BlitTest,
+    ::testing::Values(kBlitIsaScalar, kBlitIsaSse2, kBlitIsaAvx2, kBlitIsaNeon),
+    [](const ::testing::TestParamInfo<BlitIsa> &info) {
+        switch (info.param) {
+            case kBlitIsaScalar: return "Scalar";
+            case kBlitIsaSse2:   return "Sse2";
+            case kBlitIsaAvx2:   return "Avx2";
+            case kBlitIsaNeon:   return "Neon";
+            default:             return "Unknown";
+        }
+    });
+
+TEST(BlitKernelsTest, SelectsSupportedKernels) {
+    const BlitKernels *kernels = blit_kernels();
+
+    ASSERT_NE(nullptr, kernels);
+    EXPECT_NE(nullptr, kernels->copy_transparent);
+    EXPECT_NE(nullptr, kernels->reverse);
+    EXPECT_NE(nullptr, kernels->reverse_transparent);
+    EXPECT_EQ(kernels, blit_kernels());
+}
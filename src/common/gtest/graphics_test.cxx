@@ -292,6 +292,60 @@ TEST_F(GraphicsTest, Blit_GivenWithTransparency_AndHorizontalFlip_AndVerticalFli
         << format_pixels(dst->pixels, dst->width, dst->height);
 }
 
+// Wide enough to exercise the SIMD kernels and their scalar tails.
+TEST_F(GraphicsTest, Blit_GivenWideSurface_MatchesReference) {
+    const int w = 37;
+    const int h = 5;
+    const uint32_t transparent = 0xFF000000;
+    EXPECT_EQ(kOk, graphics_buffer_create(3, w, h));
+    EXPECT_EQ(kOk, graphics_buffer_create(4, w, h));
+    MmSurface *wide_src = &graphics_surfaces[3];
+    MmSurface *wide_dst = &graphics_surfaces[4];
+
+    const unsigned all_flags[] = {
+        kBlitNormal,
+        kBlitHorizontalFlip,
+        kBlitVerticalFlip,
+        kBlitHorizontalFlip | kBlitVerticalFlip,
+        kBlitWithTransparency,
+        kBlitHorizontalFlip | kBlitWithTransparency,
+        kBlitVerticalFlip | kBlitWithTransparency,
+        kBlitHorizontalFlip | kBlitVerticalFlip | kBlitWithTransparency };
+
+    for (unsigned flags : all_flags) {
+        for (int i = 0; i < w * h; ++i) {
+            wide_src->pixels[i] = (i % 3 == 0) ? transparent : (uint32_t) i;
+            wide_dst->pixels[i] = 0xDEADBEEF;
+        }
+
+        std::vector<uint32_t> expected(wide_dst->pixels, wide_dst->pixels + w * h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const uint32_t pixel = wide_src->pixels[y * w + x];
+                if ((flags & kBlitWithTransparency) && pixel == transparent) continue;
+                const int dx = (flags & kBlitHorizontalFlip) ? w - 1 - x : x;
+                const int dy = (flags & kBlitVerticalFlip) ? h - 1 - y : y;
+                expected[dy * w + dx] = pixel;
+            }
+        }
+
+        EXPECT_EQ(kOk, graphics_blit(0, 0, 0, 0, w, h, wide_src, wide_dst, flags, transparent));
+
+        EXPECT_THAT(std::vector<uint32_t>(wide_dst->pixels, wide_dst->pixels + w * h),
+                    ::testing::ElementsAreArray(expected))
+            << "flags = " << flags << std::endl << format_pixels(wide_dst->pixels, w, h);
+    }
+}
+
+TEST_F(GraphicsTest, Blit_GivenWithTransparency_AndTransparentOutOfRange) {
+    EXPECT_EQ(kOk, graphics_blit(0, 0, 0, 0, 7, 9, src, dst, kBlitWithTransparency, -1));
+
+    EXPECT_THAT(std::vector<uint32_t>(dst->pixels, dst->pixels + dst->width * dst->height),
+                ::testing::ElementsAreArray(DEFAULT_SRC_PIXELS,
+                                            sizeof(DEFAULT_SRC_PIXELS) / sizeof(uint32_t)))
+        << format_pixels(dst->pixels, dst->width, dst->height);
+}
+
 TEST_F(GraphicsTest, Blit_GivenNegativeSourceOffset) {
     EXPECT_EQ(kOk, graphics_blit(-2, -3, 0, 0, 7, 9, src, dst, kBlitNormal, 0));
 
@@ -872,6 +926,58 @@ TEST_F(GraphicsTest, Blit_GivenHorizonalFlip_AndVerticalFlip_AndPositiveSourceOf
         << format_pixels(dst->pixels, dst->width, dst->height);
 }
 
+#define EXPECT_DIRTY_RECT(surface, x1, y1, x2, y2) \
+    EXPECT_TRUE((surface)->dirty); \
+    EXPECT_EQ(x1, (surface)->dirty_x1); \
+    EXPECT_EQ(y1, (surface)->dirty_y1); \
+    EXPECT_EQ(x2, (surface)->dirty_x2); \
+    EXPECT_EQ(y2, (surface)->dirty_y2)
+
+TEST_F(GraphicsTest, DirtyRect_GivenDrawPixel) {
+    dst->dirty = false;
+
+    EXPECT_EQ(kOk, graphics_draw_pixel(dst, 3, 4, RGB_WHITE));
+    EXPECT_DIRTY_RECT(dst, 3, 4, 3, 4);
+
+    EXPECT_EQ(kOk, graphics_draw_pixel(dst, 1, 6, RGB_WHITE));
+    EXPECT_DIRTY_RECT(dst, 1, 4, 3, 6);
+}
+
+TEST_F(GraphicsTest, DirtyRect_GivenDrawPixel_OffSurface) {
+    dst->dirty = false;
+
+    EXPECT_EQ(kOk, graphics_draw_pixel(dst, -1, 4, RGB_WHITE));
+    EXPECT_FALSE(dst->dirty);
+}
+
+TEST_F(GraphicsTest, DirtyRect_GivenBlit) {
+    dst->dirty = false;
+
+    EXPECT_EQ(kOk, graphics_blit(0, 0, 2, 3, 3, 2, src, dst, kBlitNormal, 0));
+    EXPECT_DIRTY_RECT(dst, 2, 3, 4, 4);
+}
+
+TEST_F(GraphicsTest, DirtyRect_GivenBlit_ClippedByDestination) {
+    dst->dirty = false;
+
+    EXPECT_EQ(kOk, graphics_blit(0, 0, 5, 7, 7, 9, src, dst, kBlitNormal, 0));
+    EXPECT_DIRTY_RECT(dst, 5, 7, 6, 8);
+}
+
+TEST_F(GraphicsTest, DirtyRect_GivenDrawRectangle_ClippedBySurface) {
+    dst->dirty = false;
+
+    EXPECT_EQ(kOk, graphics_draw_rectangle(dst, -2, 1, 3, 20, RGB_WHITE));
+    EXPECT_DIRTY_RECT(dst, 0, 1, 3, 8);
+}
+
+TEST_F(GraphicsTest, DirtyRect_GivenDirtyAll) {
+    dst->dirty = false;
+
+    graphics_surface_dirty_all(dst);
+    EXPECT_DIRTY_RECT(dst, 0, 0, 6, 8);
+}
+
 TEST_F(GraphicsTest, GetDefaultWindowTitle_GivenNoCurrentFile) {
     char title[STRINGSIZE];
     CurrentFile[0] = '\0';
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2026 Thomas Hugo Williams
+ * License MIT <https://opensource.org/licenses/MIT>
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+
+#include "../mmb4l.h"
+#include "../memory.h"
+#include "stubs/error_stubs.h"
+
+int LocalIndex = 0;
+
+MMINTEGER getinteger(const char *p) { return 0; }
+
+// Defined in "common/audio.c"
+const char *audio_last_error() { return ""; }
+
+// Defined in "common/events.c"
+const char *events_last_error() { return ""; }
+
+// Defined in "common/gamepad.c"
+const char *gamepad_last_error() { return ""; }
+
+// Defined in "common/graphics.c"
+const char *graphics_last_error() { return ""; }
+
+// Defined in "common/memory.c"
+extern char MMHeap[];
+extern uint32_t mmap[];
+unsigned int MBitsGet(void *addr);
+void *getheap(int size);
+
+} // extern "C"
+
+#define HEAP_PAGES  (HEAP_SIZE / PAGESIZE)
+
+class MemoryTest : public ::testing::Test {
+
+protected:
+
+    void SetUp() override {
+        LocalIndex = 0;
+        InitHeap();
+        error_msg[0] = '\0';
+    }
+
+    void TearDown() override {
+    }
+
+};
+
+TEST_F(MemoryTest, GetMemory_AllocatesFromTopOfHeap) {
+    char *p1 = (char *) GetMemory(10);
+    char *p2 = (char *) GetMemory(PAGESIZE + 1);
+
+    EXPECT_EQ(RAMEND - PAGESIZE, p1);
+    EXPECT_EQ(RAMEND - 3 * PAGESIZE, p2);
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MemoryTest, GetMemory_ZeroesMemory) {
+    char *p1 = (char *) GetMemory(STRINGSIZE);
+    memset(p1, 0xFF, STRINGSIZE);
+    FreeMemory(p1);
+
+    char *p2 = (char *) GetMemory(STRINGSIZE);
+
+    EXPECT_EQ(p1, p2);
+    for (int i = 0; i < STRINGSIZE; ++i) EXPECT_EQ(0, p2[i]);
+}
+
+TEST_F(MemoryTest, GetMemory_ReusesFreedBlockOfSameSize) {
+    char *p1 = (char *) GetMemory(3 * PAGESIZE);
+    (void) GetMemory(PAGESIZE);
+    char *p2 = (char *) GetMemory(PAGESIZE);
+    (void) GetMemory(PAGESIZE);
+    FreeMemory(p1);
+    FreeMemory(p2);
+
+    EXPECT_EQ(p2, GetMemory(PAGESIZE));
+    EXPECT_EQ(p1, GetMemory(3 * PAGESIZE));
+}
+
+TEST_F(MemoryTest, GetMemory_GivenOutOfMemory) {
+    EXPECT_EQ(NULL, GetMemory(HEAP_SIZE));
+    EXPECT_STREQ("Not enough memory", error_msg);
+}
+
+TEST_F(MemoryTest, GetMemory_GivenWholeHeap) {
+    char *p = (char *) GetMemory(HEAP_SIZE - PAGESIZE);
+
+    EXPECT_EQ(MMHeap + PAGESIZE, p);
+    EXPECT_EQ(0, FreeSpaceOnHeap());
+    EXPECT_EQ(NULL, GetMemory(1));
+    EXPECT_STREQ("Not enough memory", error_msg);
+}
+
+TEST_F(MemoryTest, FreeMemory_CoalescesWithNeighbours) {
+    void *p1 = GetMemory(PAGESIZE);
+    void *p2 = GetMemory(2 * PAGESIZE);
+    void *p3 = GetMemory(3 * PAGESIZE);
+    FreeMemory(p1);
+    FreeMemory(p3);
+    FreeMemory(p2);
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(MMHeap + PAGESIZE, GetMemory(HEAP_SIZE - PAGESIZE));
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MemoryTest, FreeMemory_GivenNotAllocated) {
+    void *p1 = GetMemory(PAGESIZE);
+    void *p2 = GetMemory(PAGESIZE);
+    FreeMemory(p2);
+
+    FreeMemory(p2);
+    FreeMemory(NULL);
+
+    EXPECT_EQ(PAGESIZE, UsedHeap());
+    EXPECT_EQ(PUSED | PLAST, MBitsGet(p1));
+}
+
+TEST_F(MemoryTest, UsedHeapAndFreeSpaceOnHeap) {
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(HEAP_SIZE - PAGESIZE, FreeSpaceOnHeap());
+
+    void *p1 = GetMemory(1);
+    void *p2 = GetMemory(PAGESIZE * 4 + 1);
+
+    EXPECT_EQ(6 * PAGESIZE, UsedHeap());
+    EXPECT_EQ(HEAP_SIZE - 7 * PAGESIZE, FreeSpaceOnHeap());
+
+    FreeMemory(p1);
+    FreeMemory(p2);
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(HEAP_SIZE - PAGESIZE, FreeSpaceOnHeap());
+}
+
+TEST_F(MemoryTest, GetTempMemory_AllocatesFromArena) {
+    char *p1 = (char *) GetTempStrMemory();
+    char *p2 = (char *) GetTempMemory(10);
+    char *p3 = (char *) GetTempMemory(10);
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(p1 + STRINGSIZE, p2);
+    EXPECT_EQ(p2 + 16, p3);
+    for (int i = 0; i < STRINGSIZE; ++i) EXPECT_EQ(0, p1[i]);
+    EXPECT_EQ(true, TempMemoryIsChanged);
+}
+
+TEST_F(MemoryTest, GetTempMemory_ZeroesArenaMemory) {
+    char *p1 = (char *) GetTempStrMemory();
+    memset(p1, 0xFF, STRINGSIZE);
+    ClearTempMemory();
+
+    char *p2 = (char *) GetTempStrMemory();
+
+    EXPECT_EQ(p1, p2);
+    for (int i = 0; i < STRINGSIZE; ++i) EXPECT_EQ(0, p2[i]);
+}
+
+TEST_F(MemoryTest, GetTempMemory_GivenLargerThanArenaChunk) {
+    char *p1 = (char *) GetTempMemory(TEMP_ARENA_CHUNK_SIZE + 1);
+
+    EXPECT_EQ(PUSED, MBitsGet(p1));
+    EXPECT_EQ(p1, StrTmp[0]);
+    EXPECT_EQ(TEMP_ARENA_CHUNK_SIZE + PAGESIZE, UsedHeap());
+
+    ClearTempMemory();
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(NULL, StrTmp[0]);
+}
+
+TEST_F(MemoryTest, GetTempMemory_GivenArenaExhausted) {
+    const int count = TEMP_ARENA_CHUNKS * (TEMP_ARENA_CHUNK_SIZE / STRINGSIZE);
+    for (int i = 0; i < count; ++i) (void) GetTempStrMemory();
+    EXPECT_EQ(0, UsedHeap());
+
+    char *p1 = (char *) GetTempStrMemory();
+
+    EXPECT_EQ(PUSED | PLAST, MBitsGet(p1));
+    EXPECT_EQ(STRINGSIZE, UsedHeap());
+
+    ClearTempMemory();
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MemoryTest, GetTempMemory_GivenAllocationAtCallersLevel) {
+    LocalIndex = 1;
+    char *p1 = (char *) GetTempStrMemory();
+    LocalIndex = 0;
+    char *p2 = (char *) GetTempStrMemory();
+    LocalIndex = 1;
+    char *p3 = (char *) GetTempStrMemory();
+
+    EXPECT_EQ(p1 + STRINGSIZE, p3);
+
+    ClearTempMemory();
+    LocalIndex = 0;
+
+    // Only the level 1 chunk was released.
+    EXPECT_EQ(p2 + STRINGSIZE, GetTempStrMemory());
+
+    ClearTempMemory();
+}
+
+TEST_F(MemoryTest, ClearTempMemory) {
+    char *p1 = (char *) GetTempStrMemory();
+    LocalIndex = 1;
+    char *p2 = (char *) GetTempStrMemory();
+    char *p3 = (char *) GetTempMemory(TEMP_ARENA_CHUNK_SIZE + 1);
+
+    ClearTempMemory();
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(0, MBitsGet(p3));
+    EXPECT_EQ(false, TempMemoryIsChanged);
+    EXPECT_EQ(p2, GetTempStrMemory());
+
+    LocalIndex = 0;
+    EXPECT_EQ(p1 + STRINGSIZE, GetTempStrMemory());
+    ClearTempMemory();
+
+    EXPECT_EQ(p1, GetTempStrMemory());
+}
+
+TEST_F(MemoryTest, ClearSpecificTempMemory_GivenMostRecentArenaAllocation) {
+    char *p1 = (char *) GetTempStrMemory();
+    char *p2 = (char *) GetTempStrMemory();
+
+    ClearSpecificTempMemory(p2);
+
+    EXPECT_EQ(p2, GetTempStrMemory());
+
+    // Earlier allocations are only reclaimed by ClearTempMemory().
+    ClearSpecificTempMemory(p1);
+
+    EXPECT_EQ(p2 + STRINGSIZE, GetTempStrMemory());
+}
+
+TEST_F(MemoryTest, ClearSpecificTempMemory_GivenHeapAllocation) {
+    char *p1 = (char *) GetTempMemory(TEMP_ARENA_CHUNK_SIZE + 1);
+
+    ClearSpecificTempMemory(p1);
+
+    EXPECT_EQ(0, UsedHeap());
+    EXPECT_EQ(NULL, StrTmp[0]);
+}
+
+TEST_F(MemoryTest, ReAllocMemory_GivenSameNumberOfPages) {
+    char *p1 = (char *) GetMemory(10);
+
+    EXPECT_EQ(p1, ReAllocMemory(p1, PAGESIZE));
+    EXPECT_EQ(PAGESIZE, UsedHeap());
+}
+
+TEST_F(MemoryTest, ReAllocMemory_GivenFreeSpaceAbove_GrowsInPlace) {
+    char *p1 = (char *) GetMemory(PAGESIZE);
+    char *p2 = (char *) GetMemory(PAGESIZE);
+    memset(p2, 0xAB, PAGESIZE);
+    FreeMemory(p1);
+
+    char *p3 = (char *) ReAllocMemory(p2, 2 * PAGESIZE);
+
+    EXPECT_EQ(p2, p3);
+    EXPECT_EQ(2 * PAGESIZE, UsedHeap());
+    EXPECT_EQ(PUSED, MBitsGet(p3));
+    EXPECT_EQ(PUSED | PLAST, MBitsGet(p3 + PAGESIZE));
+    for (int i = 0; i < PAGESIZE; ++i) EXPECT_EQ((char) 0xAB, p3[i]);
+    for (int i = PAGESIZE; i < 2 * PAGESIZE; ++i) EXPECT_EQ(0, p3[i]);
+}
+
+TEST_F(MemoryTest, ReAllocMemory_GivenNoFreeSpaceAbove_MovesAndCopies) {
+    char *p1 = (char *) GetMemory(PAGESIZE);
+    (void) GetMemory(PAGESIZE);
+    memset(p1, 0xAB, PAGESIZE);
+
+    char *p2 = (char *) ReAllocMemory(p1, 2 * PAGESIZE);
+
+    EXPECT_NE(p1, p2);
+    EXPECT_EQ(3 * PAGESIZE, UsedHeap());
+    EXPECT_EQ(0, MBitsGet(p1));
+    for (int i = 0; i < PAGESIZE; ++i) EXPECT_EQ((char) 0xAB, p2[i]);
+    for (int i = PAGESIZE; i < 2 * PAGESIZE; ++i) EXPECT_EQ(0, p2[i]);
+}
+
+TEST_F(MemoryTest, ReAllocMemory_GivenRepeatedGrowth_DoesNotMove) {
+    (void) GetMemory(PAGESIZE);
+    char *p1 = (char *) ReAllocMemory(NULL, 100);
+    (void) GetMemory(PAGESIZE);
+
+    for (size_t sz = 200; sz <= 64 * 1024; sz += 100) {
+        EXPECT_EQ(p1, ReAllocMemory(p1, sz));
+    }
+    EXPECT_EQ(2 * PAGESIZE + 64 * 1024, UsedHeap());
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MemoryTest, ReAllocMemory_GivenSmallerSize_ShrinksInPlace) {
+    char *p1 = (char *) GetMemory(4 * PAGESIZE);
+    memset(p1, 0xAB, 4 * PAGESIZE);
+
+    EXPECT_EQ(p1, ReAllocMemory(p1, PAGESIZE));
+    EXPECT_EQ(PAGESIZE, UsedHeap());
+    EXPECT_EQ(PUSED | PLAST, MBitsGet(p1));
+    EXPECT_EQ(0, MBitsGet(p1 + PAGESIZE));
+    for (int i = 0; i < PAGESIZE; ++i) EXPECT_EQ((char) 0xAB, p1[i]);
+
+    // The released tail pages are reusable.
+    EXPECT_EQ(p1 + PAGESIZE, GetMemory(3 * PAGESIZE));
+}
+
+TEST_F(MemoryTest, ReAllocMemory_GivenNull) {
+    EXPECT_EQ(NULL, ReAllocMemory(NULL, 0));
+
+    char *p1 = (char *) ReAllocMemory(NULL, 10);
+
+    EXPECT_EQ(MMHeap + PAGESIZE, p1);
+    EXPECT_EQ(PAGESIZE, UsedHeap());
+}
+
+/*
+ * Reference implementation of the original allocator that scanned the page bitmap
+ * from RAMEND downward on every allocation; used for benchmarking.
+ */
+static uint32_t legacy_mmap[HEAP_PAGES / PAGESPERWORD + 1];
+
+static unsigned int legacy_bits_get(uint32_t page) {
+    return (legacy_mmap[page / PAGESPERWORD] >> ((page & (PAGESPERWORD - 1)) * PAGEBITS)) & ((1 << PAGEBITS) - 1);
+}
+
+static void legacy_bits_set(uint32_t page, unsigned int bits) {
+    uint32_t *p = &legacy_mmap[page / PAGESPERWORD];
+    unsigned int i = (page & (PAGESPERWORD - 1)) * PAGEBITS;
+    *p = (bits << i) | (*p & (~(((1 << PAGEBITS) - 1) << i)));
+}
+
+static void *legacy_getheap(int size) {
+    unsigned int j, n;
+    j = n = (size + PAGESIZE - 1) / PAGESIZE;
+    for (uint32_t page = HEAP_PAGES - 1; page > 0; page--) {
+        if (!(legacy_bits_get(page) & PUSED)) {
+            if (--n == 0) {
+                j--;
+                legacy_bits_set(page + j, PUSED | PLAST);
+                while (j--) legacy_bits_set(page + j, PUSED);
+                memset(MMHeap + page * PAGESIZE, 0, size);
+                return MMHeap + page * PAGESIZE;
+            }
+        } else {
+            n = j;
+        }
+    }
+    return NULL;
+}
+
+static void legacy_free(void *addr) {
+    uint32_t page = ((char *) addr - MMHeap) / PAGESIZE;
+    unsigned int bits;
+    do {
+        bits = legacy_bits_get(page);
+        legacy_bits_set(page, 0);
+        page++;
+    } while (bits != (PUSED | PLAST));
+}
+
+static unsigned int legacy_used_heap() {
+    unsigned int nbr = 0;
+    for (uint32_t page = HEAP_PAGES - 1; page > 0; page--) {
+        if (legacy_bits_get(page) & PUSED) nbr++;
+    }
+    return nbr * PAGESIZE;
+}
+
+#define BENCHMARK_LIVE_BLOCKS  1024
+#define BENCHMARK_ITERATIONS   100000
+
+/**
+ * Simulates a string heavy program: a pool of live blocks, mostly single STRINGSIZE
+ * pages with occasional small arrays, is churned by freeing a pseudo-random block and
+ * allocating a replacement.
+ */
+template <typename GetFn, typename FreeFn>
+static double run_allocation_benchmark(GetFn get_fn, FreeFn free_fn) {
+    void *live[BENCHMARK_LIVE_BLOCKS];
+    uint32_t seed = 12345;
+    auto next_random = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7FFF; };
+    auto next_size = [&next_random]() {
+        return (next_random() % 8 == 0) ? (int) (next_random() % (8 * PAGESIZE)) + 1 : STRINGSIZE;
+    };
+
+    for (int i = 0; i < BENCHMARK_LIVE_BLOCKS; ++i) live[i] = get_fn(next_size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; ++i) {
+        int idx = next_random() % BENCHMARK_LIVE_BLOCKS;
+        free_fn(live[idx]);
+        live[idx] = get_fn(next_size());
+        if (!live[idx]) return -1.0;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+TEST_F(MemoryTest, Benchmark_CompareWithBitmapScan) {
+    memset(legacy_mmap, 0, sizeof(legacy_mmap));
+    double legacy_secs = run_allocation_benchmark(legacy_getheap, legacy_free);
+    unsigned int legacy_used = legacy_used_heap();
+
+    InitHeap();
+    double new_secs = run_allocation_benchmark(GetMemory, FreeMemory);
+
+    ASSERT_GT(legacy_secs, 0.0);
+    ASSERT_GT(new_secs, 0.0);
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(legacy_used, UsedHeap());
+
+    std::cout << "[ BENCHMARK] " << BENCHMARK_ITERATIONS << " free/allocate pairs with "
+              << BENCHMARK_LIVE_BLOCKS << " live blocks" << std::endl;
+    std::cout << "[ BENCHMARK]   bitmap scan: " << (BENCHMARK_ITERATIONS / legacy_secs) << " ops/s" << std::endl;
+    std::cout << "[ BENCHMARK]   free lists:  " << (BENCHMARK_ITERATIONS / new_secs) << " ops/s" << std::endl;
+}
@@ -82,9 +82,12 @@ static void expect_options_have_defaults(Options *options) {
     EXPECT_STREQ("", options->fn_keys[11]);
     EXPECT_EQ(0, options->height);
     EXPECT_EQ(kTitle, options->list_case);
+    EXPECT_EQ(kRenderInline, options->render);
     EXPECT_EQ(kCharacter, options->resolution);
     EXPECT_STREQ("", options->search_path);
+    EXPECT_EQ(true, options->serial_blocking);
     EXPECT_EQ(4, options->tab);
+    EXPECT_EQ(true, options->vsync);
     EXPECT_EQ(0, options->width);
     EXPECT_EQ(true, options->zboolean);
     EXPECT_EQ(2.71828, options->zfloat);
@@ -664,18 +667,27 @@ TEST_F(OptionsTest, GetDisplayValue) {
     EXPECT_EQ(kOk, options_get_display_value(&options, kOptionF11, svalue));
     EXPECT_STREQ("<unset>", svalue);
 
+    EXPECT_EQ(kOk, options_get_display_value(&options, kOptionRender, svalue));
+    EXPECT_STREQ("Inline", svalue);
+
     EXPECT_EQ(kOk, options_get_display_value(&options, kOptionResolution, svalue));
     EXPECT_STREQ("Character", svalue);
 
     EXPECT_EQ(kOk, options_get_display_value(&options, kOptionSearchPath, svalue));
     EXPECT_STREQ("<unset>", svalue);
 
+    EXPECT_EQ(kOk, options_get_display_value(&options, kOptionSerialBlocking, svalue));
+    EXPECT_STREQ("On", svalue);
+
     EXPECT_EQ(kOk, options_get_display_value(&options, kOptionSimulate, svalue));
     EXPECT_STREQ("MMB4L", svalue);
 
     EXPECT_EQ(kOk, options_get_display_value(&options, kOptionTab, svalue));
     EXPECT_STREQ("4", svalue);
 
+    EXPECT_EQ(kOk, options_get_display_value(&options, kOptionVSync, svalue));
+    EXPECT_STREQ("On", svalue);
+
     EXPECT_EQ(kOk, options_get_display_value(&options, kOptionZBoolean, svalue));
     EXPECT_STREQ("On", svalue);
 
@@ -831,6 +843,20 @@ TEST_F(OptionsTest, GetIntegerValue_ForBreakKey) {
     EXPECT_EQ(4, ivalue);
 }
 
+TEST_F(OptionsTest, GetIntegerValue_ForSerialBlocking) {
+    Options options;
+    options_init(&options);
+    MMINTEGER ivalue = 0;
+
+    options.serial_blocking = 0;
+    EXPECT_EQ(kOk, options_get_integer_value(&options, kOptionSerialBlocking, &ivalue));
+    EXPECT_EQ(0, ivalue);
+
+    options.serial_blocking = 1;
+    EXPECT_EQ(kOk, options_get_integer_value(&options, kOptionSerialBlocking, &ivalue));
+    EXPECT_EQ(1, ivalue);
+}
+
 TEST_F(OptionsTest, GetIntegerValue_ForTab) {
     Options options;
     options_init(&options);
@@ -845,6 +871,20 @@ TEST_F(OptionsTest, GetIntegerValue_ForTab) {
     EXPECT_EQ(8, ivalue);
 }
 
+TEST_F(OptionsTest, GetIntegerValue_ForVSync) {
+    Options options;
+    options_init(&options);
+    MMINTEGER ivalue = 0;
+
+    options.vsync = 0;
+    EXPECT_EQ(kOk, options_get_integer_value(&options, kOptionVSync, &ivalue));
+    EXPECT_EQ(0, ivalue);
+
+    options.vsync = 1;
+    EXPECT_EQ(kOk, options_get_integer_value(&options, kOptionVSync, &ivalue));
+    EXPECT_EQ(1, ivalue);
+}
+
 TEST_F(OptionsTest, GetIntegerValue_ForZBoolean) {
     Options options;
     options_init(&options);
@@ -1095,6 +1135,20 @@ TEST_F(OptionsTest, GetStringValue_ForListCase) {
     EXPECT_STREQ("Upper", svalue);
 }
 
+TEST_F(OptionsTest, GetStringValue_ForRender) {
+    Options options;
+    options_init(&options);
+    char svalue[STRINGSIZE];
+
+    options.render = kRenderInline;
+    EXPECT_EQ(kOk, options_get_string_value(&options, kOptionRender, svalue));
+    EXPECT_STREQ("Inline", svalue);
+
+    options.render = kRenderThread;
+    EXPECT_EQ(kOk, options_get_string_value(&options, kOptionRender, svalue));
+    EXPECT_STREQ("Thread", svalue);
+}
+
 TEST_F(OptionsTest, GetStringValue_ForResolution) {
     Options options;
     options_init(&options);
@@ -1123,6 +1177,20 @@ TEST_F(OptionsTest, GetStringValue_ForSearchPath) {
     EXPECT_STREQ((m_home + "/foo").c_str(), svalue);
 }
 
+TEST_F(OptionsTest, GetStringValue_ForSerialBlocking) {
+    Options options;
+    options_init(&options);
+    char svalue[STRINGSIZE];
+
+    options.serial_blocking = 0;
+    EXPECT_EQ(kOk, options_get_string_value(&options, kOptionSerialBlocking, svalue));
+    EXPECT_STREQ("Off", svalue);
+
+    options.serial_blocking = 1;
+    EXPECT_EQ(kOk, options_get_string_value(&options, kOptionSerialBlocking, svalue));
+    EXPECT_STREQ("On", svalue);
+}
+
 TEST_F(OptionsTest, GetStringValue_ForSimulate) {
     Options options;
     options_init(&options);
@@ -1163,6 +1231,20 @@ TEST_F(OptionsTest, GetStringValue_ForTab) {
     EXPECT_STREQ("8", svalue);
 }
 
+TEST_F(OptionsTest, GetStringValue_ForVSync) {
+    Options options;
+    options_init(&options);
+    char svalue[STRINGSIZE];
+
+    options.vsync = 0;
+    EXPECT_EQ(kOk, options_get_string_value(&options, kOptionVSync, svalue));
+    EXPECT_STREQ("Off", svalue);
+
+    options.vsync = 1;
+    EXPECT_EQ(kOk, options_get_string_value(&options, kOptionVSync, svalue));
+    EXPECT_STREQ("On", svalue);
+}
+
 TEST_F(OptionsTest, GetStringValue_ForZBoolean) {
     Options options;
     options_init(&options);
@@ -1270,6 +1352,19 @@ TEST_F(OptionsTest, SetIntegerValue_ForBreakKey) {
     EXPECT_EQ(kInvalidValue, options_set_integer_value(&options, kOptionBreakKey, 256));
 }
 
+TEST_F(OptionsTest, SetIntegerValue_ForSerialBlocking) {
+    Options options;
+    options_init(&options);
+
+    EXPECT_EQ(kOk, options_set_integer_value(&options, kOptionSerialBlocking, 0));
+    EXPECT_EQ(0, options.serial_blocking);
+
+    EXPECT_EQ(kOk, options_set_integer_value(&options, kOptionSerialBlocking, 1));
+    EXPECT_EQ(1, options.serial_blocking);
+
+    EXPECT_EQ(kInvalidValue, options_set_integer_value(&options, kOptionSerialBlocking, 2));
+}
+
 TEST_F(OptionsTest, SetIntegerValue_ForTab) {
     Options options;
     options_init(&options);
@@ -1283,6 +1378,19 @@ TEST_F(OptionsTest, SetIntegerValue_ForTab) {
     EXPECT_EQ(kInvalidValue, options_set_integer_value(&options, kOptionTab, 3));
 }
 
+TEST_F(OptionsTest, SetIntegerValue_ForVSync) {
+    Options options;
+    options_init(&options);
+
+    EXPECT_EQ(kOk, options_set_integer_value(&options, kOptionVSync, 0));
+    EXPECT_EQ(0, options.vsync);
+
+    EXPECT_EQ(kOk, options_set_integer_value(&options, kOptionVSync, 1));
+    EXPECT_EQ(1, options.vsync);
+
+    EXPECT_EQ(kInvalidValue, options_set_integer_value(&options, kOptionVSync, 2));
+}
+
 TEST_F(OptionsTest, SetIntegerValue_ForZBoolean) {
     Options options;
     options_init(&options);
@@ -1586,6 +1694,23 @@ TEST_F(OptionsTest, SetStringValue_ForListCase) {
     EXPECT_EQ(kInvalidValue, options_set_string_value(&options, kOptionListCase, "wombat"));
 }
 
+TEST_F(OptionsTest, SetStringValue_ForRender) {
+    Options options;
+    options_init(&options);
+
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionRender, "Inline"));
+    EXPECT_EQ(kRenderInline, options.render);
+
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionRender, "Thread"));
+    EXPECT_EQ(kRenderThread, options.render);
+
+    // Test case-insensitivity.
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionRender, "INLINE"));
+    EXPECT_EQ(kRenderInline, options.render);
+
+    EXPECT_EQ(kInvalidValue, options_set_string_value(&options, kOptionRender, "wombat"));
+}
+
 TEST_F(OptionsTest, SetStringValue_ForResolution) {
     Options options;
     options_init(&options);
@@ -1636,6 +1761,19 @@ TEST_F(OptionsTest, SetStringValue_ForSearchPath) {
             options_set_string_value(&options, kOptionSearchPath, svalue));
 }
 
+TEST_F(OptionsTest, SetStringValue_ForSerialBlocking) {
+    Options options;
+    options_init(&options);
+
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionSerialBlocking, "Off"));
+    EXPECT_EQ(false, options.serial_blocking);
+
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionSerialBlocking, "On"));
+    EXPECT_EQ(true, options.serial_blocking);
+
+    EXPECT_EQ(kInvalidValue, options_set_string_value(&options, kOptionSerialBlocking, "wombat"));
+}
+
 TEST_F(OptionsTest, SetStringValue_ForSimulate) {
     Options options;
     options_init(&options);
@@ -1685,6 +1823,19 @@ TEST_F(OptionsTest, SetStringValue_ForTab) {
     EXPECT_EQ(kInvalidValue, options_set_string_value(&options, kOptionTab, "wombat"));
 }
 
+TEST_F(OptionsTest, SetStringValue_ForVSync) {
+    Options options;
+    options_init(&options);
+
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionVSync, "Off"));
+    EXPECT_EQ(false, options.vsync);
+
+    EXPECT_EQ(kOk, options_set_string_value(&options, kOptionVSync, "On"));
+    EXPECT_EQ(true, options.vsync);
+
+    EXPECT_EQ(kInvalidValue, options_set_string_value(&options, kOptionVSync, "wombat"));
+}
+
 TEST_F(OptionsTest, SetStringValue_ForZBoolean) {
     Options options;
     options_init(&options);
@@ -35,7 +35,11 @@ int MMgetchar(void) { return 0; }
 // Defined in "commands/cmd_read.c"
 void cmd_read_clear_cache()  { }
 
+// Defined in "functions/fun_json.c"
+void fun_json_clear_cache()  { }
+
 // Defined in "common/console.c"
+void console_flush(void) { }
 int console_kbhit(void) { return 0; }
 char console_putc(char c) { return c; }
 void console_puts(const char *s) { }
@@ -41,7 +41,11 @@ int MMgetchar(void) { return 0; }
 // Defined in "commands/cmd_read.c"
 void cmd_read_clear_cache()  { }
 
+// Defined in "functions/fun_json.c"
+void fun_json_clear_cache()  { }
+
 // Defined in "common/console.c"
+void console_flush(void) { }
 int console_kbhit(void) { return 0; }
 char console_putc(char c) { return c; }
 void console_puts(const char *s) { }
@@ -79,9 +83,9 @@ void ListNewLine(int *ListCnt, int all) { }
 #define CMD_DEFINEFONT  "\x97\x80"
 #define CMD_DIM         "\x99\x80"
 #define CMD_END         "\x9F\x80"
-#define CMD_LET         "\xC0\x80"
-#define CMD_MMDEBUG     "\xCC\x80"
-#define CMD_PRINT       "\xDA\x80"
+#define CMD_LET         "\xC1\x80"
+#define CMD_MMDEBUG     "\xCD\x80"
+#define CMD_PRINT       "\xDB\x80"
 #define OP_EQUALS       "\xF5"
 
 #define EXPECT_PROGRAM_EQ(prog) \
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2026 Thomas Hugo Williams
+ * License MIT <https://opensource.org/licenses/MIT>
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h> // Needed for EXPECT_THAT.
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <thread>
+
+extern "C" {
+
+#include "../rx_ring.h"
+
+}
+
+TEST(RxRingTest, Init) {
+    char data[16] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+
+    EXPECT_EQ(data, ring.data);
+    EXPECT_EQ(16, ring.capacity);
+    EXPECT_EQ(0, ring.head);
+    EXPECT_EQ(0, ring.tail);
+    EXPECT_FALSE(ring.waiting);
+    EXPECT_EQ(0, rx_ring_size(&ring));
+}
+
+TEST(RxRingTest, PutAndGet) {
+    char data[16] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+
+    EXPECT_EQ(5, rx_ring_put(&ring, "Hello", 5));
+    EXPECT_EQ(5, rx_ring_size(&ring));
+
+    char buf[16] = { 0 };
+    EXPECT_EQ(3, rx_ring_get(&ring, buf, 3));
+    EXPECT_STREQ("Hel", buf);
+    EXPECT_EQ(2, rx_ring_size(&ring));
+
+    memset(buf, 0, sizeof(buf));
+    EXPECT_EQ(2, rx_ring_get(&ring, buf, 10));
+    EXPECT_STREQ("lo", buf);
+    EXPECT_EQ(0, rx_ring_size(&ring));
+    EXPECT_EQ(0, rx_ring_get(&ring, buf, 10));
+}
+
+TEST(RxRingTest, Put_GivenFull) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+
+    // Unlike an RxBuf the whole capacity is usable and the newest data is
+    // rejected rather than the oldest being discarded.
+    EXPECT_EQ(8, rx_ring_put(&ring, "0123456789", 10));
+    EXPECT_EQ(8, rx_ring_size(&ring));
+    EXPECT_EQ(0, rx_ring_put(&ring, "X", 1));
+
+    char buf[16] = { 0 };
+    EXPECT_EQ(8, rx_ring_get(&ring, buf, sizeof(buf)));
+    EXPECT_STREQ("01234567", buf);
+}
+
+TEST(RxRingTest, PutAndGet_GivenWrapAround) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    char buf[16] = { 0 };
+
+    EXPECT_EQ(6, rx_ring_put(&ring, "abcdef", 6));
+    EXPECT_EQ(6, rx_ring_get(&ring, buf, 6));
+
+    EXPECT_EQ(5, rx_ring_put(&ring, "ghijk", 5));
+    EXPECT_THAT(std::vector<char>(data, data + 8),
+                ::testing::ElementsAre('i', 'j', 'k', 'd', 'e', 'f', 'g', 'h'));
+
+    memset(buf, 0, sizeof(buf));
+    EXPECT_EQ(5, rx_ring_get(&ring, buf, sizeof(buf)));
+    EXPECT_STREQ("ghijk", buf);
+}
+
+TEST(RxRingTest, Getc) {
+    char data[4] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+
+    EXPECT_EQ(-1, rx_ring_getc(&ring));
+
+    const char src[] = { 'a', (char) 0xFF };
+    EXPECT_EQ(2, rx_ring_put(&ring, src, 2));
+
+    EXPECT_EQ('a', rx_ring_getc(&ring));
+    EXPECT_EQ(0xFF, rx_ring_getc(&ring));
+    EXPECT_EQ(-1, rx_ring_getc(&ring));
+}
+
+TEST(RxRingTest, ReserveAndCommit) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    char buf[8];
+
+    char *p;
+    EXPECT_EQ(8, rx_ring_reserve(&ring, &p));
+    EXPECT_EQ(data, p);
+    memcpy(p, "abcdef", 6);
+    rx_ring_commit(&ring, 6);
+    EXPECT_EQ(6, rx_ring_size(&ring));
+    EXPECT_EQ(4, rx_ring_get(&ring, buf, 4));
+
+    // Only the contiguous free space at the end of the ring is reserved.
+    EXPECT_EQ(2, rx_ring_reserve(&ring, &p));
+    EXPECT_EQ(data + 6, p);
+    rx_ring_commit(&ring, 2);
+
+    EXPECT_EQ(4, rx_ring_reserve(&ring, &p));
+    EXPECT_EQ(data, p);
+
+    rx_ring_commit(&ring, 4);
+    EXPECT_EQ(0, rx_ring_reserve(&ring, &p));
+}
+
+TEST(RxRingTest, PeekAndConsume) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+
+    const char *p;
+    EXPECT_EQ(0, rx_ring_peek(&ring, &p));
+
+    EXPECT_EQ(6, rx_ring_put(&ring, "abcdef", 6));
+    EXPECT_EQ(6, rx_ring_peek(&ring, &p));
+    EXPECT_EQ(data, p);
+    rx_ring_consume(&ring, 4);
+    EXPECT_EQ(2, rx_ring_size(&ring));
+
+    // Only the contiguous data at the end of the ring is peeked.
+    EXPECT_EQ(4, rx_ring_put(&ring, "ghij", 4));
+    EXPECT_EQ(4, rx_ring_peek(&ring, &p));
+    EXPECT_EQ(data + 4, p);
+    EXPECT_EQ(0, memcmp("efgh", p, 4));
+    rx_ring_consume(&ring, 4);
+
+    EXPECT_EQ(2, rx_ring_peek(&ring, &p));
+    EXPECT_EQ(data, p);
+    EXPECT_EQ(0, memcmp("ij", p, 2));
+    rx_ring_consume(&ring, 2);
+    EXPECT_EQ(0, rx_ring_peek(&ring, &p));
+}
+
+TEST(RxRingTest, Clear) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+
+    EXPECT_EQ(5, rx_ring_put(&ring, "Hello", 5));
+    rx_ring_clear(&ring);
+
+    EXPECT_EQ(0, rx_ring_size(&ring));
+    EXPECT_EQ(-1, rx_ring_getc(&ring));
+    EXPECT_EQ(8, rx_ring_put(&ring, "01234567", 8));
+}
+
+TEST(RxRingTest, ProducerAndConsumerThreads) {
+    char data[256] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    const size_t total = 100000;
+
+    std::thread producer([&ring, total]() {
+        char block[13];
+        size_t sent = 0;
+        while (sent < total) {
+            size_t sz = std::min(sizeof(block), total - sent);
+            for (size_t i = 0; i < sz; ++i) block[i] = (char) (sent + i);
+            size_t count = 0;
+            while (count < sz) {
+                size_t put = rx_ring_put(&ring, block + count, sz - count);
+                if (put == 0) std::this_thread::yield();
+                count += put;
+            }
+            sent += sz;
+        }
+    });
+
+    size_t received = 0;
+    bool in_order = true;
+    char buf[7];
+    while (received < total) {
+        size_t count = rx_ring_get(&ring, buf, sizeof(buf));
+        if (count == 0) std::this_thread::yield();
+        for (size_t i = 0; i < count; ++i) {
+            if (buf[i] != (char) (received + i)) in_order = false;
+        }
+        received += count;
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(total, received);
+    EXPECT_EQ(0, rx_ring_size(&ring));
+}
+
+TEST(RxRingTest, PrepareWait_GivenNotFull) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    rx_ring_put(&ring, "0123456", 7);
+
+    EXPECT_FALSE(rx_ring_prepare_wait(&ring));
+    EXPECT_FALSE(ring.waiting);
+}
+
+TEST(RxRingTest, PrepareWait_GivenFull) {
+    char data[8] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    rx_ring_put(&ring, "01234567", 8);
+
+    EXPECT_TRUE(rx_ring_prepare_wait(&ring));
+    EXPECT_TRUE(ring.waiting);
+
+    char c;
+    EXPECT_EQ(1, rx_ring_get(&ring, &c, 1));
+    EXPECT_TRUE(rx_ring_producer_waiting(&ring));
+    EXPECT_FALSE(ring.waiting);
+
+    // The producer is only reported once.
+    EXPECT_EQ(1, rx_ring_get(&ring, &c, 1));
+    EXPECT_FALSE(rx_ring_producer_waiting(&ring));
+}
+
+// Waits for the consumer to free space in the same way as the serial port
+// reader thread, returns false if it was not woken.
+static bool wait_for_space(RxRing *ring, int space_fd) {
+    if (!rx_ring_prepare_wait(ring)) return true;
+    struct pollfd fd = { space_fd, POLLIN, 0 };
+    if (poll(&fd, 1, 5000) != 1) return false;
+    uint64_t signals;
+    return read(space_fd, &signals, sizeof(signals)) == sizeof(signals);
+}
+
+// Takes a byte in the same way as the serial port consumer, returns true if it
+// had to wake the producer.
+static bool take(RxRing *ring, int space_fd, char *c) {
+    if (rx_ring_get(ring, c, 1) == 0) return false;
+    if (!rx_ring_producer_waiting(ring)) return false;
+    const uint64_t one = 1;
+    return write(space_fd, &one, sizeof(one)) == sizeof(one);
+}
+
+TEST(RxRingTest, ProducerWaiting_GivenDrainedWhilstParked) {
+    char data[16] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    const int space_fd = eventfd(0, EFD_NONBLOCK);
+    ASSERT_NE(-1, space_fd);
+    bool woken = false;
+
+    std::thread producer([&ring, space_fd, &woken]() {
+        while (rx_ring_put(&ring, "x", 1) == 1) { }
+        woken = wait_for_space(&ring, space_fd);
+        rx_ring_put(&ring, "y", 1);
+    });
+
+    // Wait for the producer to park on the full ring, then drain it.
+    while (!__atomic_load_n(&ring.waiting, __ATOMIC_ACQUIRE)) std::this_thread::yield();
+    int wakeups = 0;
+    char c;
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        if (take(&ring, space_fd, &c)) wakeups++;
+        EXPECT_EQ('x', c);
+    }
+    producer.join();
+    close(space_fd);
+
+    EXPECT_TRUE(woken);
+    EXPECT_EQ(1, wakeups);
+    EXPECT_EQ(1, rx_ring_size(&ring));
+    EXPECT_EQ('y', rx_ring_getc(&ring));
+}
+
+TEST(RxRingTest, ProducerWaiting_GivenProducerAndConsumerThreads) {
+    char data[4] = { 0 };
+    RxRing ring;
+    rx_ring_init(&ring, data, sizeof(data));
+    const int space_fd = eventfd(0, EFD_NONBLOCK);
+    ASSERT_NE(-1, space_fd);
+    const size_t total = 100000;
+    bool lost_wakeup = false;
+
+    std::thread producer([&ring, space_fd, total, &lost_wakeup]() {
+        for (size_t sent = 0; sent < total && !lost_wakeup; ) {
+            const char c = (char) sent;
+            if (rx_ring_put(&ring, &c, 1) == 1) {
+                sent++;
+            } else if (!wait_for_space(&ring, space_fd)) {
+                lost_wakeup = true;
+            }
+        }
+    });
+
+    size_t received = 0;
+    bool in_order = true;
+    char c;
+    while (received < total && !__atomic_load_n(&lost_wakeup, __ATOMIC_RELAXED)) {
+        if (rx_ring_size(&ring) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        take(&ring, space_fd, &c);
+        if (c != (char) received) in_order = false;
+        received++;
+    }
+    producer.join();
+    close(space_fd);
+
+    EXPECT_FALSE(lost_wakeup);
+    EXPECT_EQ(total, received);
+    EXPECT_TRUE(in_order);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 Thomas Hugo Williams
+ * License MIT <https://opensource.org/licenses/MIT>
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h> // Needed for EXPECT_THAT.
+
+#include <csetjmp>
+#include <string>
+
+extern "C" {
+
+#include "../mmtime.h"
+#include "../scheduler.h"
+
+} // extern "C"
+
+static std::string log_;
+static jmp_buf jmp_;
+
+static void task_a(void) { log_ += "A"; }
+static void task_b(void) { log_ += "B"; }
+static void task_longjmp(void) { log_ += "J"; longjmp(jmp_, 1); }
+
+class SchedulerTest : public ::testing::Test {
+
+protected:
+
+    void SetUp() override {
+        scheduler_clear();
+        log_.clear();
+    }
+
+    void TearDown() override {
+    }
+
+};
+
+TEST_F(SchedulerTest, Add) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 200, false));
+
+    EXPECT_EQ(2, scheduler_count);
+    EXPECT_STREQ("TASK_A", scheduler_tasks[0].name);
+    EXPECT_EQ(100, scheduler_tasks[0].period_ns);
+    EXPECT_EQ(0, scheduler_tasks[0].runs);
+    EXPECT_STREQ("TASK_B", scheduler_tasks[1].name);
+    EXPECT_EQ(200, scheduler_tasks[1].period_ns);
+}
+
+TEST_F(SchedulerTest, Add_GivenInvalidArguments) {
+    EXPECT_EQ(kInternalFault, scheduler_add("TASK_A", NULL, 100, false));
+    EXPECT_EQ(kInternalFault, scheduler_add("TASK_A", task_a, -1, false));
+    EXPECT_EQ(0, scheduler_count);
+}
+
+TEST_F(SchedulerTest, Add_GivenTableFull) {
+    for (int ii = 0; ii < SCHEDULER_MAX_TASKS; ++ii) {
+        EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    }
+
+    EXPECT_EQ(kContainerFull, scheduler_add("TASK_B", task_b, 100, false));
+    EXPECT_EQ(SCHEDULER_MAX_TASKS, scheduler_count);
+}
+
+TEST_F(SchedulerTest, Find) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 200, false));
+
+    EXPECT_EQ(&scheduler_tasks[0], scheduler_find("TASK_A"));
+    EXPECT_EQ(&scheduler_tasks[1], scheduler_find("task_b"));
+    EXPECT_EQ(NULL, scheduler_find("TASK_C"));
+}
+
+TEST_F(SchedulerTest, NextDue) {
+    EXPECT_EQ(INT64_MAX, scheduler_next_due_ns(true));
+
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, true));
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 200, false));
+    scheduler_run(1000);
+
+    EXPECT_EQ(1100, scheduler_next_due_ns(true));
+    EXPECT_EQ(1200, scheduler_next_due_ns(false));
+}
+
+TEST_F(SchedulerTest, Run_GivenNewTasks_RunsAllTasks) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 200, false));
+
+    scheduler_run(1000);
+
+    EXPECT_EQ("AB", log_);
+    EXPECT_EQ(1, scheduler_tasks[0].runs);
+    EXPECT_EQ(1100, scheduler_tasks[0].due_ns);
+    EXPECT_EQ(1, scheduler_tasks[1].runs);
+    EXPECT_EQ(1200, scheduler_tasks[1].due_ns);
+}
+
+TEST_F(SchedulerTest, Run_RespectsPeriods) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 200, false));
+
+    scheduler_run(1000);
+    scheduler_run(1050);
+    scheduler_run(1099);
+    EXPECT_EQ("AB", log_);
+
+    scheduler_run(1100);
+    EXPECT_EQ("ABA", log_);
+
+    scheduler_run(1200);
+    EXPECT_EQ("ABAAB", log_);
+
+    scheduler_run(1250);
+    EXPECT_EQ("ABAAB", log_);
+
+    EXPECT_EQ(3, scheduler_tasks[0].runs);
+    EXPECT_EQ(2, scheduler_tasks[1].runs);
+}
+
+TEST_F(SchedulerTest, Run_GivenZeroPeriod_RunsEveryTime) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 0, false));
+
+    scheduler_run(1000);
+    scheduler_run(1000);
+    scheduler_run(1001);
+
+    EXPECT_EQ("AAA", log_);
+}
+
+TEST_F(SchedulerTest, Run_GivenTaskAddedLater_RunsOnNextCall) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    scheduler_run(1000);
+
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 100, false));
+    scheduler_run(1001);
+
+    EXPECT_EQ("AB", log_);
+}
+
+TEST_F(SchedulerTest, Run_GivenTaskLongjmps) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    EXPECT_EQ(kOk, scheduler_add("TASK_J", task_longjmp, 100, false));
+    EXPECT_EQ(kOk, scheduler_add("TASK_B", task_b, 100, false));
+
+    if (setjmp(jmp_) == 0) scheduler_run(1000);
+    EXPECT_EQ("AJ", log_);
+
+    // The task that longjmped is not re-run until its period has elapsed,
+    // but the tasks after it are run on the next call.
+    if (setjmp(jmp_) == 0) scheduler_run(1001);
+    EXPECT_EQ("AJB", log_);
+    EXPECT_EQ(1, scheduler_tasks[1].runs);
+
+    if (setjmp(jmp_) == 0) scheduler_run(1002);
+    EXPECT_EQ("AJB", log_);
+}
+
+TEST_F(SchedulerTest, Poll_CountsPolls) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, SECONDS_TO_NANOSECONDS(3600), false));
+
+    scheduler_poll();
+    scheduler_poll();
+    scheduler_poll();
+
+    EXPECT_EQ("A", log_);
+    EXPECT_EQ(3, scheduler_polls);
+}
+
+TEST_F(SchedulerTest, Clear) {
+    EXPECT_EQ(kOk, scheduler_add("TASK_A", task_a, 100, false));
+    scheduler_poll();
+
+    scheduler_clear();
+
+    EXPECT_EQ(0, scheduler_count);
+    EXPECT_EQ(0, scheduler_polls);
+    scheduler_run(INT64_MAX);
+    EXPECT_EQ("A", log_);
+}
@@ -682,6 +682,42 @@ TEST_F(SpriteTest, UpdateCollisions_RegistersCollision_GivenSurfaceOverlappingEd
     EXPECT_EQ(-1, sprite_id);
 }
 
+TEST_F(SpriteTest, Move_RegistersSameCollisionsAsBruteForce_GivenManySprites) {
+    // Sprites 11..100 of assorted sizes on layers 0..2 scattered over, and beyond, the surface.
+    srand(42);
+    for (MmSurfaceId id = 11; id <= 100; ++id) {
+        EXPECT_EQ(kOk, graphics_sprite_create(id, 8 + rand() % 40, 8 + rand() % 40));
+        EXPECT_EQ(kOk, sprite_show(&graphics_surfaces[id], graphics_current, rand() % 740 - 50,
+                                   rand() % 580 - 50, rand() % 3, 0x0));
+    }
+
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        for (MmSurfaceId id = 1; id <= 100; ++id) {
+            if (rand() % 2) continue;
+            graphics_surfaces[id].next_x = rand() % 740 - 50;
+            graphics_surfaces[id].next_y = rand() % 580 - 50;
+        }
+        if (iteration % 2) {
+            EXPECT_EQ(kOk, sprite_move());
+        } else {
+            EXPECT_EQ(kOk, sprite_scroll(rand() % 21 - 10, rand() % 21 - 10, -1));
+        }
+
+        for (MmSurfaceId id1 = 1; id1 <= 100; ++id1) {
+            MmSurface *s1 = &graphics_surfaces[id1];
+            for (MmSurfaceId id2 = 1; id2 <= 100; ++id2) {
+                MmSurface *s2 = &graphics_surfaces[id2];
+                const bool expected = id1 != id2
+                        && (s1->layer == s2->layer || s1->layer == 0 || s2->layer == 0)
+                        && !(s2->x + s2->width < s1->x || s2->x > s1->x + s1->width
+                             || s2->y + s2->height < s1->y || s2->y > s1->y + s1->height);
+                EXPECT_EQ(expected, bitset_get(s1->sprite_collisions, id2) ? true : false)
+                    << "iteration = " << iteration << ", id1 = " << id1 << ", id2 = " << id2;
+            }
+        }
+    }
+}
+
 TEST_F(SpriteTest, GetCollisionBitSet_GivenNoCollisions) {
     MmSurface *sprite1 = &graphics_surfaces[1];
     uint64_t bitset;
@@ -0,0 +1,8 @@
+/*
+ * Copyright (c) 2026 Thomas Hugo Williams
+ * License MIT <https://opensource.org/licenses/MIT>
+ */
+
+#include "../../wait.h"
+
+void wait_for_work(int64_t deadline_ns) { }
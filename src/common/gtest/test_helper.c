@@ -14,6 +14,7 @@ void clear_prog_memory() {
     ProgMemory[0] = '\0'; // Program ends "\0\0\xFF".
     ProgMemory[1] = '\0';
     ProgMemory[2] = '\xFF';
+    ClearLiteralCache();
 }
 
 // TODO: can I just use program_tokenise() instead ?
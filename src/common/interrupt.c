@@ -357,6 +357,18 @@ void interrupt_disable_tick(int irq) {
     }
 }
 
+int64_t interrupt_next_tick_ns(int64_t after_ns) {
+    int64_t next_ns = INT64_MAX;
+    for (int i = 0; i < NBRSETTICKS; ++i) {
+        if (interrupt_ticks[i].interrupt_addr
+                && interrupt_ticks[i].due_ns > after_ns
+                && interrupt_ticks[i].due_ns < next_ns) {
+            next_ns = interrupt_ticks[i].due_ns;
+        }
+    }
+    return next_ns;
+}
+
 void interrupt_enable_tick(int irq, int64_t period_ns, const char *interrupt_addr) {
     assert(irq >= 0 && irq < NBRSETTICKS);
     assert(period_ns > 0);
@@ -108,6 +108,17 @@ void interrupt_enable_specific_key(int key, const char *interrupt_addr);
 /** Enables the specified 'SETTICK' interrupt. */
 void interrupt_enable_tick(int irq, int64_t period_ns, const char *interrupt_addr);
 
+/**
+ * Gets the time the next 'SETTICK' interrupt is due.
+ *
+ * @param  after_ns  Only consider interrupts due after this time, as returned
+ *                   by mmtime_now_ns(); overdue interrupts are waiting to be
+ *                   handled rather than waited for.
+ * @return           Time as returned by mmtime_now_ns(), or INT64_MAX if no
+ *                   'SETTICK' interrupt is due after \p after_ns.
+ */
+int64_t interrupt_next_tick_ns(int64_t after_ns);
+
 /**
  * Checks if the specified character matches that set for the 'ON KEY ASCIIcode'
  * interrupt.
@@ -60,6 +60,25 @@ char ProgMemory[PROG_FLASH_SIZE];
 // memory for the memory map used in heap management
 uint32_t mmap[MMAP_SIZE];
 
+// Free runs of heap pages are tracked on segregated, doubly-linked free lists:
+//   - bins 0 .. HEAP_EXACT_BINS - 1 hold runs of exactly 1 .. HEAP_EXACT_BINS pages,
+//   - the remaining bins each hold runs with lengths in the range [2^n, 2^(n+1)).
+// The length of a free run is recorded against both its first and its last page so that
+// FreeMemory() can coalesce a released block with its neighbours without scanning.
+// Page 0 is never allocated, this matches the original bitmap scanning allocator.
+#define HEAP_PAGES       (HEAP_SIZE / PAGESIZE)
+#define HEAP_EXACT_BINS  16
+#define HEAP_BINS        (HEAP_EXACT_BINS + 28)
+#define HEAP_NO_PAGE     -1
+
+static int32_t heap_bin_head[HEAP_BINS];   // first free run in each bin
+static uint64_t heap_bin_mask;             // bit n is set if bin n is non-empty
+static uint32_t heap_run[HEAP_PAGES];      // length of the free run at its first and last page
+static int32_t heap_next[HEAP_PAGES];      // next free run in the same bin
+static int32_t heap_prev[HEAP_PAGES];      // previous free run in the same bin
+static uint32_t heap_used_pages;           // running count of allocated pages
+static bool heap_initialised = false;
+
 // MMBasic heap memory:
 //   - aligned on 64-bit boundary so that elements of MMBasic arrays of
 //     FLOAT and INTEGER will be likewise aligned.
@@ -68,13 +87,39 @@ char __attribute__ ((aligned (8))) MMHeap[HEAP_SIZE];
 // arrays used to track temporary strings
 char *StrTmp[MAXTEMPSTRINGS];           // used to track temporary string space on the heap
 char StrTmpLocalIndex[MAXTEMPSTRINGS];  // used to track the LocalIndex for each temporary string space on the heap
+int TempMemoryTop = 0;                  // this is the last index used for allocating temp memory on the heap
 int TempMemoryIsChanged = false;        // used to prevent unnecessary scanning of strtmp[]
 
+// Most temporary memory is allocated from a bump-pointer arena rather than the heap:
+//   - the arena is divided into fixed size chunks each owned by a single LocalIndex,
+//   - allocation bumps the offset within the most recently acquired chunk for the current LocalIndex,
+//   - ClearTempMemory() releases every chunk owned by LocalIndex or above by resetting its offset.
+// Requests larger than a chunk, or made when every chunk is in use, fall back to the heap and StrTmp[].
+static char __attribute__ ((aligned (8))) TempArena[TEMP_ARENA_CHUNKS][TEMP_ARENA_CHUNK_SIZE];
+static uint32_t temp_arena_offset[TEMP_ARENA_CHUNKS];  // offset of the next free byte in each chunk
+static uint32_t temp_arena_last[TEMP_ARENA_CHUNKS];    // offset of the most recent allocation in each chunk
+static int temp_arena_level[TEMP_ARENA_CHUNKS];        // LocalIndex that owns each chunk
+static int temp_arena_used[TEMP_ARENA_CHUNKS];         // chunks in use, in order of acquisition
+static int temp_arena_free[TEMP_ARENA_CHUNKS];         // stack of chunks not in use
+static int temp_arena_used_count;
+static int temp_arena_free_count;
+
 // global functions
 unsigned int MBitsGet(void *addr);
 void MBitsSet(void *addr, int bits);
 void *getheap(int size);
 
+static inline unsigned int heap_page_bits(uint32_t page);
+static inline void heap_set_page_bits(uint32_t page, unsigned int bits);
+static void heap_link(uint32_t page, uint32_t length);
+static void heap_unlink(uint32_t page);
+static void heap_init_free_lists(void);
+static void heap_release(uint32_t first, uint32_t length);
+static void temp_arena_init(void);
+static void *temp_arena_get(int size);
+static void temp_arena_clear(int level);
+static bool temp_arena_release(void *addr);
+
 /***********************************************************************************************************************
  Public memory management functions
 ************************************************************************************************************************/
@@ -87,14 +132,22 @@ void *GetMemory(size_t msize) {
 
 // Get a temporary buffer of any size, returns a pointer to the buffer
 // The space only lasts for the length of the command or in the case of a sub/fun until it has exited.
-// A pointer to the space is also saved in strtmp[] so that the memory can be automatically freed at the end of the command
+// Small buffers come from the temporary memory arena, larger ones from the heap in which case a pointer to the space
+// is also saved in strtmp[] so that the memory can be automatically freed at the end of the command
 // StrTmpLocalIndex[] is used to track the sub/fun nesting level at which it was created
 void *GetTempMemory(int NbrBytes) {
+    void *addr = temp_arena_get(NbrBytes);
+    if (addr) {
+        TempMemoryIsChanged = true;
+        return addr;
+    }
+
     int i;
     for(i = 0; i < MAXTEMPSTRINGS; i++)
         if(StrTmp[i] == NULL) {
             StrTmpLocalIndex[i] = LocalIndex;
             StrTmp[i] = GetMemory(NbrBytes);
+            if (i >= TempMemoryTop) TempMemoryTop = i + 1;
             TempMemoryIsChanged = true;
             return StrTmp[i];
         }
@@ -112,21 +165,25 @@ void *GetTempStrMemory(void) {
 // this will not clear memory allocated with a local index less than LocalIndex, sub/funs will increment LocalIndex
 // and this prevents the automatic use of ClearTempMemory from clearing memory allocated before calling the sub/fun
 void ClearTempMemory(void) {
-    int i;
+    int i, top = 0;
 //dp("ClearTempMemory");
-    for(i = 0; i < MAXTEMPSTRINGS; i++) {
+    temp_arena_clear(LocalIndex);
+    for(i = 0; i < TempMemoryTop; i++) {
         if(StrTmpLocalIndex[i] >= LocalIndex && StrTmp[i] != NULL) {
             FreeMemory(StrTmp[i]);
             StrTmp[i] = NULL;
         }
+        if(StrTmp[i] != NULL) top = i + 1;
     }
+    TempMemoryTop = top;
     TempMemoryIsChanged = false;
 }
 
 void ClearSpecificTempMemory(void *addr) {
     int i;
 //dpIGClearSpecificTempMemory(%p)", addr);
-    for(i = 0; i < MAXTEMPSTRINGS; i++) {
+    if (temp_arena_release(addr)) return;
+    for(i = 0; i < TempMemoryTop; i++) {
         if(StrTmp[i] == addr) {
             FreeMemory(addr);
             StrTmp[i] = NULL;
@@ -136,14 +193,14 @@ void ClearSpecificTempMemory(void *addr) {
 }
 
 void FreeMemory(void *addr) {
-    int bits;
     // dp("FreeMemory(%p)", addr);
-    do {
-        if (addr < (void *) MMHeap || addr >= (void *) RAMEND) return;
-        bits = MBitsGet(addr);
-        MBitsSet(addr, 0);
-        addr += PAGESIZE;
-    } while (bits != (PUSED | PLAST));
+    if (addr < (void *) MMHeap || addr >= (void *) RAMEND) return;
+    const uint32_t first = ((char *) addr - MMHeap) / PAGESIZE;
+    if (!(heap_page_bits(first) & PUSED)) return;
+
+    uint32_t page = first;
+    while (heap_page_bits(page) != (PUSED | PLAST) && page < HEAP_PAGES - 1) page++;
+    heap_release(first, page - first + 1);
 }
 
 void InitHeap(void) {
@@ -158,47 +215,152 @@ void InitHeap(void) {
 #endif
     for (size_t i = 0; i < MMAP_SIZE; i++) mmap[i] = 0;
     for (size_t i = 0; i < MAXTEMPSTRINGS; i++) StrTmp[i] = NULL;
+    TempMemoryTop = 0;
     MBitsSet((char *) RAMEND, PUSED | PLAST);
+    heap_init_free_lists();
+    temp_arena_init();
 }
 
 /***********************************************************************************************************************
  Private memory management functions
 ************************************************************************************************************************/
 
-unsigned int MBitsGet(void *addr) {
-    unsigned int i, *p;
-    // addr -= (int)MMHeap;
-    uintptr_t addrx = (uintptr_t)addr - (uintptr_t)MMHeap;
-    p = &mmap[(addrx / PAGESIZE) / PAGESPERWORD];  // point to the word in the memory map
-    i = (((addrx / PAGESIZE)) & (PAGESPERWORD - 1)) * PAGEBITS;  // get the position of the bits in the word
+static inline unsigned int heap_page_bits(uint32_t page) {
+    const uint32_t *p = &mmap[page / PAGESPERWORD];                 // point to the word in the memory map
+    const unsigned int i = (page & (PAGESPERWORD - 1)) * PAGEBITS;  // get the position of the bits in the word
     return (*p >> i) & ((1 << PAGEBITS) - 1);
 }
 
-void MBitsSet(void *addr, int bits) {
-    unsigned int i, *p;
-    // addr -= (int)MMHeap;
-    uintptr_t addrx = (uintptr_t)addr - (uintptr_t)MMHeap;
-    p = &mmap[(addrx / PAGESIZE) / PAGESPERWORD];  // point to the word in the memory map
-    i = (((addrx / PAGESIZE)) & (PAGESPERWORD - 1)) * PAGEBITS;  // get the position of the bits in the word
+static inline void heap_set_page_bits(uint32_t page, unsigned int bits) {
+    uint32_t *p = &mmap[page / PAGESPERWORD];                       // point to the word in the memory map
+    const unsigned int i = (page & (PAGESPERWORD - 1)) * PAGEBITS;  // get the position of the bits in the word
     *p = (bits << i) | (*p & (~(((1 << PAGEBITS) - 1) << i)));
 }
 
-void *getheap(int size) {
-    unsigned int j, n;
-    char *addr;
-    j = n = (size + PAGESIZE - 1)/PAGESIZE;                         // nbr of pages rounded up
-    for(addr = (char *) RAMEND -  PAGESIZE; addr > MMHeap; addr -= PAGESIZE) {
-        if(!(MBitsGet(addr) & PUSED)) {
-            if(--n == 0) {                                          // found a free slot
-                j--;
-                MBitsSet(addr + (j * PAGESIZE), PUSED | PLAST);     // show that this is used and the last in the chain of pages
-                while(j--) MBitsSet(addr + (j * PAGESIZE), PUSED);  // set the other pages to show that they are used
-                memset(addr, 0, size);                              // zero the memory
+unsigned int MBitsGet(void *addr) {
+    return heap_page_bits(((uintptr_t) addr - (uintptr_t) MMHeap) / PAGESIZE);
+}
+
+void MBitsSet(void *addr, int bits) {
+    heap_set_page_bits(((uintptr_t) addr - (uintptr_t) MMHeap) / PAGESIZE, bits);
+}
+
+/** Gets the index of the free list bin for a run of 'length' pages. */
+static inline int heap_bin(uint32_t length) {
+    if (length <= HEAP_EXACT_BINS) return length - 1;
+    return HEAP_EXACT_BINS + (31 - __builtin_clz(length)) - 4;
+}
+
+/** Records a run of free pages and pushes it onto the front of the appropriate free list. */
+static void heap_link(uint32_t page, uint32_t length) {
+    const int bin = heap_bin(length);
+    heap_run[page] = length;
+    heap_run[page + length - 1] = length;
+    heap_prev[page] = HEAP_NO_PAGE;
+    heap_next[page] = heap_bin_head[bin];
+    if (heap_bin_head[bin] != HEAP_NO_PAGE) heap_prev[heap_bin_head[bin]] = page;
+    heap_bin_head[bin] = page;
+    heap_bin_mask |= UINT64_C(1) << bin;
+}
+
+/** Removes a run of free pages from its free list. */
+static void heap_unlink(uint32_t page) {
+    const int bin = heap_bin(heap_run[page]);
+    if (heap_prev[page] == HEAP_NO_PAGE) {
+        heap_bin_head[bin] = heap_next[page];
+        if (heap_bin_head[bin] == HEAP_NO_PAGE) heap_bin_mask &= ~(UINT64_C(1) << bin);
+    } else {
+        heap_next[heap_prev[page]] = heap_next[page];
+    }
+    if (heap_next[page] != HEAP_NO_PAGE) heap_prev[heap_next[page]] = heap_prev[page];
+}
+
+/** Resets the free lists to contain a single run of every page in the heap except page 0. */
+static void heap_init_free_lists(void) {
+    for (size_t i = 0; i < HEAP_BINS; i++) heap_bin_head[i] = HEAP_NO_PAGE;
+    heap_bin_mask = 0;
+    heap_used_pages = 0;
+    heap_link(1, HEAP_PAGES - 1);
+    heap_initialised = true;
+}
+
+/** Marks a run of pages as a single allocation. */
+static void heap_mark_used(uint32_t first, uint32_t length) {
+    for (uint32_t j = 0; j < length - 1; j++) heap_set_page_bits(first + j, PUSED);
+    heap_set_page_bits(first + length - 1, PUSED | PLAST);  // show that this is used and the last in the chain of pages
+    heap_used_pages += length;
+}
+
+/** Returns a run of allocated pages to the free lists, coalescing with any free neighbours. */
+static void heap_release(uint32_t first, uint32_t length) {
+    for (uint32_t j = 0; j < length; j++) heap_set_page_bits(first + j, 0);
+    heap_used_pages -= length;
+
+    uint32_t start = first;
+    const uint32_t above = first + length;
+    if (start > 1 && !(heap_page_bits(start - 1) & PUSED)) {
+        const uint32_t below = heap_run[start - 1];
+        start -= below;
+        heap_unlink(start);
+        length += below;
+    }
+    if (above < HEAP_PAGES && !(heap_page_bits(above) & PUSED)) {
+        length += heap_run[above];
+        heap_unlink(above);
+    }
+    heap_link(start, length);
+}
+
+/**
+ * Finds a run of at least 'length' free pages.
+ *
+ * Runs in the exact bins are taken from the head of their list in O(1); runs in the
+ * power-of-two bins are found first-fit, and failing that the head of the next non-empty
+ * bin is guaranteed to be large enough.
+ *
+ * @return  index of the first page of the run, or HEAP_NO_PAGE if there is none.
+ */
+static int32_t heap_find_run(uint32_t length) {
+    const int bin = heap_bin(length);
+    for (int32_t page = heap_bin_head[bin]; page != HEAP_NO_PAGE; page = heap_next[page]) {
+        if (heap_run[page] >= length) return page;
+    }
+    const uint64_t mask = bin + 1 < HEAP_BINS
+            ? heap_bin_mask & ~((UINT64_C(1) << (bin + 1)) - 1)
+            : 0;
+    return mask ? heap_bin_head[__builtin_ctzll(mask)] : HEAP_NO_PAGE;
+}
+
+/**
+ * Allocates and zeroes heap memory.
+ *
+ * @param  size         number of bytes to allocate, rounded up to a whole number of pages.
+ * @param  from_bottom  if true then allocate from the bottom of the free run leaving any remaining
+ *                      free pages immediately above the allocation so that ReAllocMemory() can
+ *                      later grow it in place, otherwise allocate from the top of the run so that
+ *                      the heap continues to fill from RAMEND downward.
+ */
+static void *heap_get(int size, bool from_bottom) {
+    if (!heap_initialised) heap_init_free_lists();
+
+    const uint32_t n = size <= 0 ? 1 : ((uint32_t) size + PAGESIZE - 1) / PAGESIZE; // nbr of pages rounded up
+    const int32_t page = n < HEAP_PAGES ? heap_find_run(n) : HEAP_NO_PAGE;
+    if (page != HEAP_NO_PAGE) {
+        const uint32_t run = heap_run[page];
+        heap_unlink(page);
+        uint32_t first;
+        if (from_bottom) {
+            first = page;
+            if (run > n) heap_link(page + n, run - n);
+        } else {
+            first = page + run - n;
+            if (run > n) heap_link(page, run - n);
+        }
+        heap_mark_used(first, n);
+        char *addr = MMHeap + (size_t) first * PAGESIZE;
+        if (size > 0) memset(addr, 0, size);                  // zero the memory
 //dp("alloc = %p", addr);
-                return (void *)addr;
-            }
-        } else
-            n = j;                                                  // not enough space here so reset our count
+        return (void *)addr;
     }
     // out of memory
     LocalIndex = 0;
@@ -207,24 +369,108 @@ void *getheap(int size) {
     return NULL;                                                    // keep the compiler happy
 }
 
-/** Counts the unused pages of heap and returns the result multiplied by PAGESIZE. */
+void *getheap(int size) {
+    return heap_get(size, false);
+}
+
+static bool temp_arena_initialised = false;
+
+/** Returns every chunk of the temporary memory arena to the free stack. */
+static void temp_arena_init(void) {
+    temp_arena_used_count = 0;
+    temp_arena_free_count = TEMP_ARENA_CHUNKS;
+    for (int i = 0; i < TEMP_ARENA_CHUNKS; i++) {
+        temp_arena_free[i] = TEMP_ARENA_CHUNKS - 1 - i;
+        temp_arena_offset[i] = 0;
+        temp_arena_last[i] = 0;
+    }
+    temp_arena_initialised = true;
+}
+
+/**
+ * Allocates and zeroes memory from the temporary memory arena for the current LocalIndex.
+ *
+ * @return  pointer to the memory, or NULL if the request is too large or the arena is exhausted.
+ */
+static void *temp_arena_get(int size) {
+    if (!temp_arena_initialised) temp_arena_init();
+
+    const uint32_t n = size <= 0 ? 8 : ((uint32_t) size + 7) & ~7u;  // keep allocations 8-byte aligned
+    if (n > TEMP_ARENA_CHUNK_SIZE) return NULL;
+
+    // Normally the most recently acquired chunk belongs to the current LocalIndex, but a
+    // function's return value is allocated at the caller's level so we may need to look further.
+    int chunk = -1;
+    for (int i = temp_arena_used_count - 1; i >= 0; i--) {
+        const int c = temp_arena_used[i];
+        if (temp_arena_level[c] == LocalIndex) {
+            if (temp_arena_offset[c] + n <= TEMP_ARENA_CHUNK_SIZE) chunk = c;
+            break;
+        }
+    }
+
+    if (chunk == -1) {
+        if (temp_arena_free_count == 0) return NULL;
+        chunk = temp_arena_free[--temp_arena_free_count];
+        temp_arena_used[temp_arena_used_count++] = chunk;
+        temp_arena_level[chunk] = LocalIndex;
+        temp_arena_offset[chunk] = 0;
+    }
+
+    char *addr = TempArena[chunk] + temp_arena_offset[chunk];
+    temp_arena_last[chunk] = temp_arena_offset[chunk];
+    temp_arena_offset[chunk] += n;
+    memset(addr, 0, n);
+    return addr;
+}
+
+/** Releases every chunk of the temporary memory arena owned by 'level' or above. */
+static void temp_arena_clear(int level) {
+    // Chunks are almost always released in the reverse order to which they were acquired.
+    while (temp_arena_used_count > 0
+            && temp_arena_level[temp_arena_used[temp_arena_used_count - 1]] >= level) {
+        temp_arena_free[temp_arena_free_count++] = temp_arena_used[--temp_arena_used_count];
+    }
+
+    int j = 0;
+    for (int i = 0; i < temp_arena_used_count; i++) {
+        const int c = temp_arena_used[i];
+        if (temp_arena_level[c] >= level) {
+            temp_arena_free[temp_arena_free_count++] = c;
+        } else {
+            temp_arena_used[j++] = c;
+        }
+    }
+    temp_arena_used_count = j;
+}
+
+/**
+ * Releases an individual allocation from the temporary memory arena.
+ *
+ * The memory is only reclaimed immediately if it was the most recent allocation from its
+ * chunk, otherwise it is reclaimed when its chunk is released by ClearTempMemory().
+ *
+ * @return  true if 'addr' is in the temporary memory arena.
+ */
+static bool temp_arena_release(void *addr) {
+    if ((char *) addr < TempArena[0] || (char *) addr >= TempArena[TEMP_ARENA_CHUNKS]) return false;
+    const uintptr_t offset = (char *) addr - TempArena[0];
+    const int chunk = offset / TEMP_ARENA_CHUNK_SIZE;
+    if (offset % TEMP_ARENA_CHUNK_SIZE == temp_arena_last[chunk]
+            && temp_arena_offset[chunk] > temp_arena_last[chunk]) {
+        temp_arena_offset[chunk] = temp_arena_last[chunk];
+    }
+    return true;
+}
+
+/** Gets the number of unused pages of heap multiplied by PAGESIZE. */
 int FreeSpaceOnHeap(void) {
-    unsigned int nbr;
-    char *addr;
-    nbr = 0;
-    for(addr = (char *) RAMEND -  PAGESIZE; addr > MMHeap; addr -= PAGESIZE)
-        if(!(MBitsGet(addr) & PUSED)) nbr++;
-    return nbr * PAGESIZE;
+    return (HEAP_PAGES - 1 - heap_used_pages) * PAGESIZE;
 }
 
-/** Counts the used pages of heap and returns the result multiplied by PAGESIZE. */
+/** Gets the number of used pages of heap multiplied by PAGESIZE. */
 unsigned int UsedHeap(void) {
-    unsigned int nbr;
-    char *addr;
-    nbr = 0;
-    for(addr = (char *) RAMEND -  PAGESIZE; addr > MMHeap; addr -= PAGESIZE)
-        if(MBitsGet(addr) & PUSED) nbr++;
-    return nbr * PAGESIZE;
+    return heap_used_pages * PAGESIZE;
 }
 
 #ifdef __xDEBUG
@@ -264,7 +510,7 @@ uintptr_t get_peek_addr(const char *p) {
 static int MemSize(void* addr) { //returns the amount of heap memory allocated to an address
     int i = 0;
     int bits;
-    if (addr >= (void*)MMHeap && addr < (void*)(MMHeap + HEAP_SIZE)) {
+    if (addr >= (void*)MMHeap && addr < (void*)(MMHeap + HEAP_SIZE) && (MBitsGet(addr) & PUSED)) {
         do {
             bits = MBitsGet((unsigned char*)addr);
             addr = (unsigned char*)addr + PAGESIZE;
@@ -274,15 +520,43 @@ static int MemSize(void* addr) { //returns the amount of heap memory allocated t
     return i;
 }
 
+/**
+ * Resizes a block of heap memory, preserving its contents.
+ *
+ * Where possible the block is resized in place:
+ *   - shrinking returns the unneeded tail pages to the heap;
+ *   - growing claims free pages immediately above the block.
+ * Otherwise a new block is allocated from the bottom of a free run, leaving room for it to
+ * grow in place on subsequent calls, and the contents are copied into it.
+ */
 void* ReAllocMemory(void* addr, size_t msize) {
-    int size = MemSize(addr);
-    if (msize <= (size_t)size)return addr;
-    void* newaddr = GetMemory(msize);
-    if (addr != NULL && size != 0) {
-        memcpy(newaddr, addr, MemSize(addr));
-        FreeMemory((unsigned char *)addr);
-        addr = NULL;
+    const uint32_t pages = MemSize(addr) / PAGESIZE;
+    if (pages == 0) return msize == 0 ? addr : heap_get(msize, true);
 
+    const uint32_t n = msize == 0 ? 1 : (msize + PAGESIZE - 1) / PAGESIZE;
+    const uint32_t first = ((char *) addr - MMHeap) / PAGESIZE;
+    if (n == pages) return addr;
+
+    if (n < pages) {
+        heap_set_page_bits(first + n - 1, PUSED | PLAST);
+        heap_release(first + n, pages - n);
+        return addr;
+    }
+
+    const uint32_t above = first + pages;
+    const uint32_t extra = n - pages;
+    if (above < HEAP_PAGES && !(heap_page_bits(above) & PUSED) && heap_run[above] >= extra) {
+        const uint32_t run = heap_run[above];
+        heap_unlink(above);
+        if (run > extra) heap_link(above + extra, run - extra);
+        heap_set_page_bits(above - 1, PUSED);
+        heap_mark_used(above, extra);
+        memset(MMHeap + (size_t) above * PAGESIZE, 0, (size_t) extra * PAGESIZE);
+        return addr;
     }
+
+    void* newaddr = heap_get(msize, true);
+    memcpy(newaddr, addr, (size_t) pages * PAGESIZE);
+    FreeMemory(addr);
     return newaddr;
 }
@@ -91,6 +91,9 @@ void* ReAllocMemory(void* addr, size_t msize);
 #define PLAST           2 //0b10                                    // flag to show that this is the last page in a single allocation
 
 #define PAGESPERWORD    ((sizeof(uint32_t) * 8)/PAGEBITS)
+
+#define TEMP_ARENA_CHUNK_SIZE  4096                                 // size of each chunk of the temporary memory arena
+#define TEMP_ARENA_CHUNKS      64                                   // nbr of chunks in the temporary memory arena
 // #define MRoundUp(a)     (((a) + (PAGESIZE - 1)) & (~(PAGESIZE - 1)))// round up to the nearest page size
 
 extern char ProgMemory[];
@@ -46,25 +46,82 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "error.h"
 #include "file.h"
 #include "options.h"
+#include "wait.h"
 
 #include <ctype.h>
 #include <string.h>
 
 void CheckAbort(void);
 
+/**
+ * Gets a line from a file.
+ *
+ * Equivalent to the general case in MMgetline() but scans the file's
+ * read-ahead buffer (or memory mapping) a block at a time rather than
+ * calling file_getc() for every character.
+ */
+static void MMgetline_file(int filenbr, char *p) {
+    int nbrchars = 0;
+    const char *data;
+    int count;
+
+    while ((count = file_peek(filenbr, &data)) > 0) {
+        CheckAbort();  // jump right out if CTRL-C
+
+        const char *newline = memchr(data, '\n', count);
+        const char *end = newline ? newline : data + count;
+        for (const char *q = data; q < end; ++q) {
+            switch (*q) {
+                case '\0':  // ignore the null character
+                case '\r':  // loop around looking for the following newline
+                    break;
+                case '\t':  // expand tabs to spaces
+                    do {
+                        if (++nbrchars > MAXSTRLEN) error_throw(kLineTooLong);
+                        *p++ = ' ';
+                    } while (nbrchars % mmb_options.tab);
+                    break;
+                case '\b':  // handle the backspace
+                    if (nbrchars) {
+                        nbrchars--;
+                        p--;
+                    }
+                    break;
+                default:
+                    if (++nbrchars > MAXSTRLEN) error_throw(kLineTooLong);
+                    *p++ = *q;
+                    break;
+            }
+        }
+
+        if (newline) {
+            file_skip(filenbr, newline - data + 1);
+            break;
+        }
+        file_skip(filenbr, count);
+    }
+    *p = 0;
+}
+
 // get a line from the keyboard or a file handle
 void MMgetline(int filenbr, char *p) {
     int c, nbrchars = 0;
     const char *tp;
 
+    if (filenbr > 0
+            && (file_table[filenbr].type == fet_file || file_table[filenbr].type == fet_map)) {
+        MMgetline_file(filenbr, p);
+        return;
+    }
+
     while (1) {
         CheckAbort();  // jump right out if CTRL-C
 
-        if ((file_table[filenbr].type == fet_file) && file_eof(filenbr)) break; // End of file.
         c = file_getc(filenbr);
 
-        // -1 - no character.
+        // -1 - no character, block until a serial port has some input.
         //  0 - the null character which we ignore.
+        if (c == -1) wait_for_work(WAIT_FOREVER);
         if (c <= 0) continue;
 
         // if this is the console, check for a programmed function key and
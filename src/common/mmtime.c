@@ -72,6 +72,12 @@ int64_t mmtime_now_ns() {
     return SECONDS_TO_NANOSECONDS(now.tv_sec) + (int64_t) now.tv_nsec;
 }
 
+int64_t mmtime_monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return SECONDS_TO_NANOSECONDS(now.tv_sec) + (int64_t) now.tv_nsec;
+}
+
 int64_t mmtime_get_timer_ns(void) {
     return mmtime_now_ns() - mmtime_base_ns;
 }
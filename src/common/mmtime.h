@@ -65,6 +65,12 @@ void mmtime_init(void);
  */
 int64_t mmtime_now_ns();
 
+/**
+ * Gets the number of nanoseconds elapsed on a monotonic clock that is
+ * unaffected by changes to the system time; only differences are meaningful.
+ */
+int64_t mmtime_monotonic_ns(void);
+
 /** Gets the current value of the Timer in nanoseconds. */
 int64_t mmtime_get_timer_ns(void);
 
@@ -114,6 +114,12 @@ static const NameOrdinalPair options_list_case_map[] = {
     { NULL,    -1 }
 };
 
+static const NameOrdinalPair options_render_map[] = {
+    { "Inline", kRenderInline },
+    { "Thread", kRenderThread },
+    { NULL,     -1 }
+};
+
 static const NameOrdinalPair options_resolution_map[] = {
     { "Character", kCharacter },
     { "Pixel",     kPixel },
@@ -155,10 +161,13 @@ OptionsDefinition options_definitions[] = {
     { "F10",         kOptionF10,          kOptionTypeString,  true,  "RUN \"\"\202",            NULL },
     { "F11",         kOptionF11,          kOptionTypeString,  true,  "",                        NULL },
     { "F12",         kOptionF12,          kOptionTypeString,  true,  "",                        NULL },
+    { "Render",      kOptionRender,       kOptionTypeString,  true,  "Inline",                  options_render_map },
     { "Resolution",  kOptionResolution,   kOptionTypeString,  false, "Character",               options_resolution_map },
     { "Search Path", kOptionSearchPath,   kOptionTypeString,  true,  "",                        NULL },
+    { "Serial Blocking", kOptionSerialBlocking, kOptionTypeBoolean, false, "On",                NULL },
     { "Simulate",    kOptionSimulate,     kOptionTypeString,  false, "MMB4L",                   options_simulate_map },
     { "Tab",         kOptionTab,          kOptionTypeInteger, true,  "4",                       NULL },
+    { "VSync",       kOptionVSync,        kOptionTypeBoolean, true,  "On",                      NULL },
 #if defined(OPTION_TESTS)
     { "ZBoolean",    kOptionZBoolean,     kOptionTypeBoolean, true,  "On",                      NULL },
     { "ZFloat",      kOptionZFloat,       kOptionTypeFloat,   true,  "2.71828",                 NULL },
@@ -576,9 +585,15 @@ MmResult options_get_integer_value(const Options *options, OptionsId id, MMINTEG
         case kOptionBreakKey:
             *ivalue = options->break_key;
             break;
+        case kOptionSerialBlocking:
+            *ivalue = options->serial_blocking;
+            break;
         case kOptionTab:
             *ivalue = options->tab;
             break;
+        case kOptionVSync:
+            *ivalue = options->vsync;
+            break;
 #if defined(OPTION_TESTS)
         case kOptionZBoolean:
             *ivalue = options->zboolean;
@@ -740,6 +755,14 @@ MmResult options_get_string_value(const Options *options, OptionsId id, char *sv
                     svalue);
             break;
 
+        case kOptionRender:
+            assert(options->render >= kRenderInline && options->render <= kRenderThread);
+            options_ordinal_to_name(
+                    options_definitions[kOptionRender].enum_map,
+                    options->render,
+                    svalue);
+            break;
+
         case kOptionResolution:
             assert(options->resolution >= kCharacter && options->resolution <= kPixel);
             options_ordinal_to_name(
@@ -894,6 +917,16 @@ static MmResult options_set_list_case(Options *options, const char *svalue) {
     return kInvalidValue;
 }
 
+static MmResult options_set_render(Options *options, const char *svalue) {
+    for (const NameOrdinalPair *entry = options_render_map; entry->name; ++entry) {
+        if (strcasecmp(svalue, entry->name) == 0) {
+            options->render = entry->ordinal;
+            return kOk;
+        }
+    }
+    return kInvalidValue;
+}
+
 static MmResult options_set_resolution(Options *options, const char *svalue) {
     for (const NameOrdinalPair *entry = options_resolution_map; entry->name; ++entry) {
         if (strcasecmp(svalue, entry->name) == 0) {
@@ -920,6 +953,15 @@ static MmResult options_set_search_path(Options *options, const char *svalue) {
     return kOk;
 }
 
+static MmResult options_set_serial_blocking(Options *options, int ivalue) {
+    if (ivalue == 0 || ivalue == 1) {
+        options->serial_blocking = ivalue;
+        return kOk;
+    } else {
+        return kInvalidValue;
+    }
+}
+
 static MmResult options_set_simulate(Options *options, const char *svalue) {
     for (const NameOrdinalPair *entry = options_simulate_map; entry->name; ++entry) {
         if (strcasecmp(svalue, entry->name) == 0) {
@@ -939,6 +981,15 @@ static MmResult options_set_tab(Options *options, int ivalue) {
     }
 }
 
+static MmResult options_set_vsync(Options *options, int ivalue) {
+    if (ivalue == 0 || ivalue == 1) {
+        options->vsync = ivalue;
+        return kOk;
+    } else {
+        return kInvalidValue;
+    }
+}
+
 MmResult options_set_float_value(Options *options, OptionsId id, MMFLOAT fvalue) {
     switch (id) {
 
@@ -958,7 +1009,9 @@ MmResult options_set_integer_value(Options *options, OptionsId id, MMINTEGER iva
         case kOptionAutoScale: return options_set_auto_scale(options, ivalue);
         case kOptionBase:      return options_set_base(options, ivalue);
         case kOptionBreakKey:  return options_set_break_key(options, ivalue);
+        case kOptionSerialBlocking: return options_set_serial_blocking(options, ivalue);
         case kOptionTab:       return options_set_tab(options, ivalue);
+        case kOptionVSync:     return options_set_vsync(options, ivalue);
 
 #if defined(OPTION_TESTS)
         case kOptionZBoolean:
@@ -1029,6 +1082,7 @@ MmResult options_set_string_value(Options *options, OptionsId id, const char *sv
         case kOptionF11:
         case kOptionF12:          return options_set_fn_key(options, id, svalue);
         case kOptionListCase:     return options_set_list_case(options, svalue);
+        case kOptionRender:       return options_set_render(options, svalue);
         case kOptionResolution:   return options_set_resolution(options, svalue);
         case kOptionSearchPath:   return options_set_search_path(options, svalue);
         case kOptionSimulate:     return options_set_simulate(options, svalue);
@@ -82,10 +82,13 @@ typedef enum {
     kOptionF10,
     kOptionF11,
     kOptionF12,
+    kOptionRender,
     kOptionResolution,
     kOptionSearchPath,
+    kOptionSerialBlocking,
     kOptionSimulate,
     kOptionTab,
+    kOptionVSync,
 #if defined(OPTION_TESTS)
     kOptionZBoolean,
     kOptionZFloat,
@@ -137,6 +140,8 @@ typedef enum { kTitle, kLower, kUpper } OptionsListCase;
 
 typedef enum { kCharacter, kPixel } OptionsResolution;
 
+typedef enum { kRenderInline, kRenderThread } OptionsRender;
+
 typedef struct {
     OptionsAngle angle;
     int autorun;
@@ -152,10 +157,13 @@ typedef struct {
     char fn_keys[OPTIONS_NUM_FN_KEYS][OPTIONS_MAX_FN_KEY_LEN + 1];
     int  height;
     OptionsListCase list_case;
+    OptionsRender render;
     OptionsResolution resolution;
     char search_path[STRINGSIZE];
+    bool serial_blocking;
     OptionsSimulate simulate;
     char tab;
+    bool vsync;
     int  width;
 
 #if defined OPTION_TESTS
@@ -0,0 +1,149 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+rx_ring.c
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "rx_ring.h"
+
+#include <assert.h>
+#include <string.h>
+
+// The producer's stores to 'data' must be visible before it publishes 'head'
+// and the consumer must have finished with 'data' before it publishes 'tail'.
+#define LOAD_ACQUIRE(p)      __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(p)      __atomic_load_n(p, __ATOMIC_RELAXED)
+#define STORE_RELEASE(p, v)  __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+static inline size_t min_size(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+void rx_ring_init(RxRing *ring, char *data, size_t capacity) {
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    ring->data = data;
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->waiting = false;
+}
+
+void rx_ring_clear(RxRing *ring) {
+    STORE_RELEASE(&ring->tail, LOAD_ACQUIRE(&ring->head));
+}
+
+size_t rx_ring_size(const RxRing *ring) {
+    return LOAD_ACQUIRE(&ring->head) - LOAD_ACQUIRE(&ring->tail);
+}
+
+size_t rx_ring_reserve(RxRing *ring, char **data) {
+    const size_t head = LOAD_RELAXED(&ring->head);
+    const size_t space = ring->capacity - (head - LOAD_ACQUIRE(&ring->tail));
+    const size_t start = head & (ring->capacity - 1);
+    *data = ring->data + start;
+    return min_size(space, ring->capacity - start);
+}
+
+void rx_ring_commit(RxRing *ring, size_t count) {
+    STORE_RELEASE(&ring->head, LOAD_RELAXED(&ring->head) + count);
+}
+
+size_t rx_ring_put(RxRing *ring, const char *src, size_t sz) {
+    const size_t head = LOAD_RELAXED(&ring->head);
+    const size_t space = ring->capacity - (head - LOAD_ACQUIRE(&ring->tail));
+    const size_t count = min_size(sz, space);
+    const size_t start = head & (ring->capacity - 1);
+    const size_t first = min_size(count, ring->capacity - start);
+    memcpy(ring->data + start, src, first);
+    memcpy(ring->data, src + first, count - first);
+    STORE_RELEASE(&ring->head, head + count);
+    return count;
+}
+
+size_t rx_ring_get(RxRing *ring, char *dst, size_t sz) {
+    const size_t tail = LOAD_RELAXED(&ring->tail);
+    const size_t count = min_size(sz, LOAD_ACQUIRE(&ring->head) - tail);
+    const size_t start = tail & (ring->capacity - 1);
+    const size_t first = min_size(count, ring->capacity - start);
+    memcpy(dst, ring->data + start, first);
+    memcpy(dst + first, ring->data, count - first);
+    STORE_RELEASE(&ring->tail, tail + count);
+    return count;
+}
+
+size_t rx_ring_peek(RxRing *ring, const char **data) {
+    const size_t tail = LOAD_RELAXED(&ring->tail);
+    const size_t count = LOAD_ACQUIRE(&ring->head) - tail;
+    const size_t start = tail & (ring->capacity - 1);
+    *data = ring->data + start;
+    return min_size(count, ring->capacity - start);
+}
+
+void rx_ring_consume(RxRing *ring, size_t count) {
+    STORE_RELEASE(&ring->tail, LOAD_RELAXED(&ring->tail) + count);
+}
+
+// The 'waiting' flag and the 'tail' are a Dekker style handshake; the fences
+// ensure that either the producer sees the space freed by the consumer or the
+// consumer sees that the producer is waiting, and possibly both.
+bool rx_ring_prepare_wait(RxRing *ring) {
+    __atomic_store_n(&ring->waiting, true, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (LOAD_RELAXED(&ring->head) - LOAD_ACQUIRE(&ring->tail) < ring->capacity) {
+        __atomic_store_n(&ring->waiting, false, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+bool rx_ring_producer_waiting(RxRing *ring) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return LOAD_RELAXED(&ring->waiting)
+            && __atomic_exchange_n(&ring->waiting, false, __ATOMIC_ACQ_REL);
+}
+
+int rx_ring_getc(RxRing *ring) {
+    const size_t tail = LOAD_RELAXED(&ring->tail);
+    if (LOAD_ACQUIRE(&ring->head) == tail) return -1;
+    const int ch = (unsigned char) ring->data[tail & (ring->capacity - 1)];
+    STORE_RELEASE(&ring->tail, tail + 1);
+    return ch;
+}
@@ -0,0 +1,183 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+rx_ring.h
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#if !defined(MMB4L_RX_RING_H)
+#define MMB4L_RX_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Lock-free receive ring for a single producer and a single consumer which
+ * may be on different threads, e.g. a serial port reader thread and the
+ * interpreter. Serial ports also use one to queue data for transmission.
+ *
+ * The head and tail are free-running byte counts, only the producer advances
+ * 'head' and only the consumer advances 'tail'. Unlike an RxBuf a full ring
+ * does not discard the oldest data, the producer should stop reading instead.
+ */
+typedef struct {
+    char *data;
+    size_t capacity;  // must be a power of 2.
+    size_t head;      // count of bytes written, only advanced by the producer.
+    size_t tail;      // count of bytes read, only advanced by the consumer.
+    bool waiting;     // is the producer waiting for the consumer to free space?
+} RxRing;
+
+/**
+ * Initialises an RxRing structure.
+ *
+ * @param  ring      pointer to the ring.
+ * @param  data      character buffer to encapsulate.
+ * @param  capacity  size of 'data' buffer, must be a power of 2.
+ */
+void rx_ring_init(RxRing *ring, char *data, size_t capacity);
+
+/**
+ * Discards the contents of the ring; must only be called by the consumer.
+ *
+ * @param  ring  pointer to the ring.
+ */
+void rx_ring_clear(RxRing *ring);
+
+/**
+ * Gets the number of bytes in the ring.
+ *
+ * @param  ring  pointer to the ring.
+ * @return       the number of bytes in the ring.
+ */
+size_t rx_ring_size(const RxRing *ring);
+
+/**
+ * Gets the largest contiguous free region of the ring so that the producer
+ * can fill it directly, e.g. with read(); follow with rx_ring_commit().
+ *
+ * @param  ring  pointer to the ring.
+ * @param[out]  data  on exit, pointer to the free region.
+ * @return       size of the free region, 0 if the ring is full.
+ */
+size_t rx_ring_reserve(RxRing *ring, char **data);
+
+/**
+ * Publishes bytes written into a region returned by rx_ring_reserve().
+ *
+ * @param  ring   pointer to the ring.
+ * @param  count  number of bytes written, no more than reserved.
+ */
+void rx_ring_commit(RxRing *ring, size_t count);
+
+/**
+ * Copies bytes onto the end of the ring; must only be called by the producer.
+ *
+ * @param  ring  pointer to the ring.
+ * @param  src   bytes to copy.
+ * @param  sz    number of bytes to copy.
+ * @return       number of bytes copied, less than 'sz' if the ring filled.
+ */
+size_t rx_ring_put(RxRing *ring, const char *src, size_t sz);
+
+/**
+ * Copies bytes from the front of the ring; must only be called by the
+ * consumer.
+ *
+ * @param  ring  pointer to the ring.
+ * @param  dst   buffer to copy into.
+ * @param  sz    maximum number of bytes to copy.
+ * @return       number of bytes copied, less than 'sz' if the ring emptied.
+ */
+size_t rx_ring_get(RxRing *ring, char *dst, size_t sz);
+
+/**
+ * Gets the largest contiguous region of data at the front of the ring so that
+ * the consumer can drain it directly, e.g. with write(); follow with
+ * rx_ring_consume().
+ *
+ * @param  ring  pointer to the ring.
+ * @param[out]  data  on exit, pointer to the data.
+ * @return       size of the region, 0 if the ring is empty.
+ */
+size_t rx_ring_peek(RxRing *ring, const char **data);
+
+/**
+ * Discards bytes from the front of the ring that were returned by
+ * rx_ring_peek().
+ *
+ * @param  ring   pointer to the ring.
+ * @param  count  number of bytes to discard, no more than peeked.
+ */
+void rx_ring_consume(RxRing *ring, size_t count);
+
+/**
+ * Announces that the producer is about to block until the consumer frees
+ * space in the full ring; must only be called by the producer.
+ *
+ * If the consumer has already freed space then the announcement is withdrawn,
+ * otherwise the consumer is guaranteed to see it after its next take, see
+ * rx_ring_producer_waiting().
+ *
+ * @param  ring  pointer to the ring.
+ * @return       true if the ring is still full and the producer should block,
+ *               false if it should try again immediately.
+ */
+bool rx_ring_prepare_wait(RxRing *ring);
+
+/**
+ * Checks whether the producer is blocked waiting for space, clearing the flag
+ * set by rx_ring_prepare_wait(); must only be called by the consumer after it
+ * has taken data from the ring.
+ *
+ * @param  ring  pointer to the ring.
+ * @return       true if the producer is waiting and should be woken.
+ */
+bool rx_ring_producer_waiting(RxRing *ring);
+
+/**
+ * Gets a character from the ring; must only be called by the consumer.
+ *
+ * @param  ring  pointer to the ring.
+ * @return       the next character, or -1 if the ring is empty.
+ */
+int rx_ring_getc(RxRing *ring);
+
+#endif // #if !defined(MMB4L_RX_RING_H)
@@ -0,0 +1,120 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+scheduler.c
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "scheduler.h"
+#include "mmtime.h"
+
+#include <stddef.h>
+#include <strings.h>
+
+SchedulerTask scheduler_tasks[SCHEDULER_MAX_TASKS];
+int scheduler_count = 0;
+uint64_t scheduler_polls = 0;
+
+/** Earliest time at which any task is due to run. */
+static int64_t scheduler_earliest_due_ns = INT64_MAX;
+
+MmResult scheduler_add(const char *name, void (*fn)(void), int64_t period_ns, bool input) {
+    if (!fn || period_ns < 0) return kInternalFault;
+    if (scheduler_count == SCHEDULER_MAX_TASKS) return kContainerFull;
+
+    SchedulerTask *task = &scheduler_tasks[scheduler_count++];
+    task->name = name;
+    task->fn = fn;
+    task->period_ns = period_ns;
+    task->input = input;
+    task->due_ns = INT64_MIN;
+    task->runs = 0;
+    scheduler_earliest_due_ns = INT64_MIN;
+    return kOk;
+}
+
+void scheduler_clear(void) {
+    scheduler_count = 0;
+    scheduler_polls = 0;
+    scheduler_earliest_due_ns = INT64_MAX;
+}
+
+SchedulerTask *scheduler_find(const char *name) {
+    for (int i = 0; i < scheduler_count; ++i) {
+        if (strcasecmp(scheduler_tasks[i].name, name) == 0) return &scheduler_tasks[i];
+    }
+    return NULL;
+}
+
+int64_t scheduler_next_due_ns(bool include_input) {
+    int64_t next_due_ns = INT64_MAX;
+    for (int i = 0; i < scheduler_count; ++i) {
+        const SchedulerTask *task = &scheduler_tasks[i];
+        if (task->input && !include_input) continue;
+        if (task->due_ns < next_due_ns) next_due_ns = task->due_ns;
+    }
+    return next_due_ns;
+}
+
+void scheduler_run(int64_t now_ns) {
+    if (now_ns < scheduler_earliest_due_ns) return;
+
+    // If a task longjmps out then the next call should rescan the table.
+    scheduler_earliest_due_ns = now_ns;
+
+    int64_t next_due_ns = INT64_MAX;
+    for (int i = 0; i < scheduler_count; ++i) {
+        SchedulerTask *task = &scheduler_tasks[i];
+        if (now_ns >= task->due_ns) {
+            // Update the task before running it in case it longjmps out.
+            task->due_ns = now_ns + task->period_ns;
+            task->runs++;
+            task->fn();
+        }
+        if (task->due_ns < next_due_ns) next_due_ns = task->due_ns;
+    }
+
+    scheduler_earliest_due_ns = next_due_ns;
+}
+
+void scheduler_poll(void) {
+    scheduler_polls++;
+    scheduler_run(mmtime_monotonic_ns());
+}
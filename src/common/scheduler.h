@@ -0,0 +1,134 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+scheduler.h
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#if !defined(MMB4L_SCHEDULER_H)
+#define MMB4L_SCHEDULER_H
+
+#include "mmresult.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS  8
+
+/**
+ * Structure of elements in the background task table.
+ *
+ * Each entry records a "background" task, e.g. pumping the console for input,
+ * and the minimum period between successive runs of that task.
+ */
+typedef struct {
+    const char *name;       // Name reported by MM.INFO(BACKGROUND name).
+    void (*fn)(void);       // Function to call to perform the task.
+    int64_t period_ns;      // Minimum period between runs, 0 to run on every
+                            // poll.
+    bool input;             // Task only has work when a file descriptor is
+                            // readable, so waits need not wake for it.
+    int64_t due_ns;         // Time the task is next due to run.
+    uint64_t runs;          // Number of times the task has been run.
+} SchedulerTask;
+
+/** Table of background tasks. */
+extern SchedulerTask scheduler_tasks[SCHEDULER_MAX_TASKS];
+
+/** The number of entries in the \p scheduler_tasks. */
+extern int scheduler_count;
+
+/** The number of calls to scheduler_poll(). */
+extern uint64_t scheduler_polls;
+
+/**
+ * @brief  Adds a task to the scheduler.
+ *
+ * The new task is due to run on the next poll.
+ *
+ * @param  name       Name of the task, this must be a string literal.
+ * @param  fn         Function to call to perform the task.
+ * @param  period_ns  Minimum period between runs in nanoseconds.
+ * @param  input      Does the task only have work when a file descriptor is
+ *                    readable ?
+ * @return            kOk             - on success.
+ *                    kContainerFull  - if the task table is full.
+ *                    kInternalFault  - if \p fn is NULL or \p period_ns is
+ *                                      negative.
+ */
+MmResult scheduler_add(const char *name, void (*fn)(void), int64_t period_ns, bool input);
+
+/** @brief  Removes all the tasks from the scheduler and resets its counters. */
+void scheduler_clear(void);
+
+/**
+ * @brief  Finds a task by name (case-insensitive).
+ *
+ * @return  The task, or NULL if there is no such task.
+ */
+SchedulerTask *scheduler_find(const char *name);
+
+/**
+ * @brief  Gets the time the next task is due to run.
+ *
+ * @param  include_input  Include tasks that only have work when a file
+ *                        descriptor is readable ?
+ * @return                Time from mmtime_monotonic_ns(), or INT64_MAX if
+ *                        there are no such tasks.
+ */
+int64_t scheduler_next_due_ns(bool include_input);
+
+/**
+ * @brief  Runs any tasks that are due at the given time.
+ *
+ * This is cheap when no task is due, a single comparison, so it may be
+ * called after every statement.
+ *
+ * Tasks may longjmp() out of this function, e.g. to report an error, in which
+ * case the remaining tasks will be considered on the next call.
+ *
+ * @param  now_ns  Current time from mmtime_monotonic_ns().
+ */
+void scheduler_run(int64_t now_ns);
+
+/** @brief  Runs any tasks that are due now. */
+void scheduler_poll(void);
+
+#endif // #if !defined(MMB4L_SCHEDULER_H)
@@ -45,8 +45,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <termios.h>
@@ -56,6 +59,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "error.h"
 #include "file.h"
 #include "interrupt.h"
+#include "mmtime.h"
+#include "rx_ring.h"
 #include "serial.h"
 #include "utility.h"
 
@@ -65,6 +70,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define ERROR_COM_SPECIFICATION        error_throw_ex(kError, "COM specification")
 #define ERROR_UNSUPPORTED_BAUDRATE(i)  error_throw_ex(kError, "Unsupported baudrate: %", i)
+#define ERROR_TX_BUFFER_FULL           error_throw_ex(kError, "Serial transmit buffer full")
+
+/** How long to wait for a port to become writable between checks for Ctrl-C. */
+#define SERIAL_TX_WAIT_MS  100
+
+/**
+ * How long CLOSE waits for queued output to make progress before discarding
+ * it, e.g. because flow control is holding the line or the device has gone.
+ */
+#define SERIAL_CLOSE_STALL_MS  1000
 
 typedef enum { PARITY_NONE, PARITY_EVEN, PARITY_ODD } Parity;
 
@@ -77,10 +92,28 @@ typedef struct {
     bool rtscts;
     bool s2;
     bool xonxoff;
+    bool thread;
     const char *rx_interrupt_addr;
     int64_t rx_interrupt_count;
 } ComSpec;
 
+typedef struct {
+    RxRing rx_ring;
+    RxRing tx_ring;    // Output waiting to be written to the device, this is
+                       // only accessed by the interpreter.
+    bool threaded;     // Is input read by a dedicated thread rather than by
+                       // the interpreter calling serial_pump_input() ?
+    pthread_t thread;
+    int fd;            // Copy of the FileEntry's 'serial_fd' for the thread.
+    int wake_fd;       // eventfd signalled by the thread when it receives data.
+    int stop_fd;       // eventfd signalled to stop the thread.
+    int space_fd;      // eventfd signalled by the interpreter when it takes
+                       // data from a full receive ring.
+    int rx_errno;      // errno from a failed read on the thread, 0 if none.
+} SerialPort;
+
+static SerialPort serial_ports[MAXOPENFILES + 1];
+
 static speed_t serial_int_to_speed(int64_t i) {
     switch (i) {
         case      50: return      B50;
@@ -171,10 +204,11 @@ static void serial_dump_spec(ComSpec *comspec) {
     printf("RTS/CTS:            %s\n", comspec->rtscts ? "true" : "false");
     printf("S2:                 %s\n", comspec->s2 ? "true" : "false");
     printf("XON/XOFF:           %s\n", comspec->xonxoff ? "true" : "false");
+    printf("Thread:             %s\n", comspec->thread ? "true" : "false");
 }
 
 void serial_parse_comspec(const char* comspec_str, ComSpec *comspec) {
-    getargs(&comspec_str, 21, ":,");
+    getargs(&comspec_str, 23, ":,");
     if (argc != 2 && (argc & 0x01) == 0) ERROR_COM_SPECIFICATION;
 
     memset(comspec, 0, sizeof(ComSpec));
@@ -183,7 +217,7 @@ void serial_parse_comspec(const char* comspec_str, ComSpec *comspec) {
     comspec->rx_interrupt_count = COM_DEFAULT_INTERRUPT_COUNT;
     strcpy(comspec->device, argv[0]);
 
-    for (int i = 0; i < 6; i++) {
+    for (int i = 0; i < 7; i++) {
         if (strcasecmp(argv[argc - 1], "OC") == 0) { // Open collector option.
             ERROR_UNSUPPORTED_FLAG("OC");
         }
@@ -231,6 +265,11 @@ void serial_parse_comspec(const char* comspec_str, ComSpec *comspec) {
             comspec->xonxoff = true;
             argc -= 2;
         }
+
+        else if (strcasecmp(argv[argc - 1], "THREAD") == 0) { // Dedicated reader thread option.
+            comspec->thread = true;
+            argc -= 2;
+        }
     }
 
     if (argc < 1 || argc > 11) ERROR_COM_SPECIFICATION;
@@ -245,6 +284,7 @@ void serial_parse_comspec(const char* comspec_str, ComSpec *comspec) {
     // Buffer size as a number.
     if (argc >= 5 && *argv[4]) {
         comspec->bufsize = getinteger(argv[4]);
+        if (comspec->bufsize < 1) ERROR_COM_SPECIFICATION;
     }
 
     // Received data interrupt location.
@@ -264,6 +304,89 @@ void serial_parse_comspec(const char* comspec_str, ComSpec *comspec) {
     }
 }
 
+/** Reads from the serial port into its receive ring until signalled to stop. */
+static void *serial_reader_thread(void *arg) {
+    SerialPort *port = (SerialPort *) arg;
+    struct pollfd fds[3] = {
+        { port->fd, POLLIN, 0 },
+        { port->stop_fd, POLLIN, 0 },
+        { port->space_fd, POLLIN, 0 } };
+    const uint64_t one = 1;
+    for (;;) {
+        char *data;
+        size_t space = rx_ring_reserve(&port->rx_ring, &data);
+        if (space == 0) {
+            // Leave the data with the device driver until the interpreter
+            // has caught up and signals that it has freed some space.
+            if (!rx_ring_prepare_wait(&port->rx_ring)) continue;
+            if (poll(fds + 1, 2, -1) == -1) {
+                if (errno == EINTR) continue;
+                __atomic_store_n(&port->rx_errno, errno, __ATOMIC_RELEASE);
+                break;
+            }
+            if (fds[1].revents) break;
+            uint64_t signals;
+            if (read(port->space_fd, &signals, sizeof(signals)) == -1) {
+                // EAGAIN, the ring is checked again regardless.
+            }
+            continue;
+        }
+
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR) continue;
+            __atomic_store_n(&port->rx_errno, errno, __ATOMIC_RELEASE);
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!fds[0].revents) continue;
+
+        ssize_t count = read(port->fd, data, space);
+        if (count > 0) {
+            rx_ring_commit(&port->rx_ring, (size_t) count);
+        } else if (count == -1 && (errno == EINTR || errno == EAGAIN)) {
+            continue;
+        } else {
+            // Readable but no data means the device has gone away.
+            __atomic_store_n(&port->rx_errno, count == 0 ? EIO : errno, __ATOMIC_RELEASE);
+        }
+        if (write(port->wake_fd, &one, sizeof(one)) == -1) {
+            // Nothing can be done, the interpreter will still see the data
+            // the next time it checks the port.
+        }
+        if (__atomic_load_n(&port->rx_errno, __ATOMIC_ACQUIRE)) break;
+    }
+    return NULL;
+}
+
+/** Starts the reader thread for a serial port, returning 0 or an errno. */
+static int serial_start_thread(SerialPort *port) {
+    port->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    port->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    port->space_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int err = (port->wake_fd == -1 || port->stop_fd == -1 || port->space_fd == -1) ? errno : 0;
+    if (!err) err = pthread_create(&port->thread, NULL, serial_reader_thread, port);
+    if (err) {
+        if (port->wake_fd != -1) close(port->wake_fd);
+        if (port->stop_fd != -1) close(port->stop_fd);
+        if (port->space_fd != -1) close(port->space_fd);
+        return err;
+    }
+    port->threaded = true;
+    return 0;
+}
+
+static void serial_stop_thread(SerialPort *port) {
+    const uint64_t one = 1;
+    if (write(port->stop_fd, &one, sizeof(one)) == -1) {
+        // An eventfd write can only fail if the counter would overflow.
+    }
+    pthread_join(port->thread, NULL);
+    close(port->wake_fd);
+    close(port->stop_fd);
+    close(port->space_fd);
+    port->threaded = false;
+}
+
 MmResult serial_open(const char *comspec_str, int fnbr) {
     if (fnbr < 1 || fnbr > MAXOPENFILES) return kFileInvalidFileNumber;
     FileEntry *entry = &(file_table[fnbr]);
@@ -277,7 +400,9 @@ MmResult serial_open(const char *comspec_str, int fnbr) {
     int fd = open(comspec.device, O_RDWR | O_NOCTTY); //  | O_NDELAY);
     if (fd == -1) error_throw(errno);
 
-    if (fcntl(fd, F_SETFL, 0) == -1) error_throw(errno);
+    // Non-blocking so that queued output can be written in as large chunks
+    // as the device driver will accept without stalling the interpreter.
+    if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1) error_throw(errno);
 
     struct termios options;
     if (FAILED(tcgetattr(fd, &options))) error_throw(errno);
@@ -347,48 +472,163 @@ MmResult serial_open(const char *comspec_str, int fnbr) {
     // mmtime_sleep_ns(MILLISECONDS_TO_NANOSECONDS(1000));
     // if (FAILED(tcflush(fd, TCIOFLUSH))) error_throw(errno);
 
+    // The receive and transmit rings' capacities must be a power of 2.
+    size_t capacity = 1;
+    while (capacity < (size_t) comspec.bufsize) capacity <<= 1;
+    SerialPort *port = &serial_ports[fnbr];
+    memset(port, 0, sizeof(SerialPort));
+    port->fd = fd;
+    char *data = GetMemory(2 * capacity);
+    rx_ring_init(&port->rx_ring, data, capacity);
+    rx_ring_init(&port->tx_ring, data + capacity, capacity);
+
+    if (comspec.thread) {
+        int err = serial_start_thread(port);
+        if (err) {
+            FreeMemory(data);
+            close(fd);
+            error_throw(err);
+        }
+    }
+
     entry->type = fet_serial;
     entry->serial_fd = fd;
     if (comspec.rx_interrupt_addr) {
         interrupt_enable_serial_rx(fnbr, comspec.rx_interrupt_count, comspec.rx_interrupt_addr);
     }
 
-    char *data = GetMemory(comspec.bufsize); // Should already be zeroed.
-    rx_buf_init(&(entry->rx_buf), data, comspec.bufsize);
-
     return kOk;
 }
 
+/**
+ * Writes as much queued output as the device driver will accept without
+ * blocking.
+ *
+ * @return  0 on success, otherwise an errno.
+ */
+static int serial_drain(SerialPort *port) {
+    const char *data;
+    size_t sz;
+    while ((sz = rx_ring_peek(&port->tx_ring, &data)) > 0) {
+        ssize_t count = write(port->fd, data, sz);
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN ? 0 : errno;
+        }
+        rx_ring_consume(&port->tx_ring, (size_t) count);
+        if ((size_t) count < sz) break;
+    }
+    return 0;
+}
+
+/** Waits for the device driver to accept more output, checking for Ctrl-C. */
+static void serial_wait_writable(SerialPort *port) {
+    struct pollfd fds = { port->fd, POLLOUT, 0 };
+    errno = 0;
+    if (poll(&fds, 1, SERIAL_TX_WAIT_MS) == -1 && errno != EINTR) error_throw(errno);
+    CheckAbort();
+}
+
 MmResult serial_close(int fnbr) {
     FileEntry *entry = &(file_table[fnbr]);
     assert(entry->type == fet_serial);
+    SerialPort *port = &serial_ports[fnbr];
+    if (port->threaded) serial_stop_thread(port);
+
+    // Write any remaining output before closing, as the unbuffered
+    // implementation would have done, but give up if the line stalls. This is
+    // also called by CloseAllFiles() when handling an error or exiting so it
+    // cannot throw, and errors are ignored because the port is being closed
+    // regardless.
+    int64_t deadline = mmtime_monotonic_ns() + SERIAL_CLOSE_STALL_MS * 1000000LL;
+    size_t remaining = rx_ring_size(&port->tx_ring);
+    while (remaining > 0 && serial_drain(port) == 0) {
+        const size_t left = rx_ring_size(&port->tx_ring);
+        if (left == 0) break;
+        const int64_t now = mmtime_monotonic_ns();
+        if (left < remaining) {
+            deadline = now + SERIAL_CLOSE_STALL_MS * 1000000LL;
+        } else if (now >= deadline) {
+            break;
+        }
+        remaining = left;
+        struct pollfd fds = { port->fd, POLLOUT, 0 };
+        poll(&fds, 1, SERIAL_TX_WAIT_MS);
+    }
     close(entry->serial_fd);
     entry->type = fet_closed;
     entry->serial_fd = 0;
-    FreeMemory(entry->rx_buf.data);
+    FreeMemory(port->rx_ring.data);
+    port->rx_ring.data = NULL;
+    port->tx_ring.data = NULL;
     interrupt_disable_serial_rx(fnbr);
     return kOk;
 }
 
+MmResult serial_flush(int fnbr) {
+    assert(file_table[fnbr].type == fet_serial);
+    SerialPort *port = &serial_ports[fnbr];
+    for (;;) {
+        int err = serial_drain(port);
+        if (err) return err;
+        if (rx_ring_size(&port->tx_ring) == 0) return kOk;
+        serial_wait_writable(port);
+    }
+}
+
+void serial_pump_output(int fnbr) {
+    assert(file_table[fnbr].type == fet_serial);
+    int err = serial_drain(&serial_ports[fnbr]);
+    if (err) error_throw(err);
+}
+
 void serial_pump_input(int fnbr) {
     assert(file_table[fnbr].type == fet_serial);
+    SerialPort *port = &serial_ports[fnbr];
 
-    char tmp[256];
-    errno = 0;
-    ssize_t count = read(file_table[fnbr].serial_fd, tmp, 256);
-    if (count == -1) error_throw(errno);
+    // Send any queued output first, callers may be waiting for a reply to it.
+    serial_pump_output(fnbr);
+
+    if (port->threaded) {
+        // The thread has already put any input into the ring, just
+        // acknowledge its wakeup and report any error it encountered.
+        uint64_t count;
+        errno = 0;
+        if (read(port->wake_fd, &count, sizeof(count)) == -1 && errno != EAGAIN) {
+            error_throw(errno);
+        }
+        const int err = __atomic_load_n(&port->rx_errno, __ATOMIC_ACQUIRE);
+        if (err) error_throw(err);
+        return;
+    }
 
-    if (count > 0) {
-        for (ssize_t i = 0; i < count; ++i) {
-            rx_buf_put(&file_table[fnbr].rx_buf, tmp[i]);
+    // Read directly into the free space in the ring, this takes two reads
+    // if the free space wraps around the end of the ring.
+    char *data;
+    size_t space;
+    while ((space = rx_ring_reserve(&port->rx_ring, &data)) > 0) {
+        errno = 0;
+        ssize_t count = read(file_table[fnbr].serial_fd, data, space);
+        if (count == -1) {
+            if (errno == EAGAIN || errno == EINTR) break;
+            error_throw(errno);
         }
+        rx_ring_commit(&port->rx_ring, (size_t) count);
+        if ((size_t) count < space) break;
     }
 }
 
+int serial_wait_fd(int fnbr) {
+    assert(file_table[fnbr].type == fet_serial);
+    const SerialPort *port = &serial_ports[fnbr];
+    return port->threaded ? port->wake_fd : file_table[fnbr].serial_fd;
+}
+
 int serial_eof(int fnbr) {
-    if (rx_buf_size(&file_table[fnbr].rx_buf) > 0) return 0;
+    RxRing *ring = &serial_ports[fnbr].rx_ring;
+    if (rx_ring_size(ring) > 0) return 0;
     serial_pump_input(fnbr);
-    return (rx_buf_size(&file_table[fnbr].rx_buf) > 0) ? 0 : 1;
+    return (rx_ring_size(ring) > 0) ? 0 : 1;
 
     // Alternative:
     // errno = 0;
@@ -397,52 +637,90 @@ int serial_eof(int fnbr) {
     // return count ? 0 : 1;
 }
 
+/**
+ * Takes up to 'sz' bytes from the receive ring, waking the reader thread if
+ * it is waiting for the ring to stop being full.
+ */
+static size_t serial_take(SerialPort *port, char *buf, size_t sz) {
+    RxRing *ring = &port->rx_ring;
+    const size_t count = rx_ring_get(ring, buf, sz);
+    if (count > 0 && port->threaded && rx_ring_producer_waiting(ring)) {
+        const uint64_t one = 1;
+        if (write(port->space_fd, &one, sizeof(one)) == -1) {
+            // An eventfd write can only fail if the counter would overflow.
+        }
+    }
+    return count;
+}
+
 int serial_getc(int fnbr) {
-    int ch = rx_buf_get(&file_table[fnbr].rx_buf);
-    if (ch == -1) {
+    SerialPort *port = &serial_ports[fnbr];
+    char c;
+    if (serial_take(port, &c, 1) == 0) {
         serial_pump_input(fnbr);
-        ch = rx_buf_get(&file_table[fnbr].rx_buf);
+        if (serial_take(port, &c, 1) == 0) return -1;
     }
-    return ch;
+    return (unsigned char) c;
 }
 
-int serial_putc(int fnbr, int ch) {
+size_t serial_read(int fnbr, char *buf, size_t sz) {
     assert(file_table[fnbr].type == fet_serial);
-    errno = 0;
-    ssize_t count = write(file_table[fnbr].serial_fd, &ch, 1);
-    switch (count) {
-        case -1:
-            error_throw(errno);
-            break;
-        case 1:
-            return 1;
-            break;
-        default:
-            error_throw(EBADF);
-            break;
+    SerialPort *port = &serial_ports[fnbr];
+    size_t count = serial_take(port, buf, sz);
+    if (count < sz) {
+        serial_pump_input(fnbr);
+        count += serial_take(port, buf + count, sz - count);
     }
+    return count;
+}
 
-    assert(false);
-    return -1;
+int serial_putc(int fnbr, int ch) {
+    const char c = (char) ch;
+    return serial_write(fnbr, &c, 1);
 }
 
 int serial_rx_queue_size(int fnbr) {
     assert(file_table[fnbr].type == fet_serial);
-    return rx_buf_size(&file_table[fnbr].rx_buf);
+    return (int) rx_ring_size(&serial_ports[fnbr].rx_ring);
+}
+
+int serial_tx_queue_size(int fnbr) {
+    assert(file_table[fnbr].type == fet_serial);
+    return (int) rx_ring_size(&serial_ports[fnbr].tx_ring);
+}
+
+int serial_tx_space(int fnbr) {
+    assert(file_table[fnbr].type == fet_serial);
+    const RxRing *ring = &serial_ports[fnbr].tx_ring;
+    return (int) (ring->capacity - rx_ring_size(ring));
 }
 
 int serial_write(int fnbr, const char *buf, size_t sz) {
     assert(file_table[fnbr].type == fet_serial);
-    errno = 0;
-    ssize_t count = write(file_table[fnbr].serial_fd, buf, sz);
-    if (count == (ssize_t) sz) {
+    SerialPort *port = &serial_ports[fnbr];
+
+    if (!mmb_options.serial_blocking) {
+        // All or nothing, so a program that checks LOF() never sends a
+        // partial message.
+        if (sz > port->tx_ring.capacity - rx_ring_size(&port->tx_ring)) {
+            serial_pump_output(fnbr);
+            if (sz > port->tx_ring.capacity - rx_ring_size(&port->tx_ring)) {
+                ERROR_TX_BUFFER_FULL;
+            }
+        }
+        rx_ring_put(&port->tx_ring, buf, sz);
         return sz;
-    } else if (count == -1) {
-        error_throw(errno);
-    } else {
-        error_throw(EBADF);
     }
 
-    assert(false);
-    return -1;
+    // The output is only queued, it is written in bulk by the SERIAL
+    // background task or when the port is next pumped for input.
+    size_t count = rx_ring_put(&port->tx_ring, buf, sz);
+    while (count < sz) {
+        serial_pump_output(fnbr);
+        if (rx_ring_size(&port->tx_ring) == port->tx_ring.capacity) {
+            serial_wait_writable(port);
+        }
+        count += rx_ring_put(&port->tx_ring, buf + count, sz - count);
+    }
+    return sz;
 }
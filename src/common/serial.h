@@ -47,13 +47,60 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "mmresult.h"
 
+#include <stddef.h>
+
 MmResult serial_open(const char *comspec, int fnbr);
 MmResult serial_close(int fnbr);
 int serial_eof(int fnbr);
+
+/**
+ * Writes all the output queued for the serial port, waiting for the device
+ * driver to accept it if necessary.
+ */
+MmResult serial_flush(int fnbr);
 int serial_getc(int fnbr);
+
+/**
+ * Pumps the serial port for input, first writing any queued output that the
+ * device driver will accept without blocking.
+ */
 void serial_pump_input(int fnbr);
+
+/** Writes any queued output that the device driver will accept without blocking. */
+void serial_pump_output(int fnbr);
 int serial_putc(int fnbr, int ch);
+
+/**
+ * Copies up to 'sz' bytes from the serial port's receive buffer, pumping the
+ * port for input if the buffer does not already hold enough.
+ *
+ * @return  the number of bytes copied, 0 if there was nothing to read.
+ */
+size_t serial_read(int fnbr, char *buf, size_t sz);
 int serial_rx_queue_size(int fnbr);
+
+/**
+ * Gets the file descriptor to poll() for input on the serial port, this is
+ * signalled by the reader thread if the port was opened with the THREAD flag.
+ * When it is readable call serial_pump_input().
+ */
+int serial_wait_fd(int fnbr);
+
+/** Gets the number of bytes queued for output that are yet to be written to the device. */
+int serial_tx_queue_size(int fnbr);
+
+/** Gets the number of bytes that can be queued for output without waiting. */
+int serial_tx_space(int fnbr);
+
+/**
+ * Queues bytes for output on the serial port.
+ *
+ * If the transmit buffer fills then with OPTION SERIAL BLOCKING ON this waits
+ * for the device driver to accept the excess, with it OFF it reports an
+ * error without queuing any of the bytes.
+ *
+ * @return  'sz'.
+ */
 int serial_write(int fnbr, const char *buf, size_t sz);
 
 #endif
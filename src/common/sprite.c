@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 
 #include "bitset.h"
 #include "error.h"
@@ -57,10 +58,106 @@ Stack sprite_z_stack;
 static bool sprite_initialised = false;
 static bool sprite_all_hidden = false;
 
+////////////////////////////////////////////////////////////////////////////////
+// Uniform-grid broadphase for sprite collision detection.
+//
+// Each cell records the ids of the sprites whose bounding box, including the
+// one pixel "touching" margin on the right and bottom, intersects it. Sprites
+// beyond the extent of the grid are clamped into its outermost cells so every
+// pair of sprites that can collide shares at least one cell.
+////////////////////////////////////////////////////////////////////////////////
+#define SPRITE_GRID_SHIFT  6  // 64 x 64 pixel cells.
+#define SPRITE_GRID_COLS   32
+#define SPRITE_GRID_ROWS   32
+#define SPRITE_GRID_WORDS  (GRAPHICS_MAX_SURFACES / 64)
+
+typedef struct {
+    int8_t x0, y0, x1, y1;  // Inclusive range of cells; x0 == -1 if not in the grid.
+} SpriteGridRect;
+
+static uint64_t sprite_grid[SPRITE_GRID_ROWS][SPRITE_GRID_COLS][SPRITE_GRID_WORDS];
+static SpriteGridRect sprite_grid_rects[GRAPHICS_MAX_SURFACES];
+
+static void sprite_grid_clear() {
+    memset(sprite_grid, 0, sizeof(sprite_grid));
+    for (MmSurfaceId id = 0; id <= GRAPHICS_MAX_ID; ++id) sprite_grid_rects[id].x0 = -1;
+}
+
+static inline int8_t sprite_grid_cell(int v, int count) {
+    if (v < 0) return 0;
+    v >>= SPRITE_GRID_SHIFT;
+    return (int8_t) (v < count ? v : count - 1);
+}
+
+static inline SpriteGridRect sprite_grid_rect(const MmSurface *sprite) {
+    return (SpriteGridRect) {
+        sprite_grid_cell(sprite->x, SPRITE_GRID_COLS),
+        sprite_grid_cell(sprite->y, SPRITE_GRID_ROWS),
+        sprite_grid_cell(sprite->x + sprite->width, SPRITE_GRID_COLS),
+        sprite_grid_cell(sprite->y + sprite->height, SPRITE_GRID_ROWS) };
+}
+
+static void sprite_grid_mark(const SpriteGridRect *rect, MmSurfaceId id, bool in_cell) {
+    const uint64_t bit = (uint64_t) 1 << (id % 64);
+    for (int gy = rect->y0; gy <= rect->y1; ++gy) {
+        for (int gx = rect->x0; gx <= rect->x1; ++gx) {
+            uint64_t *word = &sprite_grid[gy][gx][id / 64];
+            *word = in_cell ? (*word | bit) : (*word & ~bit);
+        }
+    }
+}
+
+/** Removes a sprite from the grid. */
+static inline void sprite_grid_remove(const MmSurface *sprite) {
+    SpriteGridRect *rect = &sprite_grid_rects[sprite->id];
+    if (rect->x0 == -1) return;
+    sprite_grid_mark(rect, sprite->id, false);
+    rect->x0 = -1;
+}
+
+/** Adds a sprite to the grid, or moves it if its position has changed. */
+static inline void sprite_grid_update(const MmSurface *sprite) {
+    SpriteGridRect *rect = &sprite_grid_rects[sprite->id];
+    const SpriteGridRect new_rect = sprite_grid_rect(sprite);
+    if (rect->x0 == new_rect.x0 && rect->y0 == new_rect.y0
+            && rect->x1 == new_rect.x1 && rect->y1 == new_rect.y1) {
+        return;
+    }
+    if (rect->x0 != -1) sprite_grid_mark(rect, sprite->id, false);
+    *rect = new_rect;
+    sprite_grid_mark(rect, sprite->id, true);
+}
+
+/**
+ * Brings the grid up to date for any sprite on the Z-order stack whose
+ * position has been assigned directly rather than via the functions in
+ * this file; when there are none this is just a comparison per sprite.
+ */
+static void sprite_grid_sync() {
+    const MmSurfaceId *base = (MmSurfaceId *) sprite_z_stack.storage;
+    const MmSurfaceId *top = (MmSurfaceId *) sprite_z_stack.top;
+    for (const MmSurfaceId *pid = base; pid < top; ++pid) {
+        sprite_grid_update(&graphics_surfaces[*pid]);
+    }
+}
+
+/** Gets the ids of all the sprites sharing a grid cell with a given sprite, including itself. */
+static void sprite_grid_candidates(const MmSurface *sprite, uint64_t *candidates) {
+    memset(candidates, 0, SPRITE_GRID_WORDS * sizeof(uint64_t));
+    const SpriteGridRect *rect = &sprite_grid_rects[sprite->id];
+    if (rect->x0 == -1) return;
+    for (int gy = rect->y0; gy <= rect->y1; ++gy) {
+        for (int gx = rect->x0; gx <= rect->x1; ++gx) {
+            for (int w = 0; w < SPRITE_GRID_WORDS; ++w) candidates[w] |= sprite_grid[gy][gx][w];
+        }
+    }
+}
+
 MmResult sprite_init() {
     if (sprite_initialised) return kOk;
     ON_FAILURE_RETURN(stack_init(&sprite_z_stack, MmSurfaceId, GRAPHICS_MAX_SURFACES, NULL);)
     sprite_all_hidden = false;
+    sprite_grid_clear();
     sprite_initialised = true;
     sprite_last_collision = SPRITE_NO_COLLISION;
     return kOk;
@@ -244,6 +341,7 @@ static inline MmResult sprite_hide_internal(MmSurface *sprite, MmSurface *dst_su
 
     ON_FAILURE_RETURN(sprite_render_background(sprite, dst_surface));
     ON_FAILURE_RETURN(stack_remove(&sprite_z_stack, sprite->id));
+    sprite_grid_remove(sprite);
     sprite->x = GRAPHICS_OFF_SCREEN;
     sprite->y = GRAPHICS_OFF_SCREEN;
     sprite->layer = 0xFF;
@@ -345,6 +443,7 @@ static inline void sprite_update_position(MmSurface *sprite) {
         sprite->y = sprite->next_y;
         sprite->next_y = GRAPHICS_OFF_SCREEN;
     }
+    sprite_grid_update(sprite);
 }
 
 static inline MmResult sprite_update_all_positions() {
@@ -425,16 +524,20 @@ static inline bool sprite_check_for_sprite_collision(MmSurface *sprite, MmSurfac
 }
 
 static inline void sprite_clear_collisions(MmSurface *sprite) {
-    // Clear this sprites collisions with other sprites.
-    bitset_reset(sprite->sprite_collisions, 256);
-
     // Clear other sprite's collisions with this sprite.
-    // There may be more 'elegant' ways to do this, but I suspect just clearing the appropriate bit
-    // for all surfaces without any checking logic may be fastest.
-    for (MmSurfaceId id = 0; id < GRAPHICS_MAX_ID; ++id) {
-        bitset_clear(graphics_surfaces[id].sprite_collisions, sprite->id);
+    // Collisions are always recorded in both sprites so only those sprites this sprite has
+    // collided with need updating.
+    const uint64_t *collisions = (const uint64_t *) sprite->sprite_collisions;
+    for (int w = 0; w < SPRITE_GRID_WORDS; ++w) {
+        for (uint64_t bits = collisions[w]; bits; bits &= bits - 1) {
+            const MmSurfaceId id = w * 64 + __builtin_ctzll(bits);
+            bitset_clear(graphics_surfaces[id].sprite_collisions, sprite->id);
+        }
     }
 
+    // Clear this sprites collisions with other sprites.
+    bitset_reset(sprite->sprite_collisions, 256);
+
     // Clear this sprites collisions with edges.
     sprite->edge_collisions = 0x0;
 }
@@ -455,10 +558,17 @@ MmResult sprite_update_collisions(MmSurface *sprite) {
 
     bool has_collision = false;
 
-    // Check for collisions with other sprites.
-    for (MmSurface *other = sprite_first_active(); other; other = sprite_next_active(other)) {
-        //printf("  %d\n", other->id - 128);
-        has_collision |= sprite_check_for_sprite_collision(sprite, other);
+    // Check for collisions with other sprites, only those sharing a grid cell can collide.
+    sprite_grid_sync();
+    uint64_t candidates[SPRITE_GRID_WORDS];
+    sprite_grid_candidates(sprite, candidates);
+    for (int w = 0; w < SPRITE_GRID_WORDS; ++w) {
+        for (uint64_t bits = candidates[w]; bits; bits &= bits - 1) {
+            MmSurface *other = &graphics_surfaces[w * 64 + __builtin_ctzll(bits)];
+            if (other == sprite || other->type != kGraphicsSprite) continue;
+            //printf("  %d\n", other->id - 128);
+            has_collision |= sprite_check_for_sprite_collision(sprite, other);
+        }
     }
 
     //if (has_collision) printf("Sprite %d has collision\n", sprite->id - 128);
@@ -501,11 +611,25 @@ MmResult sprite_update_all_collisions() {
     sprite_clear_all_collisions();
 
     bool has_collision = false;
+    sprite_grid_sync();
 
     for (MmSurface *sprite = sprite_first_active(); sprite; sprite = sprite_next_active(sprite)) {
-        // Check for collisions with other sprites.
-        for (MmSurface *other = sprite_next_active(sprite); other; other = sprite_next_active(other)) {
-            has_collision |= sprite_check_for_sprite_collision(sprite, other);
+        // Check for collisions with other sprites sharing a grid cell, each pair is only checked
+        // from the sprite with the lower id.
+        uint64_t candidates[SPRITE_GRID_WORDS];
+        sprite_grid_candidates(sprite, candidates);
+        for (int w = 0; w < SPRITE_GRID_WORDS; ++w) {
+            uint64_t bits = candidates[w];
+            if (w == sprite->id / 64) {
+                bits &= ~(((uint64_t) 2 << (sprite->id % 64)) - 1);
+            } else if (w < sprite->id / 64) {
+                bits = 0;
+            }
+            for (; bits; bits &= bits - 1) {
+                MmSurface *other = &graphics_surfaces[w * 64 + __builtin_ctzll(bits)];
+                if (other->type != kGraphicsSprite) continue;
+                has_collision |= sprite_check_for_sprite_collision(sprite, other);
+            }
         }
 
         // Check for collisions with surface edge.
@@ -556,6 +680,7 @@ static inline void sprite_translate(MmSurface *sprite, int dx, int dy) {
         ys += graphics_current->height;
     }
     sprite->y = ys - (sprite->height >> 1);
+    sprite_grid_update(sprite);
 }
 
 MmResult sprite_scroll(int dx, int dy, MmGraphicsColour colour) {
@@ -595,6 +720,7 @@ static inline MmResult sprite_show_internal(MmSurface *sprite, MmSurface *dst_su
     sprite->x = x;
     sprite->y = y;
     sprite->layer = layer;
+    sprite_grid_update(sprite);
     if (blit_flags != -1) sprite->blit_flags = (unsigned) blit_flags;
     ON_FAILURE_RETURN(sprite_update_background(sprite, dst_surface));
     if (add_to_stack) ON_FAILURE_RETURN(stack_push(&sprite_z_stack, sprite->id));
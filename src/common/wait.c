@@ -0,0 +1,154 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+wait.c
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "wait.h"
+#include "console.h"
+#include "error.h"
+#include "events.h"
+#include "file.h"
+#include "interrupt.h"
+#include "mmtime.h"
+#include "scheduler.h"
+#include "serial.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+/** Upper bound on a single wait, callers will simply wait again. */
+#define WAIT_MAX_NS  SECONDS_TO_NANOSECONDS(60 * 60)
+
+/**
+ * Set once reading the console returns nothing despite poll() reporting it
+ * readable, e.g. STDIN redirected from a file that has been exhausted.
+ */
+static bool wait_console_exhausted = false;
+
+/** Timer used to wake for the earliest deadline, created on first use. */
+static int wait_timer_fd = -1;
+
+static inline int64_t min_ns(int64_t a, int64_t b) {
+    return a < b ? a : b;
+}
+
+void wait_for_work(int64_t deadline_ns) {
+    // Output is not flushed between statements whilst waiting.
+    console_flush();
+
+    const int64_t now_ns = mmtime_now_ns();
+    int64_t timeout_ns = min_ns(deadline_ns - now_ns, WAIT_MAX_NS);
+    timeout_ns = min_ns(timeout_ns, interrupt_next_tick_ns(now_ns) - now_ns);
+    if (events_is_initialised()) {
+        // There is no file descriptor for SDL events, graphics refresh or
+        // audio, so wake whenever their background tasks are due.
+        const int64_t next_due_ns = scheduler_next_due_ns(false);
+        if (next_due_ns != INT64_MAX) {
+            timeout_ns = min_ns(timeout_ns, next_due_ns - mmtime_monotonic_ns());
+        }
+    }
+    if (timeout_ns <= 0) return;
+
+    errno = 0;
+    if (wait_timer_fd == -1) {
+        wait_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (wait_timer_fd == -1) error_throw(errno);
+    }
+    const struct itimerspec timer = {
+        { 0, 0 },
+        { NANOSECONDS_TO_SECONDS(timeout_ns), timeout_ns % 1000000000 }
+    };
+    if (timerfd_settime(wait_timer_fd, 0, &timer, NULL) == -1) error_throw(errno);
+
+    struct pollfd fds[2 * MAXOPENFILES + 2];
+    int fnbrs[2 * MAXOPENFILES + 2];
+    nfds_t count = 0;
+
+    fds[count].fd = wait_timer_fd;
+    fds[count].events = POLLIN;
+    fnbrs[count++] = -1;
+    if (!wait_console_exhausted) {
+        fds[count].fd = STDIN_FILENO;
+        fds[count].events = POLLIN;
+        fnbrs[count++] = 0;
+    }
+    for (int i = 1; i <= MAXOPENFILES; ++i) {
+        if (file_table[i].type == fet_serial) {
+            fds[count].fd = serial_wait_fd(i);
+            fds[count].events = POLLIN;
+            fnbrs[count++] = i;
+            if (serial_tx_queue_size(i) > 0) {
+                // Also wake to write queued output as the device accepts it.
+                fds[count].fd = file_table[i].serial_fd;
+                fds[count].events = POLLOUT;
+                fnbrs[count++] = i;
+            }
+        }
+    }
+
+    int result = poll(fds, count, -1);
+    if (result == -1) {
+        if (errno == EINTR) return;
+        error_throw(errno);
+    }
+
+    for (nfds_t i = 0; i < count && result > 0; ++i) {
+        if (!fds[i].revents) continue;
+        result--;
+        if (fnbrs[i] == -1) {
+            uint64_t expirations;
+            if (read(wait_timer_fd, &expirations, sizeof(expirations)) == -1
+                    && errno != EAGAIN) {
+                error_throw(errno);
+            }
+        } else if (fnbrs[i] == 0) {
+            if (console_pump_input() == 0) wait_console_exhausted = true;
+        } else if (fds[i].events == POLLOUT) {
+            serial_pump_output(fnbrs[i]);
+        } else {
+            serial_pump_input(fnbrs[i]);
+        }
+    }
+}
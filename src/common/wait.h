@@ -0,0 +1,71 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+wait.h
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#if !defined(MMB4L_WAIT_H)
+#define MMB4L_WAIT_H
+
+#include <stdint.h>
+
+#define WAIT_FOREVER  INT64_MAX
+
+/**
+ * @brief  Blocks until there may be work for the interpreter.
+ *
+ * Returns when any of the following happen:
+ *  - console input is available; it is pumped into the console buffer.
+ *  - serial port input is available; it is pumped into the port's buffer.
+ *  - a 'SETTICK' interrupt becomes due.
+ *  - a background task that cannot be waited on becomes due, e.g. pumping
+ *    SDL events; only once SDL has been initialised.
+ *  - a signal is caught.
+ *  - \p deadline_ns is reached.
+ *
+ * Callers are expected to call CheckAbort(), and if appropriate
+ * interrupt_check(), when this returns and then re-test their own condition.
+ *
+ * @param  deadline_ns  Time as returned by mmtime_now_ns(), or WAIT_FOREVER.
+ */
+void wait_for_work(int64_t deadline_ns);
+
+#endif // #if !defined(MMB4L_WAIT_H)
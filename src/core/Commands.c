@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "commandtbl.h"
 #include "tokentbl.h"
 #include "funtbl.h"
+#include "jmptbl.h"
 #include "vartbl.h"
 #include "../common/cstring.h"
 #include "../common/parse.h"
@@ -350,9 +351,17 @@ retest_an_if:
             if(argc == 2) {
                 // search for the next ELSE, or ENDIF and pass control to the following line
                 // if an ELSEIF is found re execute this function to evaluate the condition following the ELSEIF
+                // the jump table (if populated) takes us straight to the next ELSE, ELSEIF or ENDIF at this level
+                const struct s_jmptbl *jmp = jmptbl_find(nextstmt);
                 i = 1; p = nextstmt;
                 while(1) {
-                    p = GetNextCommand(p, &rp, "No matching ENDIF");
+                    if(jmp && jmp->next) {
+                        p = jmp->next;
+                        rp = jmp->next_line;
+                        jmp = NULL;
+                    } else {
+                        p = GetNextCommand(p, &rp, "No matching ENDIF");
+                    }
                     const CommandToken cmd = commandtbl_decode(p);
                     if (cmd == cmdtoken) {
                         // found a nested IF command, we now need to determine if it is a single or multiline IF
@@ -435,6 +444,14 @@ void cmd_else(void) {
 
     if (cmdtoken == cmdELSE) checkend(cmdline);
 
+    const struct s_jmptbl *jmp = jmptbl_find(nextstmt);
+    if(jmp && jmp->end) {                                           // the ENDIF was resolved by PrepareProgram()
+        p = jmp->end;
+        skipelement(p);
+        nextstmt = p;
+        return;
+    }
+
     while(1) {
         p = GetNextCommand(p, NULL, "No matching ENDIF");
         const CommandToken cmd = commandtbl_decode(p);
@@ -479,9 +496,16 @@ void cmd_select(void) {
     // now search through the program looking for a matching CASE statement
     // i tracks the nesting level of any nested SELECT CASE commands
     SaveCurrentLinePtr = CurrentLinePtr;                            // save where we are because we will have to fake CurrentLinePtr to get errors reported correctly
+    const struct s_jmptbl *jmp = jmptbl_find(nextstmt);             // the jump table (if populated) links each CASE at this level
     i = 1; p = nextstmt;
     while(1) {
-        p = GetNextCommand(p, &rp, "No matching END SELECT");
+        if(jmp && jmp->next) {
+            p = jmp->next;
+            rp = jmp->next_line;
+            jmp = NULL;
+        } else {
+            p = GetNextCommand(p, &rp, "No matching END SELECT");
+        }
         const CommandToken cmd = commandtbl_decode(p);
 
         if (cmd == cmdSELECT_CASE) i++;                             // found a nested SELECT CASE command, increase the nested count and carry on searching
@@ -557,6 +581,8 @@ void cmd_select(void) {
             } while(*p == ',');                                     // keep looping through the elements on the CASE line
             checkend(p);
             CurrentLinePtr = SaveCurrentLinePtr;
+            skipelement(p);
+            jmp = jmptbl_find(p);                                   // and look up the next CASE at this level
         }
 
         // test if we have found a CASE ELSE statement at the same level as this SELECT CASE
@@ -594,6 +620,14 @@ void cmd_case(void) {
 
     // search through the program looking for a END SELECT statement
     // i tracks the nesting level of any nested SELECT CASE commands
+    const struct s_jmptbl *jmp = jmptbl_find(nextstmt);
+    if(jmp && jmp->end) {                                           // the END SELECT was resolved by PrepareProgram()
+        p = jmp->end;
+        skipelement(p);
+        nextstmt = p;
+        return;
+    }
+
     i = 1; p = nextstmt;
     while(1) {
         p = GetNextCommand(p, NULL, "No matching END SELECT");
@@ -801,9 +835,14 @@ void cmd_for(void) {
 
         forstack[forindex].forptr = nextstmt + 1;                   // return to here when looping
 
-        // now find the matching NEXT command
+        // now find the matching NEXT command, if it was resolved by PrepareProgram() then this is a simple lookup
+        const struct s_jmptbl *jmp = jmptbl_find(nextstmt);
         t = 1; p = nextstmt;
         while(1) {
+            if(jmp && jmp->end) {
+                forstack[forindex].nextptr = p = jmp->end;
+                break;
+            }
             p = GetNextCommand(p, &tp, "No matching NEXT");
             const CommandToken cmd = commandtbl_decode(p);
             if (cmd == cmdFOR) t++;                                 // count the FOR
@@ -477,7 +477,7 @@ void fun_eval(void) {
     strcpy(temp_tknbuf, tknbuf);                                    // first save the current token buffer in case we are in immediate mode
     // we have to fool the tokeniser into thinking that it is processing a program line entered at the console
     st = GetTempStrMemory();
-    strcpy(st, getstring(ep));                                      // then copy the argument
+    Mstrcpy(st, getstring(ep));                                     // then copy the argument
     MtoC(st);                                                       // and convert to a C string
     inpbuf[0] = 'r'; inpbuf[1] = '=';                               // place a dummy assignment in the input buffer to keep the tokeniser happy
     strcpy(inpbuf + 2, st);
@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Commands.h"
 #include "commandtbl.h"
 #include "funtbl.h"
+#include "jmptbl.h"
 #include "tokentbl.h"
 #include "vartbl.h"
 #include "../common/audio.h"
@@ -123,7 +124,8 @@ char *sarg1, *sarg2, *sret;                                         // the two s
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Global information used by functions
 // functions use targ, fret and sret as defined for operators (above)
-const char *ep;                                                     // pointer to the argument to the function terminated with a zero byte.
+const char *ep;                                                     // pointer to the argument to the function terminated with a zero byte,
+                                                                    // or for a T_INPLACE function by its closing bracket.
                                                                     // it is NOT trimmed of spaces
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -407,9 +409,201 @@ static void PrepareFontTable() {
     }
 }
 
+#define JMP_STACK_SIZE  64  // Maximum nesting tracked by PrepareJumpTable().
+
+/** Tracks an open DO, WHILE, IF or SELECT CASE whilst building the jump table. */
+typedef struct {
+    struct s_jmptbl *first;  // Entry for the opening statement.
+    struct s_jmptbl *last;   // Entry for the most recent ELSEIF, ELSE or CASE.
+} JmpFrame;
+
+typedef struct {
+    JmpFrame frames[JMP_STACK_SIZE];
+    int depth;               // Can exceed JMP_STACK_SIZE, the deeper frames
+                             // are counted but not tracked.
+} JmpStack;
+
+/** Tracks a FOR whose matching NEXT has not yet been found. */
+typedef struct {
+    struct s_jmptbl *entry;
+    const char *vname;       // Name of the FOR variable in the program memory.
+    size_t vlen;
+    int count;               // Nesting count, as maintained by cmd_for().
+} JmpFor;
+
+/**
+ * @brief  Adds a jump table entry for the statement whose command token is
+ *         pointed to by \p p.
+ *
+ * @return  The new entry, or NULL if the table is full.
+ */
+static struct s_jmptbl *AddJump(const char *p) {
+    skipelement(p);
+    struct s_jmptbl *entry;
+    return SUCCEEDED(jmptbl_add(p, &entry)) ? entry : NULL;
+}
+
+static void JmpStackPush(JmpStack *stack, struct s_jmptbl *entry) {
+    if (stack->depth < JMP_STACK_SIZE) {
+        stack->frames[stack->depth].first = entry;
+        stack->frames[stack->depth].last = entry;
+    }
+    stack->depth++;
+}
+
+static JmpFrame *JmpStackTop(JmpStack *stack) {
+    return (stack->depth > 0 && stack->depth <= JMP_STACK_SIZE)
+            ? &stack->frames[stack->depth - 1]
+            : NULL;
+}
+
+static JmpFrame *JmpStackPop(JmpStack *stack) {
+    JmpFrame *frame = JmpStackTop(stack);
+    if (stack->depth > 0) stack->depth--;
+    return frame;
+}
+
+/**
+ * @brief  Links an ELSEIF, ELSE, CASE or CASE ELSE to the previous branch of the
+ *         enclosing IF or SELECT CASE.
+ */
+static void LinkJumpBranch(JmpFrame *frame, const char *p, const char *line) {
+    if (frame->last) {
+        frame->last->next = p;
+        frame->last->next_line = line;
+    }
+    frame->last = AddJump(p);
+}
+
+/**
+ * @brief  Links an ENDIF or END SELECT to the last branch of the enclosing
+ *         IF or SELECT CASE and records it as the end of every branch.
+ */
+static void CloseJumpFrame(JmpFrame *frame, const char *p, const char *line) {
+    if (frame->last) {
+        frame->last->next = p;
+        frame->last->next_line = line;
+    }
+    struct s_jmptbl *entry = frame->first;
+    while (entry) {
+        entry->end = p;
+        if (!entry->next || entry->next == p) break;
+        const char *stmt = entry->next;
+        skipelement(stmt);
+        entry = jmptbl_find(stmt);
+    }
+}
+
+/**
+ * @brief  Is the IF statement at \p p a multi-line IF ?
+ *
+ * This is the same test as used by cmd_if() and cmd_else(), i.e. there is only
+ * whitespace or a comment after the THEN.
+ */
+static bool IsMultilineIf(const char *p) {
+    p += sizeof(CommandToken);
+    while (*p && *p != tokenTHEN) p++;
+    if (*p) p++;
+    skipspace(p);
+    return *p == 0 || *p == '\'';
+}
+
+/**
+ * @brief  Gets the variable controlling the FOR statement at \p p.
+ *
+ * @return  The length of the name, or 0 if it is not a simple variable in which
+ *          case we leave cmd_for() to search for the matching NEXT.
+ */
+static size_t GetForVariable(const char *p, const char **vname) {
+    p += sizeof(CommandToken);
+    skipspace(p);
+    *vname = p;
+    while (isnameend(*p)) p++;
+    const size_t vlen = p - *vname;
+    skipspace(p);
+    return *p == tokenEQUAL ? vlen : 0;
+}
+
+/**
+ * @brief  Does the NEXT statement at \p p match the FOR variable \p vname ?
+ *
+ * This is the same test as used by cmd_for().
+ */
+static bool NextMatchesForVariable(const char *p, const char *vname, size_t vlen) {
+    const char *xp = p + sizeof(CommandToken);
+    while (*xp && strncasecmp(xp, vname, vlen)) xp++;
+    return *xp && !isnamechar(xp[vlen]);
+}
+
+/**
+ * @brief  Populates the jump table by making a single pass through ProgMemory
+ *         recording the targets for FOR, DO, WHILE, IF and SELECT CASE.
+ *
+ * Each construct is matched exactly as the forward search in the corresponding
+ * command would match it; statements that cannot be resolved are not recorded
+ * and those commands fall back to searching at runtime.
+ */
+static void PrepareJumpTable() {
+    JmpStack do_stack = { 0 }, while_stack = { 0 }, if_stack = { 0 }, select_stack = { 0 };
+    JmpFor fors[JMP_STACK_SIZE];
+    size_t for_count = 0;
+    const char *p = ProgMemory;
+    const char *line = NULL;
+    JmpFrame *frame;
+
+    jmptbl_clear();
+
+    for (;;) {
+        p = GetNextCommand(p, &line, NULL);
+        if (*p == 0) break;  // The end of the program.
+
+        const CommandToken cmd = commandtbl_decode(p);
+        if (cmd == cmdFOR) {
+            for (size_t i = 0; i < for_count; ++i) fors[i].count++;
+            const char *vname;
+            const size_t vlen = GetForVariable(p, &vname);
+            if (vlen > 0 && for_count < JMP_STACK_SIZE) {
+                struct s_jmptbl *entry = AddJump(p);
+                if (entry) fors[for_count++] = (JmpFor) { entry, vname, vlen, 1 };
+            }
+        } else if (cmd == cmdNEXT) {
+            size_t j = 0;
+            for (size_t i = 0; i < for_count; ++i) {
+                if (NextMatchesForVariable(p, fors[i].vname, fors[i].vlen) || --fors[i].count == 0) {
+                    fors[i].entry->end = p;
+                } else {
+                    fors[j++] = fors[i];
+                }
+            }
+            for_count = j;
+        } else if (cmd == cmdDO) {
+            JmpStackPush(&do_stack, AddJump(p));
+        } else if (cmd == cmdLOOP) {
+            if ((frame = JmpStackPop(&do_stack)) && frame->first) frame->first->end = p;
+        } else if (cmd == cmdWHILE) {
+            JmpStackPush(&while_stack, AddJump(p));
+        } else if (cmd == cmdWEND) {
+            if ((frame = JmpStackPop(&while_stack)) && frame->first) frame->first->end = p;
+        } else if (cmd == cmdIF) {
+            if (IsMultilineIf(p)) JmpStackPush(&if_stack, AddJump(p));
+        } else if (cmd == cmdELSEIF || cmd == cmdELSE_IF || cmd == cmdELSE) {
+            if ((frame = JmpStackTop(&if_stack))) LinkJumpBranch(frame, p, line);
+        } else if (cmd == cmdENDIF || cmd == cmdEND_IF) {
+            if ((frame = JmpStackPop(&if_stack))) CloseJumpFrame(frame, p, line);
+        } else if (cmd == cmdSELECT_CASE) {
+            JmpStackPush(&select_stack, AddJump(p));
+        } else if (cmd == cmdCASE || cmd == cmdCASE_ELSE) {
+            if ((frame = JmpStackTop(&select_stack))) LinkJumpBranch(frame, p, line);
+        } else if (cmd == cmdEND_SELECT) {
+            if ((frame = JmpStackPop(&select_stack))) CloseJumpFrame(frame, p, line);
+        }
+    }
+}
+
 void PrepareProgram(int ErrAbort) {
     PrepareFunctionTable(ErrAbort);
     PrepareFontTable();
+    PrepareJumpTable();
 }
 
 /**
@@ -925,26 +1119,22 @@ void tokenise(int console) {
                 match_p = p;
             } else {
                 // now try for a command in the command table
-                // this works by scanning the entire table looking for the match with the longest command name
+                // this works by looking up every command whose name matches in the trie and then picking the longest
                 // this is needed because we need to differentiate between END and END SUB for example.
                 // without looking for the longest match we might think that we have a match when we found just END.
-                const char *tp;
-                for(i = 0 ; i < CommandTableSize - 1; i++) {
-                    tp2 = p;
-                    tp = commandtbl[i].name;
-                    while(toupper(*tp2) == toupper(*tp) && *tp != 0) {
-                        if(*tp == ' ')
-                            skipspace(tp2);                         // eat up any extra spaces between keywords
-                        else
-                            tp2++;
-                        tp++;
-                        if(*tp == '(') skipspace(tp2);              // eat up space between a keyword and bracket
-                    }
+                KeywordMatch matches[KEYWORD_TRIE_MAX_MATCHES];
+                int num_matches = keyword_trie_match(&commandtbl_trie, p, matches);
+                if (num_matches < 0) ERROR_INTERNAL_FAULT;          // KEYWORD_TRIE_MAX_MATCHES is too small.
+                for(int m = 0; m < num_matches; m++) {
+                    i = matches[m].entry;
+                    tp2 = (char *) matches[m].end;
+                    const char *tp = commandtbl[i].name + strlen(commandtbl[i].name);
                     // we have a match
-                    if(*tp == 0 && (!isnamechar(*tp2) || (commandtbl[i].type & T_FUN))) {
+                    if(!isnamechar(*tp2) || (commandtbl[i].type & T_FUN)) {
                         if(*(tp - 1) != '(' && isnamechar(*tp2)) continue;   // skip if not the function
-                        // save the details if it is the longest command found so far
-                        if((ssize_t) strlen(commandtbl[i].name) > match_l) {
+                        // save the details if it is the longest command found so far, ties go to the first in the table
+                        if((ssize_t) strlen(commandtbl[i].name) > match_l
+                                || ((ssize_t) strlen(commandtbl[i].name) == match_l && i < match_i)) {
                             match_p = tp2;
                             match_l = strlen(commandtbl[i].name);
                             match_i = i;
@@ -983,18 +1173,19 @@ void tokenise(int console) {
                 }
             }
         } else {
-            // check to see if it is a function or keyword
-            const char *tp;
+            // check to see if it is a function or keyword, the first entry in the table that matches wins
             char *tp2 = NULL;
-            for(i = 0 ; i < TokenTableSize - 1; i++) {
-                tp2 = p;
-                tp = tokentbl[i].name;
-                // check this entry
-                while(toupper(*tp2) == toupper(*tp) && *tp != 0) {
-                    tp++; tp2++;
-                    if(*tp == '(') skipspace(tp2);
+            KeywordMatch matches[KEYWORD_TRIE_MAX_MATCHES];
+            int num_matches = keyword_trie_match(&tokentbl_trie, p, matches);
+            if (num_matches < 0) ERROR_INTERNAL_FAULT;              // KEYWORD_TRIE_MAX_MATCHES is too small.
+            i = TokenTableSize - 1;
+            for(int m = 0; m < num_matches; m++) {
+                const char *tp = tokentbl[matches[m].entry].name + strlen(tokentbl[matches[m].entry].name);
+                const char *end = matches[m].end;
+                if(matches[m].entry < i && (!isnameend(*(tp - 1)) || !isnamechar(*end))) {
+                    i = matches[m].entry;
+                    tp2 = (char *) end;
                 }
-                if(*tp == 0 && (!isnameend(*(tp - 1)) || !isnamechar(*tp2))) break;
             }
             if(i != TokenTableSize - 1) {
                 // we have a  match
@@ -1238,6 +1429,144 @@ const char *doexpr(const char *p, MMFLOAT *fa, MMINTEGER *ia, char **sa, int *oo
 
 
 
+// Numeric and string literals in the program memory are cached by address so that an expression evaluated
+// repeatedly, e.g. in a loop, does not have to parse its constants every time; the program text is
+// unchanged so LIST and TRACE are not affected. The cache must be cleared by ClearLiteralCache()
+// whenever the program memory changes, ClearRuntime() does this.
+// String literals are copied, as MMBasic strings, into the 'litpool' which is only emptied along with
+// the cache so the strings remain valid even if their cache entry is replaced. Like strings in the
+// (zeroed) temporary memory they are followed by a '\0'.
+typedef struct {
+    const char *p;                  // address of the literal in the program memory
+    const char *end;                // address of the character following the literal
+    union {
+        MMFLOAT f;
+        MMINTEGER i;
+        char *s;                    // MMBasic string in the 'litpool'
+    } val;
+    int type;                       // T_NBR, T_INT or T_STR
+} LitCacheEntry;
+
+static LitCacheEntry litcache[LITCACHE_SIZE];
+static char litpool[LITPOOL_SIZE];
+static size_t litpool_used = 0;
+
+void ClearLiteralCache(void) {
+    memset(litcache, 0, sizeof(litcache));
+    litpool_used = 0;
+}
+
+// copy a string constant to a MMBasic string, if 'pool' is true and there is room then the copy is made in the
+// 'litpool' otherwise it is made in temporary memory
+// returns a pointer to the character following the closing quote
+static const char *getstrliteral(const char *p, char **sa, bool pool) {
+    const char *tp = strchr(++p, '"');                              // step over the opening quote and find the closing one
+    size_t len = tp - p;
+    if (len > MAXSTRLEN) error("String too long");
+    char *s;
+    if (pool && litpool_used + len + 2 <= LITPOOL_SIZE) {
+        s = litpool + litpool_used;
+        litpool_used += len + 2;
+    } else {
+        s = (char *) GetTempMemory(STRINGSIZE);                     // this will last for the life of the command
+    }
+    *s = (char) len;
+    memcpy(s + 1, p, len);
+    s[len + 1] = '\0';                                              // some callers treat the string as terminated
+    *sa = s;
+    return tp + 1;
+}
+
+// parse a decimal numeric constant or one starting with the & character
+// returns a pointer to the character following the constant
+static const char *getliteral(const char *p, MMFLOAT *fa, MMINTEGER *ia, int *ta) {
+    MMFLOAT f = 0;
+    MMINTEGER i64 = 0;
+    int t = T_NOTYPE;
+
+    // is it an ordinary numeric constant?  get its value if yes
+    if (isdigit(*p) || *p == '.') {
+        char ts[31], *tsp;
+        int isi64 = true;
+        tsp = ts;
+        int isf = true;
+        MMINTEGER scale = 0;
+        // copy the first digit of the string to a temporary place
+        if (*p == '.') {
+            isi64 = false;
+            scale = 1;
+        }
+        else if (isdigit(*p)) {
+            i64 = (*p - '0');
+        }
+        *tsp++ = *p++;
+
+        // now concatenate the remaining digits
+        while ((DIGIT_CHARS[(uint8_t)*p]) && (tsp - ts) < 30) {
+            if (*p >= '0' && *p <= '9') {
+                i64 = i64 * 10 + (*p - '0');
+                if (scale)scale *= 10;
+            }
+            else {
+                if ((*p) == '.') {
+                    isi64 = false;
+                    scale = 1;
+                }
+                else {
+                    if (toupper(*p) == 'E' || *p == '-' || *p == '+') {
+                        isi64 = false;
+                        isf = false;
+                    }
+                }
+            }
+            *tsp++ = *p++;                                          // copy the string to a temporary place
+        }
+        *tsp = 0;                                                   // terminate it
+        if (isi64) {
+            t = T_INT;
+        }
+        else if (isf && (tsp - ts) < 18) {
+            f = (MMFLOAT)i64 / (MMFLOAT)scale;
+            t = T_NBR;
+        }
+        else {
+            f = (MMFLOAT)strtod(ts, &tsp);                          // and convert to a MMFLOAT
+            t = T_NBR;
+        }
+    }
+    // if it is a numeric constant starting with the & character then get its base and convert to an integer
+    else {
+        p++; i64 = 0;
+        switch (toupper(*p++)) {
+            case 'H':
+                while (isxdigit(*p)) {
+                    i64 = (i64 << 4) | ((toupper(*p) >= 'A') ? toupper(*p) - 'A' + 10 : *p - '0');
+                    p++;
+                }
+                break;
+            case 'O':
+                while (*p >= '0' && *p <= '7') {
+                    i64 = (i64 << 3) | (*p++ - '0');
+                }
+                break;
+            case 'B':
+                while (*p == '0' || *p == '1') {
+                    i64 = (i64 << 1) | (*p++ - '0');
+                }
+                break;
+            default:
+                error("Type prefix");
+        }
+        t = T_INT;
+    }
+    *fa = f;
+    *ia = i64;
+    *ta = t;
+    return p;
+}
+
+
+
 // get a value, either from a constant, function or variable
 // also returns the next operator to the right of the value or E_END if no operator
 const char *getvalue(const char* p, MMFLOAT* fa, MMINTEGER* ia, char** sa, int* oo, int* ta) {
@@ -1332,12 +1661,18 @@ const char *getvalue(const char* p, MMFLOAT* fa, MMINTEGER* ia, char** sa, int*
             tp = p;
             // if it is a function with arguments we need to locate the closing bracket and copy the argument to
             // a temporary variable so that functions like getarg() will work.
+            // a function flagged T_INPLACE only evaluates a single expression which will stop at the closing bracket
+            // so it can be given the argument without copying it.
             if (tokentype(*p) & T_FUN) {
                 const char *p1 = p + 1;
                 p = getclosebracket(p);                                 // find the closing bracket
-                char *p2 = (char *) GetTempMemory(STRINGSIZE);          // this will last for the life of the command
-                ep = p2;
-                while (p1 != p) *p2++ = *p1++;
+                if (tokentype(*tp) & T_INPLACE) {
+                    ep = p1;
+                } else {
+                    char *p2 = (char *) GetTempMemory(STRINGSIZE);      // this will last for the life of the command
+                    ep = p2;
+                    while (p1 != p) *p2++ = *p1++;
+                }
             }
             p++;                                                        // point to after the function (without argument) or after the closing bracket
             targ = TypeMask(tokentype(*tp));                            // set the type of the function (which might need to know this)
@@ -1370,83 +1705,25 @@ const char *getvalue(const char* p, MMFLOAT* fa, MMINTEGER* ia, char** sa, int*
             }
             p = skipvar(p, false);
         }
-        // is it an ordinary numeric constant?  get its value if yes
+        // is it a numeric constant?  get its value if yes
         // a leading + or - might have been converted to a token so we need to check for them also
-        else if (isdigit(*p) || *p == '.') {
-            char ts[31], *tsp;
-            int isi64 = true;
-            tsp = ts;
-            int isf = true;
-            MMINTEGER scale = 0;
-            // copy the first digit of the string to a temporary place
-            if (*p == '.') {
-                isi64 = false;
-                scale = 1;
-            }
-            else if (isdigit(*p)) {
-                i64 = (*p - '0');
-            }
-            *tsp++ = *p++;
-
-            // now concatenate the remaining digits
-            while ((DIGIT_CHARS[(uint8_t)*p]) && (tsp - ts) < 30) {
-                if (*p >= '0' && *p <= '9') {
-                    i64 = i64 * 10 + (*p - '0');
-                    if (scale)scale *= 10;
-                }
-                else {
-                    if ((*p) == '.') {
-                        isi64 = false;
-                        scale = 1;
-                    }
-                    else {
-                        if (toupper(*p) == 'E' || *p == '-' || *p == '+') {
-                            isi64 = false;
-                            isf = false;
-                        }
-                    }
+        else if (isdigit(*p) || *p == '.' || *p == '&') {
+            if (p >= ProgMemory && p < ProgMemory + PROG_FLASH_SIZE) {
+                LitCacheEntry *entry = &litcache[(p - ProgMemory) & (LITCACHE_SIZE - 1)];
+                if (entry->p == p) {
+                    t = entry->type;
+                    if (t & T_NBR) f = entry->val.f; else i64 = entry->val.i;
+                    p = entry->end;
+                } else {
+                    entry->end = getliteral(p, &f, &i64, &t);
+                    entry->p = p;
+                    entry->type = t;
+                    if (t & T_NBR) entry->val.f = f; else entry->val.i = i64;
+                    p = entry->end;
                 }
-                *tsp++ = *p++;                                          // copy the string to a temporary place
-            }
-            *tsp = 0;                                                   // terminate it
-            if (isi64) {
-                t = T_INT;
-            }
-            else if (isf && (tsp - ts) < 18) {
-                f = (MMFLOAT)i64 / (MMFLOAT)scale;
-                t = T_NBR;
-            }
-            else {
-                f = (MMFLOAT)strtod(ts, &tsp);                          // and convert to a MMFLOAT
-                t = T_NBR;
-            }
-        }
-
-
-        // if it is a numeric constant starting with the & character then get its base and convert to an integer
-        else if (*p == '&') {
-            p++; i64 = 0;
-            switch (toupper(*p++)) {
-                case 'H':
-                    while (isxdigit(*p)) {
-                        i64 = (i64 << 4) | ((toupper(*p) >= 'A') ? toupper(*p) - 'A' + 10 : *p - '0');
-                        p++;
-                    }
-                    break;
-                case 'O':
-                    while (*p >= '0' && *p <= '7') {
-                        i64 = (i64 << 3) | (*p++ - '0');
-                    }
-                    break;
-                case 'B':
-                    while (*p == '0' || *p == '1') {
-                        i64 = (i64 << 1) | (*p++ - '0');
-                    }
-                    break;
-                default:
-                    error("Type prefix");
+            } else {
+                p = getliteral(p, &f, &i64, &t);
             }
-            t = T_INT;
         }
         // if opening bracket then first evaluate the contents of the bracket
         else if (*p == '(') {
@@ -1456,13 +1733,25 @@ const char *getvalue(const char* p, MMFLOAT* fa, MMINTEGER* ia, char** sa, int*
             ++p;                                                        // step over the closing bracket
         }
         // if it is a string constant, return a pointer to that.  Note: tokenise() guarantees that strings end with a quote
+        // constants in the program memory are only copied the first time, like the value of a string variable
+        // the string returned must not be modified
         else if (*p == '"') {
-            p++;                                                        // step over the quote
-            char *p1 = s = (char *) GetTempMemory(STRINGSIZE);          // this will last for the life of the command
-            tp = strchr(p, '"');
-            while (p != tp) *p1++ = *p++;
-            p++;
-            CtoM(s);                                                    // convert to a MMBasic string
+            LitCacheEntry *entry = NULL;
+            if (p >= ProgMemory && p < ProgMemory + PROG_FLASH_SIZE)
+                entry = &litcache[(p - ProgMemory) & (LITCACHE_SIZE - 1)];
+            if (entry && entry->p == p) {
+                s = entry->val.s;
+                p = entry->end;
+            } else {
+                tp = p;
+                p = getstrliteral(p, &s, entry != NULL);
+                if (s >= litpool && s < litpool + LITPOOL_SIZE) {
+                    entry->p = tp;
+                    entry->end = p;
+                    entry->type = T_STR;
+                    entry->val.s = s;
+                }
+            }
             t = T_STR;
         }
         else
@@ -1633,10 +1922,52 @@ routines for storing and manipulating variables
 // storage of the variable's data:
 //      if it is type T_NBR or T_INT the value is held in the variable slot
 //      for T_STR a block of memory of MAXSTRLEN size (or size determined by the LENGTH keyword) will be malloc'ed and the pointer stored in the variable slot.
+//
+// References to existing scalar variables from the program memory are cached so that repeated
+// lookups do not need to parse and hash the name; a cache entry is only used whilst the
+// vartbl_generation[] counters for its level and for the global level are unchanged.
+typedef struct {
+    const char *p;                  // address of the reference in the program memory
+    int action;                     // the 'action' the reference was resolved with
+    char default_type;              // the value of DefaultType when it was resolved
+    uint32_t generation;            // vartbl_generation[level] when it was resolved
+    uint32_t global_generation;     // vartbl_generation[GLOBAL_VAR] when it was resolved
+    int16_t var_idx;                // index of the variable in the vartbl
+    uint8_t level;                  // value of LocalIndex when it was resolved
+} VarCacheEntry;
+
+static VarCacheEntry varcache[VARCACHE_SIZE];
+
+static inline void *findvar_scalar(int var_idx) {
+    if (vartbl[var_idx].type & (T_PTR | T_STR)) {
+        return vartbl[var_idx].val.s;                               // if it is a string or pointer just return the pointer to the data
+    } else if (vartbl[var_idx].type & (T_INT)) {
+        return &(vartbl[var_idx].val.i);                            // must be an integer, point to its value
+    } else {
+        return &(vartbl[var_idx].val.f);                            // must be a straight number (float), point to its value
+    }
+}
+
 void *findvar(const char *p, int action) {
 
     TestStackOverflow();  // Test if we have overflowed the PIC32's stack.
 
+    // Check for a cached reference.
+    VarCacheEntry *cache_entry = NULL;
+    if (p >= ProgMemory && p < ProgMemory + PROG_FLASH_SIZE) {
+        cache_entry = &varcache[(p - ProgMemory) & (VARCACHE_SIZE - 1)];
+        if (cache_entry->p == p
+                && cache_entry->action == action
+                && cache_entry->level == (uint8_t) LocalIndex
+                && cache_entry->default_type == DefaultType
+                && cache_entry->generation == vartbl_generation[cache_entry->level]
+                && cache_entry->global_generation == vartbl_generation[GLOBAL_VAR]) {
+            VarIndex = cache_entry->var_idx;
+            return findvar_scalar(cache_entry->var_idx);
+        }
+    }
+    const char *start = p;
+
     // Get the name.
     char name[MAXVARLEN + 1] = {0};
     MmResult result = parse_name(&p, name);
@@ -1788,14 +2119,19 @@ void *findvar(const char *p, int action) {
         }
 
         // if it is a non arrayed variable or an empty array it is easy, just calculate and return a pointer to the value
-        if (dnbr == -1 || vartbl[var_idx].dims[0] == 0) {
-            if (dnbr == -1 || vartbl[var_idx].type & (T_PTR | T_STR)) {
-                return vartbl[var_idx].val.s;                        // if it is a string or pointer just return the pointer to the data
-            } else if (vartbl[var_idx].type & (T_INT)) {
-                return &(vartbl[var_idx].val.i);                     // must be an integer, point to its value
-            } else {
-                return &(vartbl[var_idx].val.f);                     // must be a straight number (float), point to its value
+        if (dnbr == -1) return vartbl[var_idx].val.s;
+        if (vartbl[var_idx].dims[0] == 0) {
+            if (cache_entry) {
+                *cache_entry = (VarCacheEntry) {
+                    .p = start,
+                    .action = action,
+                    .default_type = DefaultType,
+                    .generation = vartbl_generation[(uint8_t) LocalIndex],
+                    .global_generation = vartbl_generation[GLOBAL_VAR],
+                    .var_idx = var_idx,
+                    .level = LocalIndex };
             }
+            return findvar_scalar(var_idx);
         }
 
         // if we reached this point it must be a reference to an existing array
@@ -2312,6 +2648,7 @@ void ClearRuntime(void) {
     mmb_options.codepage = NULL;
     mmb_options.simulate = kSimulateMmb4l;
     mmb_options.resolution = kCharacter;
+    mmb_options.serial_blocking = true;
 #endif
 #if defined(MICROMITE) && !defined(LITE)
     ds18b20Timers = NULL;                                           // InitHeap() will recover the memory allocated to this array
@@ -2330,6 +2667,12 @@ void ClearRuntime(void) {
     ClearVars(0);
     CurrentLinePtr = ContinuePoint = NULL;
     funtbl_clear();
+    jmptbl_clear();
+    ClearLiteralCache();
+#if defined(__mmb4l__)
+    extern void fun_json_clear_cache(void);
+    fun_json_clear_cache();
+#endif
 }
 
 
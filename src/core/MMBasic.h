@@ -65,6 +65,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define T_OPER      0x20                            // an operator
 #define T_FUN       0x40                            // a function (also used for a function that can operate as a command)
 #define T_FNA       0x80                            // a function that has no arguments
+#define T_INPLACE   0x08                            // a function that can evaluate its argument in the program, see getvalue()
 
 // flags used in the program lines
 #define T_CMDEND    0                               // end of a command
@@ -200,6 +201,7 @@ void ClearVars(int level);
 void ClearStack(void);
 void ClearRuntime(void);
 void ClearProgram(void);
+void ClearLiteralCache(void);
 void *DoExpression(const char *p, int *t);
 const char *evaluate(const char *p, MMFLOAT *fa, MMINTEGER *ia, char **sa, int *ta, int noerror);
 const char *doexpr(const char *p, MMFLOAT *fa, MMINTEGER *ia, char **sa, int *oo, int *t);
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MMBasic.h"
 #include "commandtbl.h"
 #include "../common/error.h"
+#include "../common/utility.h"
 
 #include <strings.h>
 
@@ -109,6 +110,7 @@ const struct s_tokentbl commandtbl[] = {
     { "Exit",        T_CMD,              0, cmd_exit     },
     { "Files",       T_CMD,              0, cmd_files    },
     { "Flash",       T_CMD,              0, cmd_flash    },
+    { "Flush",       T_CMD,              0, cmd_flush    },
     { "Font",        T_CMD,              0, cmd_font     },
     { "For",         T_CMD,              0, cmd_for      },
     { "Function",    T_CMD,              0, cmd_subfun   },
@@ -192,8 +194,13 @@ CommandToken cmdENDIF, cmdEND_IF, cmdEND_SELECT, cmdEND_SUB, cmdFOR, cmdFUN;
 CommandToken cmdIF, cmdIRET, cmdLET, cmdLOOP, cmdNEXT, cmdPRINT;
 CommandToken cmdREM, cmdSELECT_CASE, cmdSUB, cmdWEND, cmdWHILE;
 
+KeywordTrie commandtbl_trie;
+
 void commandtbl_init() {
     commandtbl_size = sizeof(commandtbl) / sizeof(struct s_tokentbl);
+    if (FAILED(keyword_trie_build(&commandtbl_trie, commandtbl, commandtbl_size, true))) {
+        ERROR_INTERNAL_FAULT;
+    }
 
     cmdCASE = commandtbl_get("Case");
     cmdCASE_ELSE = commandtbl_get("Case Else");
@@ -45,6 +45,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #if !defined(COMMANDTBL_H)
 #define COMMANDTBL_H
 
+#include "keyword_trie.h"
+
 #include <stdint.h>
 
 typedef uint16_t CommandToken;
@@ -105,6 +107,7 @@ void cmd_exitfor(void);
 void cmd_exit(void);
 void cmd_files(void);
 void cmd_flash(void);
+void cmd_flush(void);
 void cmd_font(void);
 void cmd_for(void);
 void cmd_framebuffer(void);
@@ -190,6 +193,9 @@ static inline void commandtbl_encode(char **p, CommandToken cmd) {
 extern const struct s_tokentbl commandtbl[];
 extern int commandtbl_size;
 
+/** Trie over the command names, used by tokenise(). */
+extern KeywordTrie commandtbl_trie;
+
 // Store commonly used commands for faster token checking.
 extern CommandToken cmdCASE, cmdCASE_ELSE, cmdCFUN, cmdCSUB, cmdDATA, cmdDEFINEFONT, cmdDO;
 extern CommandToken cmdELSE, cmdELSEIF, cmdELSE_IF, cmdENDIF, cmdEND_CSUB, cmdEND_DEFINEFONT;
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 Thomas Hugo Williams
+ * License MIT <https://opensource.org/licenses/MIT>
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h> // Needed for EXPECT_THAT.
+
+extern "C" {
+
+#include "../jmptbl.h"
+#include "../../common/memory.h"
+
+// Defined in "common/memory.c"
+char ProgMemory[PROG_FLASH_SIZE];
+
+} // extern "C"
+
+#define STMT_1  (ProgMemory + 10)
+#define STMT_2  (ProgMemory + 20)
+#define STMT_3  (ProgMemory + 10 + JMPTBL_HASHMAP_SIZE)
+
+class JmptblTest : public ::testing::Test {
+
+protected:
+
+    void SetUp() override {
+        jmptbl_clear();
+    }
+
+    void TearDown() override {
+    }
+
+};
+
+TEST_F(JmptblTest, Add) {
+    struct s_jmptbl *entry;
+    MmResult result = jmptbl_add(STMT_1, &entry);
+
+    EXPECT_EQ(kOk, result);
+    EXPECT_EQ(&jmptbl[0], entry);
+    EXPECT_EQ(STMT_1, entry->stmt);
+    EXPECT_EQ(NULL, entry->next);
+    EXPECT_EQ(NULL, entry->next_line);
+    EXPECT_EQ(NULL, entry->end);
+    EXPECT_EQ(10, entry->hash);
+    EXPECT_EQ(0, jmptbl_hashmap[10]);
+    EXPECT_EQ(1, jmptbl_count);
+
+    result = jmptbl_add(STMT_2, &entry);
+
+    EXPECT_EQ(kOk, result);
+    EXPECT_EQ(&jmptbl[1], entry);
+    EXPECT_EQ(STMT_2, entry->stmt);
+    EXPECT_EQ(20, entry->hash);
+    EXPECT_EQ(1, jmptbl_hashmap[20]);
+    EXPECT_EQ(2, jmptbl_count);
+}
+
+TEST_F(JmptblTest, Add_GivenHashCollision) {
+    struct s_jmptbl *entry;
+    EXPECT_EQ(kOk, jmptbl_add(STMT_1, &entry));
+    EXPECT_EQ(kOk, jmptbl_add(STMT_3, &entry));
+
+    EXPECT_EQ(&jmptbl[1], entry);
+    EXPECT_EQ(11, entry->hash);
+    EXPECT_EQ(1, jmptbl_hashmap[11]);
+    EXPECT_EQ(&jmptbl[0], jmptbl_find(STMT_1));
+    EXPECT_EQ(&jmptbl[1], jmptbl_find(STMT_3));
+}
+
+TEST_F(JmptblTest, Add_GivenDuplicate) {
+    struct s_jmptbl *entry;
+    EXPECT_EQ(kOk, jmptbl_add(STMT_1, &entry));
+
+    EXPECT_EQ(kInternalFault, jmptbl_add(STMT_1, &entry));
+    EXPECT_EQ(NULL, entry);
+    EXPECT_EQ(1, jmptbl_count);
+}
+
+TEST_F(JmptblTest, Add_GivenNotInProgramMemory) {
+    struct s_jmptbl *entry;
+    char buf[10] = { 0 };
+
+    EXPECT_EQ(kInternalFault, jmptbl_add(buf, &entry));
+    EXPECT_EQ(NULL, entry);
+    EXPECT_EQ(0, jmptbl_count);
+}
+
+TEST_F(JmptblTest, Add_GivenTableFull) {
+    struct s_jmptbl *entry;
+    for (int ii = 0; ii < MAXJMPTBL; ++ii) {
+        EXPECT_EQ(kOk, jmptbl_add(ProgMemory + ii, &entry));
+    }
+
+    EXPECT_EQ(kContainerFull, jmptbl_add(ProgMemory + MAXJMPTBL, &entry));
+    EXPECT_EQ(NULL, entry);
+    EXPECT_EQ(MAXJMPTBL, jmptbl_count);
+}
+
+TEST_F(JmptblTest, Clear) {
+    struct s_jmptbl *entry;
+    EXPECT_EQ(kOk, jmptbl_add(STMT_1, &entry));
+    entry->end = STMT_2;
+
+    jmptbl_clear();
+
+    EXPECT_EQ(0, jmptbl_count);
+    EXPECT_EQ(NULL, jmptbl[0].stmt);
+    EXPECT_EQ(NULL, jmptbl[0].end);
+    for (int ii = 0; ii < JMPTBL_HASHMAP_SIZE; ++ii) {
+        EXPECT_EQ(-1, jmptbl_hashmap[ii]);
+    }
+    EXPECT_EQ(NULL, jmptbl_find(STMT_1));
+}
+
+TEST_F(JmptblTest, Find) {
+    struct s_jmptbl *entry;
+    EXPECT_EQ(kOk, jmptbl_add(STMT_1, &entry));
+    EXPECT_EQ(kOk, jmptbl_add(STMT_2, &entry));
+
+    EXPECT_EQ(&jmptbl[0], jmptbl_find(STMT_1));
+    EXPECT_EQ(&jmptbl[1], jmptbl_find(STMT_2));
+    EXPECT_EQ(NULL, jmptbl_find(STMT_3));
+}
+
+TEST_F(JmptblTest, Find_GivenNotInProgramMemory) {
+    struct s_jmptbl *entry;
+    char buf[10] = { 0 };
+    EXPECT_EQ(kOk, jmptbl_add(STMT_1, &entry));
+
+    EXPECT_EQ(NULL, jmptbl_find(buf));
+    EXPECT_EQ(NULL, jmptbl_find(NULL));
+}
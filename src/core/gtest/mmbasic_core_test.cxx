@@ -6,12 +6,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h> // Needed for EXPECT_THAT.
 
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
 extern "C" {
 
 #include "../../Hardware_Includes.h"
 #include "../Commands.h"
 #include "../commandtbl.h"
 #include "../funtbl.h"
+#include "../jmptbl.h"
 #include "../tokentbl.h"
 #include "../vartbl.h"
 #include "../MMBasic.h"
@@ -37,7 +43,11 @@ void MMgetline(int filenbr, char *p) { }
 // Defined in "commands/cmd_read.c"
 void cmd_read_clear_cache()  { }
 
+// Defined in "functions/fun_json.c"
+void fun_json_clear_cache()  { }
+
 // Defined in "common/console.c"
+void console_flush(void) { }
 int console_kbhit(void) { return 0; }
 char console_putc(char c) { return c; }
 void console_puts(const char *s) { }
@@ -95,6 +105,32 @@ protected:
         EXPECT_STREQ("", error_msg);
     }
 
+    /** Gets a pointer to the n'th (from 1) occurrence of a command in the ProgMemory. */
+    const char *FindCommand(const char *name, int n) {
+        const CommandToken token = GetCommandValue(name);
+        const char *p = ProgMemory;
+        for (;;) {
+            p = GetNextCommand(p, NULL, NULL);
+            if (*p == 0) return NULL;
+            if (commandtbl_decode(p) == token && --n == 0) return p;
+        }
+    }
+
+    /** Gets the jump table entry for the n'th (from 1) occurrence of a command in the ProgMemory. */
+    const struct s_jmptbl *FindJump(const char *name, int n) {
+        const char *p = FindCommand(name, n);
+        if (!p) return NULL;
+        skipelement(p);
+        return jmptbl_find(p);
+    }
+
+    /** Copies 'text' into the ProgMemory so that findvar() will cache references to it. */
+    const char *ProgMemoryReference(const char *text) {
+        char *p = ProgMemory + 64;
+        strcpy(p, text);
+        return p;
+    }
+
     char m_program[256];
 };
 
@@ -847,6 +883,223 @@ TEST_F(MmBasicCoreTest, FindVar_GivenArrayDimensionTooLarge) {
     EXPECT_STREQ("Array bound exceeds maximum: %", error_msg);
 }
 
+TEST_F(MmBasicCoreTest, FindVar_GivenProgMemoryReference_CachesLookup) {
+    sprintf(m_program, "foo%%");
+    (void) findvar(m_program, V_FIND);
+    const char *ref = ProgMemoryReference("foo% = 1");
+    EXPECT_EQ(&vartbl[0].val.i, findvar(ref, V_FIND));
+
+    // Renaming the variable behind the vartbl's back proves the cache is used.
+    strcpy(vartbl[0].name, "BAR");
+    VarIndex = 999;
+
+    EXPECT_EQ(&vartbl[0].val.i, findvar(ref, V_FIND));
+    EXPECT_EQ(0, VarIndex);
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MmBasicCoreTest, FindVar_GivenCachedReference_GivenDifferentAction) {
+    sprintf(m_program, "foo%%");
+    (void) findvar(m_program, V_FIND);
+    const char *ref = ProgMemoryReference("foo% = 1");
+    (void) findvar(ref, V_FIND);
+
+    (void) findvar(ref, V_LOCAL);
+
+    EXPECT_STREQ("$ already declared", error_msg);
+}
+
+TEST_F(MmBasicCoreTest, FindVar_GivenCachedReference_GivenVariableDeleted) {
+    sprintf(m_program, "foo%%");
+    (void) findvar(m_program, V_FIND);
+    const char *ref = ProgMemoryReference("foo% = 1");
+    (void) findvar(ref, V_FIND);
+
+    vartbl_delete(0);
+
+    EXPECT_EQ(NULL, findvar(ref, V_FIND | V_NOFIND_NULL));
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MmBasicCoreTest, FindVar_GivenCachedReference_GivenLocalRecreated) {
+    // Simulate calling the same SUB twice, each time with a LOCAL foo%.
+    LocalIndex = 1;
+    sprintf(m_program, "foo%%");
+    (void) findvar(m_program, V_LOCAL);
+    const char *ref = ProgMemoryReference("foo% = 1");
+    EXPECT_EQ(&vartbl[0].val.i, findvar(ref, V_FIND));
+    vartbl_delete_all(1);
+
+    sprintf(m_program, "bar%%");
+    (void) findvar(m_program, V_LOCAL);
+    sprintf(m_program, "foo%%");
+    (void) findvar(m_program, V_LOCAL);
+
+    EXPECT_EQ(&vartbl[1].val.i, findvar(ref, V_FIND));
+    EXPECT_EQ(1, VarIndex);
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MmBasicCoreTest, FindVar_GivenCachedReference_GivenGlobalShadowedByLocal) {
+    sprintf(m_program, "foo%%");
+    (void) findvar(m_program, V_DIM_VAR);
+    LocalIndex = 1;
+    const char *ref = ProgMemoryReference("foo% = 1");
+    EXPECT_EQ(&vartbl[0].val.i, findvar(ref, V_FIND));
+
+    (void) findvar(m_program, V_LOCAL);
+
+    EXPECT_EQ(&vartbl[1].val.i, findvar(ref, V_FIND));
+    LocalIndex = 0;
+    EXPECT_EQ(&vartbl[0].val.i, findvar(ref, V_FIND));
+    EXPECT_STREQ("", error_msg);
+}
+
+TEST_F(MmBasicCoreTest, FindVar_GivenCachedStringReference) {
+    sprintf(m_program, "foo$");
+    char *s = (char *) findvar(m_program, V_FIND);
+    const char *ref = ProgMemoryReference("foo$ = \"bar\"");
+
+    EXPECT_EQ(s, findvar(ref, V_FIND));
+    EXPECT_EQ(s, findvar(ref, V_FIND));
+}
+
+#define FINDVAR_BENCHMARK_ITERATIONS  1000000
+
+TEST_F(MmBasicCoreTest, FindVar_Benchmark_CachedVsUncached) {
+    // Populate the variable table so that the hashmap is representative.
+    for (int i = 0; i < 100; ++i) {
+        sprintf(m_program, "var_%d%%", i);
+        (void) findvar(m_program, V_FIND);
+    }
+    sprintf(m_program, "loop_counter%% = loop_counter%% + 1");
+    const char *ref = ProgMemoryReference(m_program);
+    void *expected = findvar(m_program, V_FIND);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FINDVAR_BENCHMARK_ITERATIONS; ++i) {
+        if (findvar(m_program, V_FIND) != expected) FAIL();
+    }
+    auto uncached_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FINDVAR_BENCHMARK_ITERATIONS; ++i) {
+        if (findvar(ref, V_FIND) != expected) FAIL();
+    }
+    auto cached_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_STREQ("", error_msg);
+    std::cout << "[ BENCHMARK] " << FINDVAR_BENCHMARK_ITERATIONS << " scalar findvar() lookups" << std::endl;
+    std::cout << "[ BENCHMARK]   uncached: " << (FINDVAR_BENCHMARK_ITERATIONS / uncached_secs) << " ops/s" << std::endl;
+    std::cout << "[ BENCHMARK]   cached:   " << (FINDVAR_BENCHMARK_ITERATIONS / cached_secs) << " ops/s" << std::endl;
+}
+
+TEST_F(MmBasicCoreTest, GetValue_GivenNumericLiterals) {
+    const struct { const char *text; int type; MMFLOAT f; MMINTEGER i; } literals[] = {
+        { "42",                   T_INT, 0.0,      42 },
+        { "1.0001",               T_NBR, 1.0001,   0 },
+        { ".5",                   T_NBR, 0.5,      0 },
+        { "1.5E+3",               T_NBR, 1500.0,   0 },
+        { "&HFF",                 T_INT, 0.0,      255 },
+        { "&O17",                 T_INT, 0.0,      15 },
+        { "&B101",                T_INT, 0.0,      5 },
+        { "9223372036854775807",  T_INT, 0.0,      INT64_MAX },
+    };
+
+    for (const auto &literal : literals) {
+        ClearLiteralCache(); // Because we are changing the program memory.
+
+        // Outside the program memory, and then twice from the program memory so that the second
+        // evaluation uses the cached value.
+        const char *sources[] = {
+            literal.text, ProgMemoryReference(literal.text), ProgMemoryReference(literal.text) };
+        for (const char *source : sources) {
+            MMFLOAT f = 0.0;
+            MMINTEGER i64 = 0;
+            char *s = NULL;
+            int t = T_NOTYPE;
+
+            const char *p = evaluate(source, &f, &i64, &s, &t, false);
+
+            EXPECT_STREQ("", error_msg);
+            EXPECT_EQ(source + strlen(literal.text), p) << literal.text;
+            EXPECT_EQ(literal.type, t) << literal.text;
+            if (t == T_NBR) {
+                EXPECT_DOUBLE_EQ(literal.f, f) << literal.text;
+            } else {
+                EXPECT_EQ(literal.i, i64) << literal.text;
+            }
+        }
+    }
+}
+
+TEST_F(MmBasicCoreTest, GetValue_GivenProgramMemoryChanged_AfterClearRuntime) {
+    MMFLOAT f = 0.0;
+    MMINTEGER i64 = 0;
+    char *s = NULL;
+    int t = T_NOTYPE;
+    const char *ref = ProgMemoryReference("12345");
+    (void) evaluate(ref, &f, &i64, &s, &t, false);
+    EXPECT_EQ(T_INT, t);
+    EXPECT_EQ(12345, i64);
+
+    ClearRuntime();
+    ref = ProgMemoryReference("3.25");
+    t = T_NOTYPE;
+    const char *p = evaluate(ref, &f, &i64, &s, &t, false);
+
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(ref + 4, p);
+    EXPECT_EQ(T_NBR, t);
+    EXPECT_DOUBLE_EQ(3.25, f);
+}
+
+TEST_F(MmBasicCoreTest, GetValue_GivenStringLiteral) {
+    MMFLOAT f = 0.0;
+    MMINTEGER i64 = 0;
+    char *s = NULL;
+    int t = T_NOTYPE;
+
+    // Outside the program memory the string is copied every time.
+    const char *p = evaluate("\"Score: \"", &f, &i64, &s, &t, false);
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(T_STR, t);
+    EXPECT_EQ(0, memcmp("\x07Score: ", s, 8));
+    EXPECT_EQ('\0', *p);
+
+    // From the program memory the string is only copied the first time.
+    const char *ref = ProgMemoryReference("\"Score: \" + \"\"");
+    t = T_NOTYPE;
+    p = evaluate(ref, &f, &i64, &s, &t, E_NOERROR);
+    char *first = s;
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(T_STR, t);
+    EXPECT_EQ(0, memcmp("\x07Score: ", s, 9)); // Includes the terminating '\0'.
+
+    t = T_NOTYPE;
+    p = evaluate(ref, &f, &i64, &s, &t, E_NOERROR);
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(first, s);
+    EXPECT_EQ(0, memcmp("\x07Score: ", s, 9));
+}
+
+TEST_F(MmBasicCoreTest, GetValue_GivenEmptyStringLiteral) {
+    MMFLOAT f = 0.0;
+    MMINTEGER i64 = 0;
+    char *s = NULL;
+    int t = T_NOTYPE;
+    const char *ref = ProgMemoryReference("\"\"");
+
+    for (int i = 0; i < 2; ++i) {
+        const char *p = evaluate(ref, &f, &i64, &s, &t, false);
+
+        EXPECT_STREQ("", error_msg);
+        EXPECT_EQ(T_STR, t);
+        EXPECT_EQ(0, s[0]);
+        EXPECT_EQ(ref + 2, p);
+    }
+}
+
 TEST_F(MmBasicCoreTest, Tokenise_DimStatement) {
     sprintf(inpbuf, "Dim a = 1");
 
@@ -881,6 +1134,233 @@ TEST_F(MmBasicCoreTest, Tokenise_RunStatement) {
     EXPECT_STREQ(expected, tknbuf);
 }
 
+/** The linear scan of the command table that tokenise() used before the trie. */
+static int ReferenceCommandLookup(const char *p, const char **end) {
+    int match_i = -1;
+    ssize_t match_l = 0;
+    for (int i = 0; i < CommandTableSize - 1; i++) {
+        const char *tp2 = p;
+        const char *tp = commandtbl[i].name;
+        while (toupper(*tp2) == toupper(*tp) && *tp != 0) {
+            if (*tp == ' ')
+                skipspace(tp2);
+            else
+                tp2++;
+            tp++;
+            if (*tp == '(') skipspace(tp2);
+        }
+        if (*tp == 0 && (!isnamechar(*tp2) || (commandtbl[i].type & T_FUN))) {
+            if (*(tp - 1) != '(' && isnamechar(*tp2)) continue;
+            if ((ssize_t) strlen(commandtbl[i].name) > match_l) {
+                *end = tp2;
+                match_l = strlen(commandtbl[i].name);
+                match_i = i;
+            }
+        }
+    }
+    return match_i;
+}
+
+/** The linear scan of the token table that tokenise() used before the trie. */
+static int ReferenceTokenLookup(const char *p, const char **end) {
+    for (int i = 0; i < TokenTableSize - 1; i++) {
+        const char *tp2 = p;
+        const char *tp = tokentbl[i].name;
+        while (toupper(*tp2) == toupper(*tp) && *tp != 0) {
+            tp++; tp2++;
+            if (*tp == '(') skipspace(tp2);
+        }
+        if (*tp == 0 && (!isnameend(*(tp - 1)) || !isnamechar(*tp2))) {
+            *end = tp2;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** Variations on 'name' that exercise the case and whitespace handling of the lookups. */
+static std::vector<std::string> KeywordVariations(const char *name) {
+    std::string upper(name), lower(name), spaced;
+    for (auto &c : upper) c = toupper(c);
+    for (auto &c : lower) c = tolower(c);
+    for (const char *p = name; *p; ++p) {
+        if (*p == ' ' || *p == '(') spaced += "   ";
+        spaced += *p;
+    }
+    std::vector<std::string> result;
+    for (const std::string &base : { std::string(name), upper, lower, spaced }) {
+        for (const char *suffix : { "", " x", "x", "1", "(", " (1)", "$", "=", "_" }) {
+            result.push_back(base + suffix);
+            result.push_back(base.substr(0, base.size() - 1) + suffix);
+        }
+    }
+    return result;
+}
+
+TEST_F(MmBasicCoreTest, Tokenise_CommandLookup_MatchesLinearScan) {
+    for (int i = 0; i < CommandTableSize - 1; i++) {
+        for (const std::string &s : KeywordVariations(commandtbl[i].name)) {
+            const char *expected_end = NULL;
+            const int expected = ReferenceCommandLookup(s.c_str(), &expected_end);
+
+            sprintf(inpbuf, "%s", s.c_str());
+            tokenise(0);
+
+            if (expected == -1) {
+                // Either no command or an implied LET.
+                EXPECT_TRUE(!(tknbuf[1] & 0x80) || commandtbl_decode(tknbuf + 1) == cmdLET)
+                        << "\"" << s << "\"";
+            } else {
+                EXPECT_EQ(expected, commandtbl_decode(tknbuf + 1)) << "\"" << s << "\"";
+            }
+        }
+    }
+}
+
+TEST_F(MmBasicCoreTest, Tokenise_TokenLookup_MatchesLinearScan) {
+    for (int i = 0; i < TokenTableSize - 1; i++) {
+        for (const std::string &s : KeywordVariations(tokentbl[i].name)) {
+            const char *expected_end = NULL;
+            const int expected = ReferenceTokenLookup(s.c_str(), &expected_end);
+
+            KeywordMatch matches[KEYWORD_TRIE_MAX_MATCHES];
+            const int num_matches = keyword_trie_match(&tokentbl_trie, s.c_str(), matches);
+            int actual = -1;
+            const char *actual_end = NULL;
+            for (int m = 0; m < num_matches; m++) {
+                const char *name = tokentbl[matches[m].entry].name;
+                if ((actual == -1 || matches[m].entry < actual)
+                        && (!isnameend(name[strlen(name) - 1]) || !isnamechar(*matches[m].end))) {
+                    actual = matches[m].entry;
+                    actual_end = matches[m].end;
+                }
+            }
+
+            EXPECT_EQ(expected, actual) << "\"" << s << "\"";
+            EXPECT_EQ(expected_end, actual_end) << "\"" << s << "\"";
+        }
+    }
+}
+
+TEST_F(MmBasicCoreTest, Tokenise_GivenSpacesWithinKeywords) {
+    sprintf(inpbuf, "End   Sub");
+    tokenise(0);
+    EXPECT_EQ(cmdEND_SUB, commandtbl_decode(tknbuf + 1));
+
+    sprintf(inpbuf, "eXiT fOr");
+    tokenise(0);
+    EXPECT_EQ(GetCommandValue("Exit For"), commandtbl_decode(tknbuf + 1));
+
+    sprintf(inpbuf, "End");
+    tokenise(0);
+    EXPECT_EQ(GetCommandValue("End"), commandtbl_decode(tknbuf + 1));
+
+    sprintf(inpbuf, "x = Mid$  (a$, 1)");
+    tokenise(0);
+    char expected[TKNBUF_SIZE];
+    sprintf(
+            expected,
+            "%c%c%cx %c %ca$, 1)",
+            T_NEWLINE,
+            (cmdLET & 0x7F) + C_BASETOKEN,
+            (cmdLET >> 7) + C_BASETOKEN,
+            GetTokenValue("="),
+            GetTokenValue("Mid$("));
+    EXPECT_STREQ(expected, tknbuf);
+}
+
+TEST_F(MmBasicCoreTest, KeywordTrieMatch_GivenTooManyMatches) {
+    // Every prefix of the longest name is also a name.
+    static std::string names[KEYWORD_TRIE_MAX_MATCHES + 1];
+    struct s_tokentbl table[KEYWORD_TRIE_MAX_MATCHES + 2] = { 0 };
+    for (int i = 0; i <= KEYWORD_TRIE_MAX_MATCHES; i++) {
+        names[i] = std::string(i + 1, 'A');
+        table[i].name = names[i].c_str();
+    }
+    table[KEYWORD_TRIE_MAX_MATCHES + 1].name = "";
+    static KeywordTrie trie;
+    EXPECT_EQ(kOk, keyword_trie_build(&trie, table, KEYWORD_TRIE_MAX_MATCHES + 2, false));
+
+    KeywordMatch matches[KEYWORD_TRIE_MAX_MATCHES];
+    const std::string all(KEYWORD_TRIE_MAX_MATCHES, 'A');
+    EXPECT_EQ(KEYWORD_TRIE_MAX_MATCHES, keyword_trie_match(&trie, all.c_str(), matches));
+
+    // One more match than there is room for is reported rather than dropped.
+    const std::string too_many(KEYWORD_TRIE_MAX_MATCHES + 1, 'A');
+    EXPECT_EQ(-1, keyword_trie_match(&trie, too_many.c_str(), matches));
+}
+
+#define TOKENISE_BENCHMARK_LINES  10000
+
+TEST_F(MmBasicCoreTest, Tokenise_Benchmark_LargeProgram) {
+    static const char *SAMPLE[] = {
+        "Sub draw_box(x%, y%, w%, h%, colour%)",
+        "  Local i%, s$ = \"Hello World\"",
+        "  For i% = 0 To w% - 1 Step 2",
+        "    Pixel x% + i%, y%, colour%",
+        "    If i% Mod 10 = 0 Then Print \"Tick\"; Str$(i%) Else s$ = Left$(s$, 4)",
+        "  Next",
+        "  Do While Len(s$) < 20 And Not Eof(#1)",
+        "    s$ = s$ + Chr$(Asc(Mid$(s$, 1, 1)) + 1)",
+        "  Loop",
+        "  Select Case colour%",
+        "    Case Rgb(Red) : Line x%, y%, x% + w%, y% + h%",
+        "    Case Else : Box x%, y%, w%, h%, 1, colour%",
+        "  End Select",
+        "  Exit Sub",
+        "End Sub",
+        "Function area!(r!) : area! = Pi * r! ^ 2 : End Function",
+    };
+    const int n = sizeof(SAMPLE) / sizeof(SAMPLE[0]);
+
+    // Reference tokenisation of the sample.
+    std::vector<std::string> expected;
+    for (int i = 0; i < n; ++i) {
+        sprintf(inpbuf, "%s", SAMPLE[i]);
+        tokenise(0);
+        expected.push_back(tknbuf);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TOKENISE_BENCHMARK_LINES; ++i) {
+        sprintf(inpbuf, "%s", SAMPLE[i % n]);
+        tokenise(0);
+        if (expected[i % n] != tknbuf) FAIL();
+    }
+    auto trie_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // For comparison, the cost of looking up the same statements' keywords by linear scan.
+    const char *end;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TOKENISE_BENCHMARK_LINES; ++i) {
+        for (const char *p = SAMPLE[i % n]; *p; ++p) {
+            if (p == SAMPLE[i % n] || !isnamechar(p[-1])) {
+                (void) ReferenceCommandLookup(p, &end);
+                (void) ReferenceTokenLookup(p, &end);
+            }
+        }
+    }
+    auto scan_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    KeywordMatch matches[KEYWORD_TRIE_MAX_MATCHES];
+    for (int i = 0; i < TOKENISE_BENCHMARK_LINES; ++i) {
+        for (const char *p = SAMPLE[i % n]; *p; ++p) {
+            if (p == SAMPLE[i % n] || !isnamechar(p[-1])) {
+                (void) keyword_trie_match(&commandtbl_trie, p, matches);
+                (void) keyword_trie_match(&tokentbl_trie, p, matches);
+            }
+        }
+    }
+    auto lookup_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_STREQ("", error_msg);
+    std::cout << "[ BENCHMARK] tokenise() of a " << TOKENISE_BENCHMARK_LINES << " line program" << std::endl;
+    std::cout << "[ BENCHMARK]   tokenise():     " << (TOKENISE_BENCHMARK_LINES / trie_secs) << " lines/s" << std::endl;
+    std::cout << "[ BENCHMARK]   linear lookups: " << (TOKENISE_BENCHMARK_LINES / scan_secs) << " lines/s" << std::endl;
+    std::cout << "[ BENCHMARK]   trie lookups:   " << (TOKENISE_BENCHMARK_LINES / lookup_secs) << " lines/s" << std::endl;
+}
+
 TEST_F(MmBasicCoreTest, PrepareProgram_And_FindSubFun) {
     TokeniseAndAppend("Sub foo()");
     TokeniseAndAppend("End Sub");
@@ -1764,3 +2244,125 @@ TEST_F(MmBasicCoreTest, MakeArgs) {
 
     makeargs(&p, 10, argbuf, argv, argc, ss);
 }
+
+TEST_F(MmBasicCoreTest, PrepareProgram_ResolvesForNext) {
+    TokeniseAndAppend("For i = 1 To 3");
+    TokeniseAndAppend("  For j = 1 To 2 : Next");
+    TokeniseAndAppend("  For k = 1 To 2");
+    TokeniseAndAppend("    For ii = 1 To 2");
+    TokeniseAndAppend("  Next k, ii");
+    TokeniseAndAppend("Next i");
+
+    PrepareProgram(true);
+
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(FindCommand("Next", 3), FindJump("For", 1)->end);
+    EXPECT_EQ(FindCommand("Next", 1), FindJump("For", 2)->end);
+    EXPECT_EQ(FindCommand("Next", 2), FindJump("For", 3)->end);
+    EXPECT_EQ(FindCommand("Next", 2), FindJump("For", 4)->end);
+}
+
+TEST_F(MmBasicCoreTest, PrepareProgram_DoesNotResolveForWithoutNext) {
+    TokeniseAndAppend("For i = 1 To 3");
+    TokeniseAndAppend("Print i");
+
+    PrepareProgram(true);
+
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(NULL, FindJump("For", 1)->end);
+}
+
+TEST_F(MmBasicCoreTest, PrepareProgram_ResolvesDoLoopAndWhileWend) {
+    TokeniseAndAppend("Do");
+    TokeniseAndAppend("  While a < 3");
+    TokeniseAndAppend("    Do While b : Loop");
+    TokeniseAndAppend("  Wend");
+    TokeniseAndAppend("Loop Until c");
+
+    PrepareProgram(true);
+
+    EXPECT_STREQ("", error_msg);
+    EXPECT_EQ(FindCommand("Loop", 2), FindJump("Do", 1)->end);
+    EXPECT_EQ(FindCommand("Loop", 1), FindJump("Do", 2)->end);
+    EXPECT_EQ(FindCommand("Wend", 1), FindJump("While", 1)->end);
+}
+
+TEST_F(MmBasicCoreTest, PrepareProgram_ResolvesIfElseIfElseEndIf) {
+    TokeniseAndAppend("If a Then");
+    TokeniseAndAppend("  If b Then Print \"b\" Else Print \"c\"");
+    TokeniseAndAppend("  If c Then");
+    TokeniseAndAppend("  Else");
+    TokeniseAndAppend("  EndIf");
+    TokeniseAndAppend("ElseIf d Then");
+    TokeniseAndAppend("Else");
+    TokeniseAndAppend("End If");
+
+    PrepareProgram(true);
+
+    EXPECT_STREQ("", error_msg);
+    const struct s_jmptbl *jmp = FindJump("If", 1);
+    EXPECT_EQ(FindCommand("ElseIf", 1), jmp->next);
+    jmp = FindJump("ElseIf", 1);
+    EXPECT_EQ(FindCommand("Else", 2), jmp->next);
+    EXPECT_EQ(FindCommand("End If", 1), jmp->end);
+    jmp = FindJump("Else", 2);
+    EXPECT_EQ(FindCommand("End If", 1), jmp->next);
+    EXPECT_EQ(FindCommand("End If", 1), jmp->end);
+
+    // Single-line IF is not recorded.
+    EXPECT_EQ(NULL, FindJump("If", 2));
+
+    jmp = FindJump("If", 3);
+    EXPECT_EQ(FindCommand("Else", 1), jmp->next);
+    jmp = FindJump("Else", 1);
+    EXPECT_EQ(FindCommand("EndIf", 1), jmp->end);
+}
+
+TEST_F(MmBasicCoreTest, PrepareProgram_ResolvesSelectCase) {
+    TokeniseAndAppend("Select Case a");
+    TokeniseAndAppend("  Case 1");
+    TokeniseAndAppend("    Select Case b");
+    TokeniseAndAppend("      Case 2");
+    TokeniseAndAppend("    End Select");
+    TokeniseAndAppend("  Case 3, 4");
+    TokeniseAndAppend("  Case Else");
+    TokeniseAndAppend("End Select");
+
+    PrepareProgram(true);
+
+    EXPECT_STREQ("", error_msg);
+    const struct s_jmptbl *jmp = FindJump("Select Case", 1);
+    EXPECT_EQ(FindCommand("Case", 1), jmp->next);
+    jmp = FindJump("Case", 1);
+    EXPECT_EQ(FindCommand("Case", 3), jmp->next);
+    EXPECT_EQ(FindCommand("End Select", 2), jmp->end);
+    jmp = FindJump("Case", 3);
+    EXPECT_EQ(FindCommand("Case Else", 1), jmp->next);
+    EXPECT_EQ(FindCommand("End Select", 2), jmp->end);
+    jmp = FindJump("Case Else", 1);
+    EXPECT_EQ(FindCommand("End Select", 2), jmp->end);
+
+    jmp = FindJump("Case", 2);
+    EXPECT_EQ(FindCommand("End Select", 1), jmp->next);
+    EXPECT_EQ(FindCommand("End Select", 1), jmp->end);
+}
+
+TEST_F(MmBasicCoreTest, ClearRuntime_ClearsJumpTable) {
+    TokeniseAndAppend("Do");
+    TokeniseAndAppend("Loop");
+    PrepareProgram(true);
+    EXPECT_EQ(1, jmptbl_count);
+
+    ClearRuntime();
+
+    EXPECT_EQ(0, jmptbl_count);
+    EXPECT_EQ(NULL, FindJump("Do", 1));
+}
+
+TEST_F(MmBasicCoreTest, ClearRuntime_ResetsSerialBlocking) {
+    mmb_options.serial_blocking = false;
+
+    ClearRuntime();
+
+    EXPECT_EQ(true, mmb_options.serial_blocking);
+}
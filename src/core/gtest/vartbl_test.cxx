@@ -619,6 +619,43 @@ TEST_F(VartblTest, Add_ReusesDeletedHashmapSlots) {
     EXPECT_EQ(foo_hash + 1, vartbl[local_3].hash);
 }
 
+TEST_F(VartblTest, Add_IncrementsGenerationOfLevel) {
+    const uint32_t gen_0 = vartbl_generation[GLOBAL_VAR];
+    const uint32_t gen_1 = vartbl_generation[1];
+    int var_idx;
+
+    (void) vartbl_add("local_1", T_INT, 1, NULL, 0, &var_idx);
+
+    EXPECT_EQ(gen_0, vartbl_generation[GLOBAL_VAR]);
+    EXPECT_EQ(gen_1 + 1, vartbl_generation[1]);
+}
+
+TEST_F(VartblTest, Delete_IncrementsGenerationOfLevel) {
+    int var_idx;
+    (void) vartbl_add("global_0", T_INT, GLOBAL_VAR, NULL, 0, &var_idx);
+    (void) vartbl_add("local_1", T_INT, 1, NULL, 0, &var_idx);
+    const uint32_t gen_0 = vartbl_generation[GLOBAL_VAR];
+    const uint32_t gen_1 = vartbl_generation[1];
+
+    vartbl_delete(var_idx);
+
+    EXPECT_EQ(gen_0, vartbl_generation[GLOBAL_VAR]);
+    EXPECT_EQ(gen_1 + 1, vartbl_generation[1]);
+
+    vartbl_delete(0);
+
+    EXPECT_EQ(gen_0 + 1, vartbl_generation[GLOBAL_VAR]);
+}
+
+TEST_F(VartblTest, Init_IncrementsGlobalGeneration) {
+    const uint32_t gen_0 = vartbl_generation[GLOBAL_VAR];
+    vartbl_init_called = false;
+
+    vartbl_init();
+
+    EXPECT_EQ(gen_0 + 1, vartbl_generation[GLOBAL_VAR]);
+}
+
 TEST_F(VartblTest, Delete_GivenScalarInt) {
     int var_idx;
     (void) vartbl_add("global_0", T_INT, GLOBAL_VAR, NULL, 0, &var_idx);
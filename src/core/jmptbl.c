@@ -0,0 +1,105 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+jmptbl.c
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "../Hardware_Includes.h"
+#include "jmptbl.h"
+
+#include <stddef.h>
+
+struct s_jmptbl jmptbl[MAXJMPTBL];
+JmpHashValue jmptbl_hashmap[JMPTBL_HASHMAP_SIZE];
+size_t jmptbl_count = 0;
+
+static inline bool jmptbl_in_prog_memory(const char *stmt) {
+    return stmt >= ProgMemory && stmt < ProgMemory + PROG_FLASH_SIZE;
+}
+
+static inline JmpHashValue jmptbl_hash(const char *stmt) {
+    return (JmpHashValue) ((size_t) (stmt - ProgMemory) % JMPTBL_HASHMAP_SIZE);
+}
+
+MmResult jmptbl_add(const char *stmt, struct s_jmptbl **entry) {
+    *entry = NULL;
+    if (jmptbl_count == MAXJMPTBL) return kContainerFull;
+    if (!jmptbl_in_prog_memory(stmt)) return kInternalFault;
+
+    JmpHashValue hash = jmptbl_hash(stmt);
+    JmpHashValue original_hash = hash;
+    while (jmptbl_hashmap[hash] >= 0) {
+        if (jmptbl[jmptbl_hashmap[hash]].stmt == stmt) return kInternalFault;
+        hash = (hash + 1) % JMPTBL_HASHMAP_SIZE;
+        if (hash == original_hash) return kHashmapFull; // Should never happen because the hashmap
+                                                        // is larger than the jump table.
+    }
+    jmptbl_hashmap[hash] = jmptbl_count;
+
+    *entry = &jmptbl[jmptbl_count++];
+    (*entry)->stmt = stmt;
+    (*entry)->next = NULL;
+    (*entry)->next_line = NULL;
+    (*entry)->end = NULL;
+    (*entry)->hash = hash;
+    return kOk;
+}
+
+void jmptbl_clear() {
+    memset(jmptbl, 0, sizeof(jmptbl[0]) * jmptbl_count);
+    memset(jmptbl_hashmap, 0xFF, sizeof(jmptbl_hashmap));
+    jmptbl_count = 0;
+}
+
+struct s_jmptbl *jmptbl_find(const char *stmt) {
+    if (jmptbl_count == 0 || !jmptbl_in_prog_memory(stmt)) return NULL;
+
+    JmpHashValue hash = jmptbl_hash(stmt);
+    JmpHashValue original_hash = hash;
+    do {
+        const JmpHashValue idx = jmptbl_hashmap[hash];
+        if (idx == -1) break;
+        if (jmptbl[idx].stmt == stmt) return &jmptbl[idx];
+        hash = (hash + 1) % JMPTBL_HASHMAP_SIZE;
+    } while (hash != original_hash);
+
+    return NULL;
+}
@@ -0,0 +1,129 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+jmptbl.h
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#if !defined(MMB4L_JMPTBL_H)
+#define MMB4L_JMPTBL_H
+
+#include "../Configuration.h"
+#include "../common/mmresult.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int16_t JmpHashValue;
+
+/**
+ * Structure of elements in the jump table.
+ *
+ * Each entry records the pre-resolved targets for a single FOR, DO, WHILE,
+ * IF, ELSEIF, ELSE, SELECT CASE, CASE or CASE ELSE statement so that the
+ * interpreter does not have to scan forward through the program to find them.
+ */
+struct s_jmptbl {
+    const char *stmt;       // Pointer to the '\0' terminating the statement in
+                            // program memory, i.e. the value of 'nextstmt'
+                            // when the statement is executed.
+    const char *next;       // IF/ELSEIF   - the next ELSEIF, ELSE or ENDIF
+                            //               at the same level.
+                            // SELECT/CASE - the next CASE, CASE ELSE or
+                            //               END SELECT at the same level.
+    const char *next_line;  // Pointer to the T_NEWLINE of the line containing
+                            // 'next', used for error reporting.
+    const char *end;        // FOR         - the matching NEXT.
+                            // DO/WHILE    - the matching LOOP/WEND.
+                            // ELSEIF/ELSE - the matching ENDIF.
+                            // CASE        - the matching END SELECT.
+    JmpHashValue hash;      // Index of this entry in jmptbl_hashmap[].
+};
+
+/** Table of pre-resolved jump targets. */
+extern struct s_jmptbl jmptbl[MAXJMPTBL];
+
+/**
+ * @brief  Hashmap from the offset of 'stmt' within the program memory to
+ *         the corresponding entry in the \p jmptbl.
+ *         Empty hash table entries will contain -1.
+ */
+extern JmpHashValue jmptbl_hashmap[JMPTBL_HASHMAP_SIZE];
+
+/**
+ * @brief  The number of entries in the \p jmptbl.
+ */
+extern size_t jmptbl_count;
+
+/**
+ * @brief  Adds an entry to the jump table.
+ *
+ * The new entry has all of its targets set to NULL.
+ *
+ * @param  stmt  Pointer to the '\0' terminating the statement in program memory.
+ * @param[out]  entry  On exit, the new entry, or NULL on error.
+ * @return       kOk             - on success.
+ *               kContainerFull  - if the jump table is full.
+ *               kInternalFault  - if \p stmt is not in the program memory or
+ *                                 already has an entry.
+ *               kHashmapFull    - if the jump hashmap is full, this should
+ *                                 never happen because the hashmap is larger
+ *                                 than the jump table.
+ */
+MmResult jmptbl_add(const char *stmt, struct s_jmptbl **entry);
+
+/**
+ * @brief  Clears the jump table.
+ *
+ * This must be called whenever the program memory changes.
+ */
+void jmptbl_clear();
+
+/**
+ * @brief  Finds the entry for a statement in the jump table.
+ *
+ * @param  stmt  Pointer to the '\0' terminating the statement, this may be
+ *               outside the program memory, e.g. in the \p tknbuf, in which
+ *               case the statement is never found.
+ * @return       The entry, or NULL if there is no entry for the statement.
+ */
+struct s_jmptbl *jmptbl_find(const char *stmt);
+
+#endif // #if !defined(MMB4L_JMPTBL_H)
@@ -0,0 +1,149 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+keyword_trie.c
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "commandtbl.h"
+#include "keyword_trie.h"
+
+#include <ctype.h>
+#include <string.h>
+
+static KeywordTrieIndex keyword_trie_add_node(KeywordTrie *trie, char ch) {
+    if (trie->num_nodes == KEYWORD_TRIE_MAX_NODES) return -1;
+    KeywordTrieIndex idx = (KeywordTrieIndex) trie->num_nodes++;
+    trie->nodes[idx].ch = ch;
+    trie->nodes[idx].child = -1;
+    trie->nodes[idx].sibling = -1;
+    trie->nodes[idx].entry = -1;
+    return idx;
+}
+
+/** Finds, or if necessary adds, the child of 'parent' for character 'ch'. */
+static KeywordTrieIndex keyword_trie_child(KeywordTrie *trie, KeywordTrieIndex parent, char ch) {
+    KeywordTrieIndex *link = (parent < 0)
+            ? &trie->roots[(unsigned char) ch]
+            : &trie->nodes[parent].child;
+    if (parent < 0 && *link >= 0) return *link;
+    for (; *link >= 0; link = &trie->nodes[*link].sibling) {
+        if (trie->nodes[*link].ch == ch) return *link;
+    }
+    // Appending preserves the table order amongst siblings.
+    KeywordTrieIndex idx = keyword_trie_add_node(trie, ch);
+    *link = idx;
+    return idx;
+}
+
+MmResult keyword_trie_build(KeywordTrie *trie, const struct s_tokentbl *table, int size,
+                            bool squash_spaces) {
+    trie->num_nodes = 0;
+    trie->squash_spaces = squash_spaces;
+    memset(trie->roots, 0xFF, sizeof(trie->roots));
+
+    for (int i = 0; i < size - 1; i++) {
+        KeywordTrieIndex node = -1;
+        for (const char *s = table[i].name; *s; s++) {
+            node = keyword_trie_child(trie, node, (char) toupper((unsigned char) *s));
+            if (node < 0) return kContainerFull;
+        }
+        // If a name appears twice then the first entry wins, as per the linear scan.
+        if (node >= 0 && trie->nodes[node].entry < 0) trie->nodes[node].entry = i;
+    }
+    return kOk;
+}
+
+/** Records a match, returning false if there is no room for it. */
+static bool keyword_trie_add_match(KeywordTrieIndex entry, const char *end,
+                                   KeywordMatch *matches, int *count) {
+    if (*count == KEYWORD_TRIE_MAX_MATCHES) return false;
+    matches[*count].entry = entry;
+    matches[*count].end = end;
+    (*count)++;
+    return true;
+}
+
+/**
+ * Depth first search of the children of 'node' against the source at 'p'.
+ *
+ * At most two children can match, the one for the current source character
+ * and, if the source has spaces, the one for a '(' following those spaces.
+ *
+ * @return  false if there were more than KEYWORD_TRIE_MAX_MATCHES matches.
+ */
+static bool keyword_trie_walk(const KeywordTrie *trie, KeywordTrieIndex node, const char *p,
+                              KeywordMatch *matches, int *count) {
+    for (KeywordTrieIndex c = trie->nodes[node].child; c >= 0; c = trie->nodes[c].sibling) {
+        const struct s_keyword_trie_node *child = &trie->nodes[c];
+        const char *q = p;
+        if (child->ch == '(') {
+            while (*q == ' ') q++;  // Eat up space between a keyword and bracket.
+        }
+        if ((char) toupper((unsigned char) *q) != child->ch) continue;
+        if (child->ch == ' ' && trie->squash_spaces) {
+            while (*q == ' ') q++;  // Eat up any extra spaces between keywords.
+        } else {
+            q++;
+        }
+        if (child->entry >= 0 && !keyword_trie_add_match(child->entry, q, matches, count)) {
+            return false;
+        }
+        if (child->child >= 0 && !keyword_trie_walk(trie, c, q, matches, count)) return false;
+    }
+    return true;
+}
+
+int keyword_trie_match(const KeywordTrie *trie, const char *p, KeywordMatch *matches) {
+    KeywordTrieIndex root = trie->roots[toupper((unsigned char) *p)];
+    if (root < 0) return 0;
+
+    const struct s_keyword_trie_node *node = &trie->nodes[root];
+    const char *q = p;
+    if (node->ch == ' ' && trie->squash_spaces) {
+        while (*q == ' ') q++;
+    } else {
+        q++;
+    }
+    int count = 0;
+    if (node->entry >= 0) (void) keyword_trie_add_match(node->entry, q, matches, &count);
+    if (node->child >= 0 && !keyword_trie_walk(trie, root, q, matches, &count)) return -1;
+    return count;
+}
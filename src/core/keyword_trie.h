@@ -0,0 +1,122 @@
+/*-*****************************************************************************
+
+MMBasic for Linux (MMB4L)
+
+keyword_trie.h
+
+Copyright 2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holders nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+4. The name MMBasic be used when referring to the interpreter in any
+   documentation and promotional material and the original copyright message
+   be displayed  on the console at startup (additional copyright messages may
+   be added).
+
+5. All advertising materials mentioning features or use of this software must
+   display the following acknowledgement: This product includes software
+   developed by Geoff Graham, Peter Mather and Thomas Hugo Williams.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#if !defined(MMB4L_KEYWORD_TRIE_H)
+#define MMB4L_KEYWORD_TRIE_H
+
+#include "../common/mmresult.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define KEYWORD_TRIE_MAX_NODES    1024
+#define KEYWORD_TRIE_MAX_MATCHES  16
+
+struct s_tokentbl;
+
+typedef int16_t KeywordTrieIndex;
+
+/** A node in a KeywordTrie, there is one per distinct keyword prefix. */
+struct s_keyword_trie_node {
+    char ch;                        // Upper-case character on the edge leading to this node.
+    KeywordTrieIndex child;         // First child node, or -1 if none.
+    KeywordTrieIndex sibling;       // Next sibling node, or -1 if none.
+    KeywordTrieIndex entry;         // Index of the table entry whose name ends at this node,
+                                    // or -1 if none.
+};
+
+/**
+ * Case-insensitive trie over the names in the command or token table.
+ *
+ * This replaces the linear scan of the tables by tokenise(); the rules it
+ * applies to whitespace within names are exactly those of that scan.
+ */
+typedef struct {
+    struct s_keyword_trie_node nodes[KEYWORD_TRIE_MAX_NODES];
+    KeywordTrieIndex roots[256];    // Maps an upper-case first character to its node,
+                                    // or -1 if no name starts with that character.
+    int num_nodes;
+    bool squash_spaces;             // If true then a space in a name matches one or more
+                                    // spaces in the source, otherwise exactly one.
+} KeywordTrie;
+
+/** A candidate keyword found by keyword_trie_match(). */
+typedef struct {
+    int entry;                      // Index of the table entry.
+    const char *end;                // Pointer to the source character after the keyword.
+} KeywordMatch;
+
+/**
+ * @brief  Builds a trie from a command or token table.
+ *
+ * @param  trie           The trie to build.
+ * @param  table          The table, the last entry is the empty sentinel
+ *                        and is not included.
+ * @param  size           Number of entries in the table, including the sentinel.
+ * @param  squash_spaces  Should a space in a name match one or more spaces in
+ *                        the source.
+ * @return                kOk            - on success.
+ *                        kContainerFull - if KEYWORD_TRIE_MAX_NODES is too small.
+ */
+MmResult keyword_trie_build(KeywordTrie *trie, const struct s_tokentbl *table, int size,
+                            bool squash_spaces);
+
+/**
+ * @brief  Finds every table entry whose name matches the start of the source.
+ *
+ * Any spaces in the source before a '(' in a name are skipped. It is the
+ * caller's job to decide which of the candidates is wanted, e.g. the longest
+ * command or the first token that is not followed by a name character.
+ *
+ * @param  trie         The trie to search.
+ * @param  p            The source text.
+ * @param[out] matches  On exit, the matching entries in no particular order.
+ * @return              The number of matches, or -1 if there were more than
+ *                      KEYWORD_TRIE_MAX_MATCHES in which case 'matches' is
+ *                      incomplete; the longest wanted keyword may be missing
+ *                      so the caller must not pick from them.
+ */
+int keyword_trie_match(const KeywordTrie *trie, const char *p, KeywordMatch *matches);
+
+#endif // #if !defined(MMB4L_KEYWORD_TRIE_H)
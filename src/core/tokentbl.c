@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MMBasic.h"
 #include "tokentbl.h"
 #include "../common/error.h"
+#include "../common/utility.h"
 
 #include <strings.h>
 
@@ -57,59 +58,61 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *    TEXT           TYPE                P  FUNCTION TO CALL
  *
  * TYPE - T_NA, T_FUN, T_FNA or T_OPER augmented by the types T_STR
- *        and/or T_NBR and/or T_INT
+ *        and/or T_NBR and/or T_INT, a T_FUN may also be flagged T_INPLACE
+ *        if it evaluates its argument with a single call to evaluate(),
+ *        getnumber(), getstring(), etc. and does not otherwise read 'ep'.
  * P    - Is the precedence, which is only used for operators.
  */
 const struct s_tokentbl tokentbl[] = {
     { "@(",          T_FUN | T_STR,      0, fun_at       },
-    { "Abs(",        T_FUN | T_NBR | T_INT, 0, fun_abs   },
-    { "ACos(",       T_FUN | T_NBR,      0, fun_acos     },
-    { "Asc(",        T_FUN | T_INT,      0, fun_asc      },
-    { "ASin(",       T_FUN | T_NBR,      0, fun_asin     },
+    { "Abs(",        T_FUN | T_NBR | T_INT | T_INPLACE, 0, fun_abs },
+    { "ACos(",       T_FUN | T_NBR | T_INPLACE, 0, fun_acos },
+    { "Asc(",        T_FUN | T_INT | T_INPLACE, 0, fun_asc },
+    { "ASin(",       T_FUN | T_NBR | T_INPLACE, 0, fun_asin },
     { "Atan2(",      T_FUN | T_NBR,      0, fun_atan2    },
-    { "Atn(",        T_FUN | T_NBR,      0, fun_atn      },
+    { "Atn(",        T_FUN | T_NBR | T_INPLACE, 0, fun_atn },
     { "Bin$(",       T_FUN | T_STR,      0, fun_bin      },
     { "Bin2Str$(" ,  T_FUN | T_STR,      0, fun_bin2str  },
     { "Bound(",      T_FUN | T_INT,      0, fun_bound    },
     { "Call(",       T_FUN | T_STR | T_INT | T_NBR, 0, fun_call },
     { "Choice(",     T_FUN | T_STR | T_INT | T_NBR, 0, fun_choice },
     { "Chr$(",       T_FUN | T_STR,      0, fun_chr,     },
-    { "Cint(",       T_FUN | T_INT,      0, fun_cint     },
+    { "Cint(",       T_FUN | T_INT | T_INPLACE, 0, fun_cint },
     { "Classic(",    T_FUN | T_INT,      0, fun_classic  },
-    { "Cos(",        T_FUN | T_NBR,      0, fun_cos      },
+    { "Cos(",        T_FUN | T_NBR | T_INPLACE, 0, fun_cos },
     { "Cwd$",        T_FNA | T_STR,      0, fun_cwd      },
     { "Date$",       T_FNA | T_STR,      0, fun_date     },
     { "DateTime$(",  T_FUN | T_STR,      0, fun_datetime },
     { "Day$(",       T_FUN | T_STR,      0, fun_day      },
-    { "Deg(",        T_FUN | T_NBR,      0, fun_deg      },
+    { "Deg(",        T_FUN | T_NBR | T_INPLACE, 0, fun_deg },
     { "Device(",     T_FUN | T_INT,      0, fun_device   },
     { "Dir$(",       T_FUN | T_STR,      0, fun_dir      },
     { "Eof(",        T_FUN | T_INT,      0, fun_eof      },
     { "Epoch(",      T_FUN | T_INT,      0, fun_epoch    },
     { "Eval(",       T_FUN | T_NBR | T_INT | T_STR, 0, fun_eval },
-    { "Exp(",        T_FUN | T_NBR,      0, fun_exp      },
+    { "Exp(",        T_FUN | T_NBR | T_INPLACE, 0, fun_exp },
     { "Field$(",     T_FUN | T_STR,      0, fun_field    },
-    { "Fix(",        T_FUN | T_INT,      0, fun_fix      },
+    { "Fix(",        T_FUN | T_INT | T_INPLACE, 0, fun_fix },
     { "Format$(",    T_FUN | T_STR,      0, fun_format   },
     { "Gamepad(",    T_FUN | T_INT,      0, fun_gamepad  },
     { "Hex$(",       T_FUN | T_STR,      0, fun_hex      },
     { "Inkey$",      T_FNA | T_STR,      0, fun_inkey    },
     { "Input$(",     T_FUN | T_STR,      0, fun_inputstr },
     { "Instr(",      T_FUN | T_INT,      0, fun_instr    },
-    { "Int(",        T_FUN | T_INT,      0, fun_int      },
+    { "Int(",        T_FUN | T_INT | T_INPLACE, 0, fun_int },
     { "Json$(",      T_FUN | T_STR,      0, fun_json     },
     { "Keydown(",    T_FUN | T_INT,      0, fun_keydown  },
-    { "LCase$(",     T_FUN | T_STR,      0, fun_lcase    },
+    { "LCase$(",     T_FUN | T_STR | T_INPLACE, 0, fun_lcase },
     { "LCompare(",   T_FUN | T_INT,      0, fun_lcompare },
     { "Left$(",      T_FUN | T_STR,      0, fun_left     },
-    { "Len(",        T_FUN | T_INT,      0, fun_len      },
+    { "Len(",        T_FUN | T_INT | T_INPLACE, 0, fun_len },
     { "LGetByte(",   T_FUN | T_INT,      0, fun_lgetbyte },
     { "LGetStr$(",   T_FUN | T_STR,      0, fun_lgetstr  },
     { "LInStr(",     T_FUN | T_INT,      0, fun_linstr   },
     { "LLen(",       T_FUN | T_INT,      0, fun_llen     },
     { "Loc(",        T_FUN | T_INT,      0, fun_loc      },
     { "Lof(",        T_FUN | T_INT,      0, fun_lof      },
-    { "Log(",        T_FUN | T_NBR,      0, fun_log      },
+    { "Log(",        T_FUN | T_NBR | T_INPLACE, 0, fun_log },
     { "Math(",       T_FUN | T_NBR,      0, fun_math     },
     { "Max(",        T_FUN | T_NBR,      0, fun_max      },
     { "Mid$(",       T_FUN | T_STR,      0, fun_mid      },
@@ -130,26 +133,26 @@ const struct s_tokentbl tokentbl[] = {
     { "Pin(",        T_FUN | T_NBR | T_INT, 0, fun_pin   },
     { "Port(",       T_FUN | T_INT,      0, fun_port     },
     { "Pos",         T_FNA | T_INT,      0, fun_pos      },
-    { "Rad(",        T_FUN | T_NBR,      0, fun_rad      },
+    { "Rad(",        T_FUN | T_NBR | T_INPLACE, 0, fun_rad },
     { "Rgb(",        T_FUN | T_INT,      0, fun_rgb      },
     { "Right$(",     T_FUN | T_STR,      0, fun_right    },
     { "Rnd(",        T_FUN | T_NBR,      0, fun_rnd      },  // This must come before Rnd - without bracket.
     { "Rnd",         T_FNA | T_NBR,      0, fun_rnd      },  // This must come after Rnd(.
-    { "Sgn(",        T_FUN | T_INT,      0, fun_sgn      },
-    { "Sin(",        T_FUN | T_NBR,      0, fun_sin      },
-    { "Space$(",     T_FUN | T_STR,      0, fun_space    },
+    { "Sgn(",        T_FUN | T_INT | T_INPLACE, 0, fun_sgn },
+    { "Sin(",        T_FUN | T_NBR | T_INPLACE, 0, fun_sin },
+    { "Space$(",     T_FUN | T_STR | T_INPLACE, 0, fun_space },
     { "Spc(",        T_FUN | T_STR,      0, fun_space    },
     { "Sprite(",     T_FUN | T_INT | T_NBR | T_STR, 0, fun_sprite },
-    { "Sqr(",        T_FUN | T_NBR,      0, fun_sqr      },
+    { "Sqr(",        T_FUN | T_NBR | T_INPLACE, 0, fun_sqr },
     { "Str$(",       T_FUN | T_STR,      0, fun_str      },
     { "Str2Bin(",    T_FUN | T_NBR | T_INT, 0, fun_str2bin  },
     { "String$(",    T_FUN | T_STR,      0, fun_string   },
     { "Tab(",        T_FUN | T_STR,      0, fun_tab,     },
-    { "Tan(",        T_FUN | T_NBR,      0, fun_tan      },
+    { "Tan(",        T_FUN | T_NBR | T_INPLACE, 0, fun_tan },
     { "Time$",       T_FNA | T_STR,      0, fun_time     },
     { "Timer",       T_FNA | T_INT,      0, fun_timer    },
-    { "UCase$(",     T_FUN | T_STR,      0, fun_ucase    },
-    { "Val(",        T_FUN | T_NBR | T_INT, 0, fun_val   },
+    { "UCase$(",     T_FUN | T_STR | T_INPLACE, 0, fun_ucase },
+    { "Val(",        T_FUN | T_NBR | T_INT | T_INPLACE, 0, fun_val },
 
     { "As",          T_NA,               0, op_invalid   },
     { "Else",        T_NA,               0, op_invalid   },
@@ -191,8 +194,13 @@ const struct s_tokentbl tokentbl[] = {
 char tokenTHEN, tokenELSE, tokenGOTO, tokenEQUAL, tokenTO, tokenSTEP;
 char tokenWHILE, tokenUNTIL, tokenGOSUB, tokenAS, tokenFOR;
 
+KeywordTrie tokentbl_trie;
+
 void tokentbl_init() {
     tokentbl_size = sizeof(tokentbl) / sizeof(struct s_tokentbl);
+    if (FAILED(keyword_trie_build(&tokentbl_trie, tokentbl, tokentbl_size, false))) {
+        ERROR_INTERNAL_FAULT;
+    }
 
     tokenTHEN  = tokentbl_get("Then");
     tokenELSE  = tokentbl_get("Else");
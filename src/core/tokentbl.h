@@ -173,6 +173,9 @@ int tokentbl_get(const char *s);
 extern const struct s_tokentbl tokentbl[];
 extern int tokentbl_size;
 
+/** Trie over the token names, used by tokenise(). */
+extern KeywordTrie tokentbl_trie;
+
 // Store commonly used tokens for faster token checking.
 extern char tokenTHEN, tokenELSE, tokenGOTO, tokenEQUAL, tokenTO, tokenSTEP;
 extern char tokenWHILE, tokenUNTIL, tokenGOSUB, tokenAS, tokenFOR;
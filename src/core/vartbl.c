@@ -54,6 +54,7 @@ struct s_vartbl vartbl[MAXVARS];
 VarHashValue vartbl_hashmap[VARS_HASHMAP_SIZE];
 int vartbl_free_idx = 0;
 int varcnt = 0;
+uint32_t vartbl_generation[UINT8_MAX + 1] = { 0 };
 
 void vartbl_init() {
     assert(!vartbl_init_called);
@@ -61,6 +62,7 @@ void vartbl_init() {
     vartbl_free_idx = 0;
     memset(vartbl, 0, MAXVARS * sizeof(struct s_vartbl));
     memset(vartbl_hashmap, 0xFF, sizeof(vartbl_hashmap));
+    vartbl_generation[GLOBAL_VAR]++;  // Not reset, so that any cached lookups are invalidated.
     vartbl_init_called = true;
 }
 
@@ -174,6 +176,7 @@ MmResult vartbl_add(
     }
     vartbl_hashmap[hash] = *var_idx;
     vartbl[*var_idx].hash = hash;
+    vartbl_generation[level]++;
 
     return kOk;
 }
@@ -188,6 +191,7 @@ void vartbl_delete(int var_idx) {
     //printf("vartbl_delete(%d = %s)\n", var_idx, vartbl[var_idx].name);
 
     vartbl_hashmap[vartbl[var_idx].hash] = DELETED_HASH;
+    vartbl_generation[(uint8_t) vartbl[var_idx].level]++;
 
     // FreeMemory associated with string and array variables unless they are pointers.
     if (((vartbl[var_idx].type & T_STR) || vartbl[var_idx].dims[0] != 0)
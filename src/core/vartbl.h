@@ -112,6 +112,16 @@ extern int vartbl_free_idx;
  */
 extern int varcnt;
 
+/**
+ * @brief  Generation counter for each variable level, incremented whenever
+ *         a variable of that level is added to or deleted from the table.
+ *
+ * A cached result of looking up a variable name at a given level remains
+ * valid whilst the counters for that level and for the global level (0) are
+ * unchanged. vartbl_init() also increments the counter for the global level.
+ */
+extern uint32_t vartbl_generation[UINT8_MAX + 1];
+
 /**
  * @brief  Initialises variables/structures for the variables table.
  */
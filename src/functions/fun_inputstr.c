@@ -65,13 +65,8 @@ void fun_inputstr(void) {
         }
         *sret = i - 1;
     } else {
-        char *p = sret + 1;  // point to the start of the char array
-        *sret = nbr;         // set the length of the returned string
-        while (nbr) {
-            if (file_eof(fnbr)) break;
-            *p++ = file_getc(fnbr);
-            nbr--;
-        }
-        *sret -= nbr;  // correct if we get less than nbr chars
+        // Copy straight from the file's read-ahead buffer or memory mapping,
+        // or drain whatever a serial port has already received.
+        *sret = file_read(fnbr, sret + 1, nbr);
     }
 }
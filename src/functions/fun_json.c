@@ -4,7 +4,7 @@ MMBasic for Linux (MMB4L)
 
 fun_json.c
 
-Copyright 2021-2022 Geoff Graham, Peter Mather and Thomas Hugo Williams.
+Copyright 2021-2026 Geoff Graham, Peter Mather and Thomas Hugo Williams.
 
 Redistribution and use in source and binary forms, with or without
 modification, are permitted provided that the following conditions are met:
@@ -45,69 +45,168 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../common/mmb4l.h"
 #include "../third_party/cJSON.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define ERROR_NOT_AN_ITEM  error_throw_ex(kError, "Not an item")
+#define ERROR_INVALID_LONGSTRING_LENGTH  ERROR_INVALID("LONGSTRING length")
 
 #define REPORT_NULL_FLAG  0x01
 #define REPORT_MISSING_FLAG  0x02
 
-static void fun_json_internal(void *varptr, char *key, int64_t flags) {
-
-    int64_t *dest = (int64_t *) varptr;
-    char *json_string = (char *) &dest[1];
-    cJSON *parse = cJSON_Parse(json_string);
-    if (!parse) ERROR_INVALID("JSON data");
-
-    const cJSON *root = parse;
-    int len = strlen(key);
-    char field[32] = { 0 };
-    char num[6] = { 0 };
-    int i = 0, j = 0, k = 0, mode = 0;
-    while (i < len) {
-        if (key[i] == '[') {  // start of index
-            mode = 1;
-            field[j] = 0;
-            root = cJSON_GetObjectItemCaseSensitive(root, field);
-            memset(field, 0, 32);
-            j = 0;
+#define JSON_DOM_CACHE_SIZE   4
+#define JSON_PATH_CACHE_SIZE  8
+
+/** One step of a compiled key, either an object member or an array element. */
+typedef struct {
+    const char *name;  // Member name, NULL if this step is an array index.
+    int index;
+} JsonPathStep;
+
+/** A key such as "a.b[3].c" compiled into a sequence of steps. */
+typedef struct {
+    char key[STRINGSIZE];    // The uncompiled key, empty if the entry is unused.
+    char names[STRINGSIZE];  // Storage for the member names.
+    JsonPathStep steps[STRINGSIZE];
+    int num_steps;
+} JsonPath;
+
+/**
+ * A parsed JSON document.
+ *
+ * The tree is only reused if the LONGSTRING it was parsed from still
+ * contains the same text; comparing the text is much cheaper than parsing it
+ * and unlike a modification count cannot miss any of the many ways the
+ * contents of an array can be changed.
+ */
+typedef struct {
+    const int64_t *longstring;  // NULL if the entry is unused.
+    char *text;                 // Copy of the LONGSTRING contents.
+    int64_t text_len;
+    cJSON *tree;
+    unsigned int last_used;
+} JsonDom;
+
+static JsonPath fun_json_paths[JSON_PATH_CACHE_SIZE];
+static int fun_json_next_path = 0;
+static JsonDom fun_json_doms[JSON_DOM_CACHE_SIZE];
+static unsigned int fun_json_clock = 0;
+
+static void fun_json_compile(const char *key, JsonPath *path) {
+    const char *p = key;
+    char *q = path->names;
+    path->num_steps = 0;
+    for (;;) {
+        // Member name, which may be omitted if followed by an index.
+        const char *name = q;
+        while (*p && *p != '.' && *p != '[') *q++ = *p++;
+        *q++ = '\0';
+        if (*name || *p != '[') path->steps[path->num_steps++] = (JsonPathStep) { name, 0 };
+
+        // Zero or more array indexes.
+        while (*p == '[') {
+            const int index = atoi(++p);
+            while (*p && *p != ']') p++;
+            if (*p) p++;
+            path->steps[path->num_steps++] = (JsonPathStep) { NULL, index };
         }
-        if (key[i] == ']') {
-            num[k] = 0;
-            int index = atoi(num);
-            root = cJSON_GetArrayItem(root, index);
-            memset(num, 0, 6);
-            k = 0;
+
+        if (*p == '.') {
+            p++;
+        } else if (*p == '\0') {
+            break;
         }
-        if (key[i] == '.') {  // new field separator
-            if (mode == 0) {
-                field[j] = 0;
-                root = cJSON_GetObjectItemCaseSensitive(root, field);
-                memset(field, 0, 32);
-                j = 0;
-            } else {  // step past the dot after a close bracket
-                mode = 0;
-            }
+    }
+    strcpy(path->key, key);
+}
+
+/** Gets the compiled form of a key, compiling it if it is not cached. */
+static const JsonPath *fun_json_get_path(const char *key) {
+    for (int i = 0; i < JSON_PATH_CACHE_SIZE; ++i) {
+        if (strcmp(fun_json_paths[i].key, key) == 0 && *key) return &fun_json_paths[i];
+    }
+    JsonPath *path = &fun_json_paths[fun_json_next_path];
+    fun_json_next_path = (fun_json_next_path + 1) % JSON_PATH_CACHE_SIZE;
+    fun_json_compile(key, path);
+    return path;
+}
+
+/** Frees the cached documents, called by ClearRuntime(). */
+void fun_json_clear_cache(void) {
+    for (int i = 0; i < JSON_DOM_CACHE_SIZE; ++i) {
+        cJSON_Delete(fun_json_doms[i].tree);
+        free(fun_json_doms[i].text);
+    }
+    memset(fun_json_doms, 0, sizeof(fun_json_doms));
+    fun_json_clock = 0;
+}
+
+/**
+ * Gets the parsed form of a LONGSTRING, parsing it if it is not cached.
+ *
+ * @param  longstring  the LONGSTRING.
+ * @param  capacity    maximum number of bytes the LONGSTRING can hold.
+ */
+static const cJSON *fun_json_get_dom(const int64_t *longstring, int64_t capacity) {
+    const char *text = (const char *) &longstring[1];
+    const int64_t text_len = longstring[0];
+    if (text_len < 0 || text_len > capacity) ERROR_INVALID_LONGSTRING_LENGTH;
+
+    JsonDom *dom = &fun_json_doms[0];
+    for (int i = 0; i < JSON_DOM_CACHE_SIZE; ++i) {
+        JsonDom *candidate = &fun_json_doms[i];
+        if (candidate->longstring == longstring
+                && candidate->text_len == text_len
+                && memcmp(candidate->text, text, text_len) == 0) {
+            candidate->last_used = ++fun_json_clock;
+            return candidate->tree;
+        }
+        if (candidate->last_used < dom->last_used) dom = candidate;
+    }
+
+    // Replace the least recently used entry.
+    cJSON_Delete(dom->tree);
+    free(dom->text);
+    memset(dom, 0, sizeof(JsonDom));
+
+    cJSON *tree = cJSON_ParseWithLength(text, text_len);
+    if (!tree) ERROR_INVALID("JSON data");
+    dom->text = malloc(text_len > 0 ? text_len : 1);
+    if (!dom->text) {
+        cJSON_Delete(tree);
+        ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(dom->text, text, text_len);
+    dom->text_len = text_len;
+    dom->tree = tree;
+    dom->longstring = longstring;
+    dom->last_used = ++fun_json_clock;
+    return tree;
+}
+
+static void fun_json_internal(void *varptr, int64_t capacity, char *key, int64_t flags) {
+    const cJSON *root = fun_json_get_dom((const int64_t *) varptr, capacity);
+    const JsonPath *path = fun_json_get_path(key);
+
+    for (int i = 0; i < path->num_steps; ++i) {
+        const JsonPathStep *step = &path->steps[i];
+        if (!step->name) {
+            root = cJSON_GetArrayItem(root, step->index);
+        } else if (i == path->num_steps - 1) {
+            root = cJSON_GetObjectItem(root, step->name);  // Final member is case-insensitive.
         } else {
-            if (mode == 0)
-                field[j++] = key[i];
-            else if (key[i] != '[')
-                num[k++] = key[i];
+            root = cJSON_GetObjectItemCaseSensitive(root, step->name);
         }
-        i++;
     }
 
-    root = cJSON_GetObjectItem(root, field);
     targ = T_STR;
     sret = GetTempStrMemory();
 
     if (cJSON_IsObject(root) || cJSON_IsInvalid(root)) {
-        cJSON_Delete(parse);
         ERROR_NOT_AN_ITEM;
     } else if (cJSON_IsNull(root)) {
         strcpy(sret, flags & REPORT_NULL_FLAG ? "<null>" : "");
-        cJSON_Delete(parse);
     } else if (cJSON_IsNumber(root)) {
         MMFLOAT tempd = root->valuedouble;
         if ((MMFLOAT) ((int64_t) tempd) == tempd) {
@@ -115,17 +214,13 @@ static void fun_json_internal(void *varptr, char *key, int64_t flags) {
         } else {
             FloatToStr(sret, tempd, 0, STR_AUTO_PRECISION, ' ');
         }
-        cJSON_Delete(parse);
     } else if (cJSON_IsBool(root)) {
         strcpy(sret, root->valueint ? "true" : "false");
-        cJSON_Delete(parse);
     } else if (cJSON_IsString(root)) {
         strcpy(sret, root->valuestring);
-        cJSON_Delete(parse);
     } else {
         // Key not found.
         strcpy(sret, flags & REPORT_MISSING_FLAG ? "<missing>" : "");
-        cJSON_Delete(parse);
     }
 
     targ = T_STR;
@@ -142,6 +237,7 @@ void fun_json(void) {
     if (!(vartbl[VarIndex].type & T_INT)) ERROR_ARG_NOT_INTEGER_ARRAY(1);
     if (vartbl[VarIndex].dims[1] != 0) ERROR_INVALID_VARIABLE;
     if (vartbl[VarIndex].dims[0] <= 0) ERROR_ARG_NOT_INTEGER_ARRAY(1);
+    const int64_t capacity = (vartbl[VarIndex].dims[0] - mmb_options.base) * 8;
 
     // Second argument is the key to lookup in the JSON.
     char *key = getCstring(argv[2]);
@@ -152,5 +248,5 @@ void fun_json(void) {
         flags = getint(argv[4], 0, 3);
     }
 
-    fun_json_internal(varptr, key, flags);
+    fun_json_internal(varptr, capacity, key, flags);
 }
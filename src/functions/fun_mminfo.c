@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../common/mmb4l.h"
 #include "../common/console.h"
 #include "../common/cstring.h"
+#include "../common/file.h"
 #include "../common/flash.h"
 #include "../common/fonttbl.h"
 #include "../common/gamepad.h"
@@ -55,6 +56,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../common/parse.h"
 #include "../common/path.h"
 #include "../common/program.h"
+#include "../common/scheduler.h"
+#include "../common/serial.h"
 #include "../common/utility.h"
 
 #include <stdlib.h>
@@ -72,6 +75,26 @@ static void mminfo_architecture(const char *p) {
     CtoM(g_string_rtn);
 }
 
+static void mminfo_background(const char *p) {
+    const char *p2;
+    if ((p2 = checkstring(p, "POLLS"))) {
+        if (!parse_is_end(p2)) ERROR_SYNTAX;
+        g_integer_rtn = (MMINTEGER) scheduler_polls;
+    } else {
+        const SchedulerTask *task = NULL;
+        for (int i = 0; i < scheduler_count; ++i) {
+            if ((p2 = checkstring(p, scheduler_tasks[i].name))) {
+                task = &scheduler_tasks[i];
+                break;
+            }
+        }
+        if (!task) ERROR_UNKNOWN_ARGUMENT;
+        if (!parse_is_end(p2)) ERROR_SYNTAX;
+        g_integer_rtn = (MMINTEGER) task->runs;
+    }
+    g_rtn_type = T_INT;
+}
+
 static void mminfo_calldepth(const char *p) {
     if (!parse_is_end(p)) ERROR_SYNTAX;
     g_integer_rtn = LocalIndex;
@@ -86,6 +109,19 @@ static void mminfo_cmdline(const char *p) {
     CtoM(g_string_rtn);
 }
 
+static void mminfo_console(const char *p) {
+    const char *p2;
+    if ((p2 = checkstring(p, "BYTES"))) {
+        g_integer_rtn = (MMINTEGER) console_tx_bytes;
+    } else if ((p2 = checkstring(p, "FLUSHES"))) {
+        g_integer_rtn = (MMINTEGER) console_tx_flushes;
+    } else {
+        ERROR_UNKNOWN_ARGUMENT;
+    }
+    if (!parse_is_end(p2)) ERROR_SYNTAX;
+    g_rtn_type = T_INT;
+}
+
 static void mminfo_cpuspeed(const char *p) {
     if (!parse_is_end(p)) ERROR_SYNTAX;
     if (mmb_options.simulate != kSimulatePicoMiteVga && mmb_options.simulate != kSimulateGameMite) {
@@ -309,6 +345,12 @@ static void mminfo_gamepad(const char *p) {
     CtoM(g_string_rtn);
 }
 
+static void mminfo_heap(const char *p) {
+    if (!parse_is_end(p)) ERROR_SYNTAX;
+    g_rtn_type = T_INT;
+    g_integer_rtn = FreeSpaceOnHeap();
+}
+
 void mminfo_hres(const char *p) {
     if (!parse_is_end(p)) ERROR_SYNTAX;
     g_rtn_type = T_INT;
@@ -474,6 +516,15 @@ static void mminfo_sdcard(const char *p) {
     CtoM(g_string_rtn);
 }
 
+static void mminfo_txqueue(const char *p) {
+    int fnbr = parse_file_number(p, false);
+    if (fnbr == -1) error_throw(kFileInvalidFileNumber);
+    if (file_table[fnbr].type == fet_closed) error_throw(kFileNotOpen);
+    if (file_table[fnbr].type != fet_serial) ERROR_NOT_SERIAL_PORT;
+    g_integer_rtn = serial_tx_queue_size(fnbr);
+    g_rtn_type = T_INT;
+}
+
 static void mminfo_version(const char *p) {
     const char *p2;
     g_rtn_type = T_INT;
@@ -531,10 +582,14 @@ void fun_mminfo(void) {
     const char *p;
     if ((p = checkstring(ep, "ARCH"))) {
         mminfo_architecture(p);
+    } else if ((p = checkstring(ep, "BACKGROUND"))) {
+        mminfo_background(p);
     } else if ((p = checkstring(ep, "CALLDEPTH"))) {
         mminfo_calldepth(p);
     } else if ((p = checkstring(ep, "CMDLINE"))) {
         mminfo_cmdline(p);
+    } else if ((p = checkstring(ep, "CONSOLE"))) {
+        mminfo_console(p);
     } else if ((p = checkstring(ep, "CPUSPEED"))) {
         mminfo_cpuspeed(p);
     } else if ((p = checkstring(ep, "CPUTIME"))) {
@@ -567,6 +622,8 @@ void fun_mminfo(void) {
         mminfo_fontwidth(p);
     } else if ((p = checkstring(ep, "GAMEPAD"))) {
         mminfo_gamepad(p);
+    } else if ((p = checkstring(ep, "HEAP"))) {
+        mminfo_heap(p);
     } else if ((p = checkstring(ep, "HRES"))) {
         mminfo_hres(p);
     } else if ((p = checkstring(ep, "HPOS"))) {
@@ -587,6 +644,8 @@ void fun_mminfo(void) {
         mminfo_ps2(p);
     } else if ((p = checkstring(ep, "SDCARD"))) {
         mminfo_sdcard(p);
+    } else if ((p = checkstring(ep, "TXQUEUE"))) {
+        mminfo_txqueue(p);
     } else if ((p = checkstring(ep, "VERSION"))) {
         mminfo_version(p);
     } else if ((p = checkstring(ep, "VRES"))) {
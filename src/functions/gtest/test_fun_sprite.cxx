@@ -42,6 +42,9 @@ void MMgetline(int fnbr, char *p) {}
 // Defined in "commands/cmd_read.c"
 void cmd_read_clear_cache()  { }
 
+// Defined in "functions/fun_json.c"
+void fun_json_clear_cache()  { }
+
 // Defined in "common/console.c"
 int console_kbhit(void) { return 0; }
 char console_putc(char c) { return c; }
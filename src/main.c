@@ -57,8 +57,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "common/path.h"
 #include "common/program.h"
 #include "common/prompt.h"
+#include "common/scheduler.h"
 #include "common/serial.h"
 #include "common/utility.h"
+#include "common/wait.h"
 #include "core/tokentbl.h"
 
 #include <stdlib.h>
@@ -214,6 +216,7 @@ void longjmp_handler(int jmp_state) {
     }
 
     audio_term();
+    file_flush_all();
 
     int do_exit = false;
     switch (jmp_state) {
@@ -248,6 +251,7 @@ void longjmp_handler(int jmp_state) {
             break;
     }
 
+    console_flush();
     if (do_exit) {
         exit(mmb_exit_code);
     }
@@ -259,6 +263,54 @@ void longjmp_handler(int jmp_state) {
     reset_console_title();
 }
 
+static void console_task(void) {
+    console_pump_input();
+}
+
+static void flush_task(void) {
+    console_flush();
+}
+
+/** Pumps all the serial port connections for input. */
+static void serial_task(void) {
+    for (int i = 1; i <= MAXOPENFILES; ++i) {
+        if (file_table[i].type == fet_serial) {
+            serial_pump_input(i);
+        }
+    }
+}
+
+static void audio_task(void) {
+    ON_FAILURE_ERROR(audio_background_tasks());
+}
+
+/**
+ * Registers the "background" tasks with the scheduler:
+ *  - pump for console input
+ *  - flush console output
+ *  - pump serial ports for input and queued output
+ *  - pump for SDL events
+ *  - refresh graphics windows
+ *  - top up the audio buffer
+ *
+ * These used to all be performed after every statement, they are now only
+ * performed when their period has elapsed.
+ */
+static void init_background_tasks(void) {
+    scheduler_clear();
+    MmResult result = kOk;
+    if (SUCCEEDED(result)) result = scheduler_add("CONSOLE", console_task, MILLISECONDS_TO_NANOSECONDS(CONSOLE_PUMP_PERIOD), true);
+    if (SUCCEEDED(result)) result = scheduler_add("FLUSH", flush_task, MILLISECONDS_TO_NANOSECONDS(CONSOLE_FLUSH_PERIOD), true);
+    if (SUCCEEDED(result)) result = scheduler_add("SERIAL", serial_task, MILLISECONDS_TO_NANOSECONDS(SERIAL_PUMP_PERIOD), true);
+    if (SUCCEEDED(result)) result = scheduler_add("EVENTS", events_pump, MILLISECONDS_TO_NANOSECONDS(EVENTS_PUMP_PERIOD), false);
+    if (SUCCEEDED(result)) result = scheduler_add("GRAPHICS", graphics_refresh_windows, MILLISECONDS_TO_NANOSECONDS(GRAPHICS_PUMP_PERIOD), false);
+    if (SUCCEEDED(result)) result = scheduler_add("AUDIO", audio_task, MILLISECONDS_TO_NANOSECONDS(AUDIO_PUMP_PERIOD), false);
+    if (FAILED(result)) {
+        fprintf(stderr, "Failed to initialise background tasks: %s\n", mmresult_to_string(result));
+        exit(EX_FAIL);
+    }
+}
+
 int main(int argc, char *argv[]) {
     MmResult result = cmdline_parse(argc, (const char **) argv, &mmb_args);
     if (FAILED(result)) {
@@ -319,6 +371,7 @@ int main(int argc, char *argv[]) {
 
     interrupt_init();
     mmtime_init();
+    init_background_tasks();
     srand(0);  // seed the random generator with zero
     set_start_directory();
 
@@ -401,29 +454,10 @@ void FlashWriteInit() {
     CurrentFile[0] = 0;
 }
 
-/**
- * Peforms "background" tasks:
- *  - pump for console input
- *  - pump for serial port input
- */
-static void perform_background_tasks() {
-    // TODO: consolidate with pumping the serial port connections ?
-    console_pump_input();
-
-    // Pump all the serial port connections for input.
-    for (int i = 1; i <= MAXOPENFILES; ++i) {
-        if (file_table[i].type == fet_serial) {
-            serial_pump_input(i);
-        }
-    }
-
-    events_pump();
-    graphics_refresh_windows();
-    ON_FAILURE_ERROR(audio_background_tasks());
-}
-
 void CheckAbort(void) {
-    if (!MMAbort) perform_background_tasks();
+    // The break key is delivered by the console task, so MMAbort is re-checked
+    // after polling.
+    if (!MMAbort) scheduler_poll();
 
     if (MMAbort) {
         // g_key_select = 0;
@@ -448,7 +482,7 @@ int MMgetchar(void) {
                 mmb_exit_code = 1;
                 longjmp(mark, JMP_QUIT);
             }
-            nanosleep(&ONE_MILLISECOND, NULL);
+            wait_for_work(WAIT_FOREVER);
         // } else if (c == 3) {
         //     longjmp(mark, JMP_BREAK); // jump back to the input prompt if CTRL-C
         } else if (c == '\n' && prevchar == '\r') {
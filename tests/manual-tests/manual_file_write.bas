@@ -0,0 +1,34 @@
+' Copyright (c) 2026 Thomas Hugo Williams
+' License MIT <https://opensource.org/licenses/MIT>
+' For MMB4L 0.7
+
+' Compares the throughput of buffered and unbuffered file output.
+
+Option Base 0
+Option Default None
+Option Explicit On
+
+Const FILE$ = "/tmp/manual_file_write.txt"
+Const MB% = 16
+Const TEXT$ = String$(63, "x")
+
+run_test("UNBUFFERED")
+run_test("LINE")
+run_test("BUFFERED")
+Kill FILE$
+End
+
+Sub run_test(flag$)
+  Local i%, t! = Timer
+  Select Case flag$
+    Case "UNBUFFERED" : Open FILE$ For Output As #1, UNBUFFERED
+    Case "LINE"       : Open FILE$ For Output As #1, LINE
+    Case Else         : Open FILE$ For Output As #1, BUFFERED
+  End Select
+  For i% = 1 To MB% * 1024 * 1024 / 64
+    Print #1, TEXT$
+  Next
+  Close #1
+  t! = Timer - t!
+  Print flag$ Space$(12 - Len(flag$)) ": " Str$(MB% * 1000 / t!, 0, 2) " MB/s"
+End Sub
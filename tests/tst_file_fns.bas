@@ -38,9 +38,11 @@ add_test("test_loc")
 add_test("test_loc_errors")
 add_test("test_lof")
 add_test("test_lof_errors")
+add_test("test_loc_lof_seek_while_reading")
 add_test("test_rename")
 add_test("test_seek")
 add_test("test_seek_errors")
+add_test("test_seek_after_inputstr_across_buffer")
 add_test("test_tilde_expansion")
 add_test("test_open_errors")
 add_test("test_append_eof_bug")
@@ -48,6 +50,13 @@ add_test("test_open_for_input")
 add_test("test_open_for_output")
 add_test("test_open_for_append")
 add_test("test_open_for_random")
+add_test("test_open_for_map")
+add_test("test_open_for_map_errors")
+add_test("test_open_buffering")
+add_test("test_open_buffering_errors")
+add_test("test_flush")
+add_test("test_flush_errors")
+add_test("test_line_input_large_file")
 add_test("OPEN RANDOM and LINE INPUT at beginning", "test_open_random_line_beginning")
 add_test("OPEN RANDOM and LINE INPUT in middle", "test_open_random_line_middle")
 add_test("OPEN RANDOM and LINE INPUT at end", "test_open_random_line_end")
@@ -507,6 +516,47 @@ Sub test_lof()
   Close #1
 End Sub
 
+Sub test_loc_lof_seek_while_reading()
+  MkDir TMPDIR$
+  Const f$ = TMPDIR$ + "/test_loc_lof_seek_while_reading"
+  Local i%, s$
+
+  Open f$ For Output As #1
+  For i% = 0 To 9999
+    Print #1, Chr$(Asc("A") + i% Mod 26);
+  Next
+  Close #1
+
+  Open f$ For Random As #1
+  Seek #1, 1
+  i% = 0
+  Do While Loc(#1) <= Lof(#1)
+    s$ = Input$(1, #1)
+    assert_string_equals(Chr$(Asc("A") + i% Mod 26), s$)
+    Inc i%
+  Loop
+  assert_int_equals(10000, i%)
+  assert_true(Eof(#1))
+
+  ' Seek backwards and forwards, near to and far from the current position.
+  For i% = 10000 To 1 Step -997
+    Seek #1, i%
+    assert_int_equals(i%, Loc(#1))
+    assert_string_equals(Chr$(Asc("A") + (i% - 1) Mod 26), Input$(1, #1))
+    Seek #1, i% - 1
+    assert_int_equals(i% - 1, Loc(#1))
+  Next
+
+  ' Write beyond the end of the file.
+  Seek #1, Lof(#1) + 1
+  Print #1, "foo";
+  assert_int_equals(10003, Lof(#1))
+  assert_int_equals(10004, Loc(#1))
+  Seek #1, 10001
+  assert_string_equals("foo", Input$(3, #1))
+  Close #1
+End Sub
+
 Sub test_lof_errors()
   MkDir TMPDIR$
 
@@ -565,6 +615,48 @@ Sub test_seek()
   Close #1
 End Sub
 
+' Gets the expected contents of the file written by
+' test_seek_after_inputstr_across_buffer() starting at 1-based 'pos%'.
+Function expected_alphabet$(pos%, count%)
+  Local i%
+  For i% = pos% To pos% + count% - 1
+    Cat expected_alphabet$, Chr$(Asc("A") + (i% - 1) Mod 26)
+  Next
+End Function
+
+Sub test_seek_after_inputstr_across_buffer()
+  MkDir TMPDIR$
+
+  Const f$ = TMPDIR$ + "/test_seek_after_inputstr_across_buffer"
+  Local i%, pos%, s$
+
+  Open f$ For Output As #1
+  For i% = 1 To 400
+    Print #1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  Next
+  Close #1
+
+  Open f$ For Input As #1
+
+  ' Read until past the end of the first read-ahead buffer (4096 bytes on
+  ' MMB4L) so that some of the INPUT$ calls read beyond it.
+  s$ = Input$(1, #1)
+  assert_string_equals("A", s$)
+  Do While Loc(#1) < 5000
+    pos% = Loc(#1)
+    s$ = Input$(255, #1)
+    assert_string_equals(expected_alphabet$(pos%, 255), s$)
+  Loop
+
+  ' Seek backwards to a position within the last buffer length.
+  pos% = Loc(#1) - 100
+  Seek #1, pos%
+  s$ = Input$(10, #1)
+  assert_string_equals(expected_alphabet$(pos%, 10), s$)
+
+  Close #1
+End Sub
+
 Sub test_seek_errors()
   MkDir TMPDIR$
 
@@ -809,6 +901,186 @@ Sub test_open_for_append()
   Close #1
 End Sub
 
+Sub test_open_for_map()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  MkDir TMPDIR$
+  Const f$ = TMPDIR$ + "/test_open_for_map.txt"
+  given_test_file(f$)
+
+  Open f$ For Map As #1
+  assert_int_equals(28, Lof(#1))
+  assert_int_equals(1, Loc(#1))
+  Local s$
+  Line Input #1, s$
+  assert_string_equals("Hello World", s$)
+  assert_int_equals(14, Loc(#1))
+  assert_false(Eof(#1))
+  assert_string_equals("Goodbye", Input$(7, #1))
+  Seek #1, 7
+  assert_string_equals("World" + CRLF$ + "Goodbye World" + CRLF$, Input$(255, #1))
+  assert_true(Eof(#1))
+  assert_string_equals("", Input$(1, #1))
+  Seek #1, 15
+  Line Input #1, s$
+  assert_string_equals("oodbye World", s$)
+  Close #1
+
+  ' Empty file.
+  Open f$ For Output As #1
+  Close #1
+  Open f$ For Map As #1
+  assert_int_equals(0, Lof(#1))
+  assert_true(Eof(#1))
+  Line Input #1, s$
+  assert_string_equals("", s$)
+  Close #1
+End Sub
+
+Sub test_open_for_map_errors()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  MkDir TMPDIR$
+  Const f$ = TMPDIR$ + "/test_open_for_map_errors.txt"
+  given_test_file(f$)
+
+  ' Mapped files are read-only.
+  Open f$ For Map As #1
+  On Error Skip 1
+  Print #1, "foo"
+  assert_raw_error(BAD_FILE_DESCRIPTOR_ERR$)
+  Close #1
+
+  ' File does not exist.
+  On Error Skip 1
+  Open TMPDIR$ + "/does_not_exist.txt" For Map As #1
+  assert_raw_error("No such file or directory")
+End Sub
+
+Sub test_open_buffering()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  MkDir TMPDIR$
+  Const f$ = TMPDIR$ + "/test_open_buffering.txt"
+  Local flags$(2) = ("BUFFERED", "LINE", "UNBUFFERED"), i%, s$
+
+  For i% = 0 To 2
+    Open f$ For Output As #1, flags$(i%)
+    Print #1, "Moses supposes his toeses are roses"
+    Print #1, "But Moses supposes eroneously"
+    Close #1
+
+    Open f$ For Input As #1
+    Line Input #1, s$
+    assert_string_equals("Moses supposes his toeses are roses", s$)
+    Line Input #1, s$
+    assert_string_equals("But Moses supposes eroneously", s$)
+    Close #1
+  Next
+
+  ' Unbuffered and line buffered output is visible immediately.
+  Open f$ For Output As #1, LINE
+  Print #1, "Hello World"
+  Open f$ For Input As #2
+  Line Input #2, s$
+  assert_string_equals("Hello World", s$)
+  Close #2
+  Close #1
+
+  Open f$ For Output As #1, UNBUFFERED
+  Print #1, "Goodbye";
+  Open f$ For Input As #2
+  assert_string_equals("Goodbye", Input$(7, #2))
+  Close #2
+  Close #1
+End Sub
+
+Sub test_open_buffering_errors()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  MkDir TMPDIR$
+  On Error Skip 1
+  Open TMPDIR$ + "/test_open_buffering_errors.txt" For Output As #1, WOMBAT
+  assert_raw_error("Invalid file buffering")
+
+  ' File should not have been opened.
+  Open TMPDIR$ + "/test_open_buffering_errors.txt" For Output As #1
+  Close #1
+End Sub
+
+Sub test_flush()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  MkDir TMPDIR$
+  Const f$ = TMPDIR$ + "/test_flush.txt"
+  Local s$
+
+  Open f$ For Output As #1
+  Print #1, "Hello World"
+  Flush #1
+  Open f$ For Input As #2
+  Line Input #2, s$
+  assert_string_equals("Hello World", s$)
+  Close #2
+
+  ' Writing again after reading.
+  Print #1, "Goodbye World"
+  Flush 1
+  Open f$ For Input As #2
+  Line Input #2, s$
+  Line Input #2, s$
+  assert_string_equals("Goodbye World", s$)
+  Close #2
+  Close #1
+
+  ' Flushing the console.
+  Flush #0
+End Sub
+
+Sub test_flush_errors()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  On Error Skip 1
+  Flush #1
+  assert_raw_error(FILE_NOT_OPEN_ERR$)
+
+  On Error Skip 1
+  Flush #MAX_FILE_NBR% + 1
+  assert_raw_error(INVALID_FILE_NBR_ERR$)
+End Sub
+
+Sub test_line_input_large_file()
+  MkDir TMPDIR$
+  Const f$ = TMPDIR$ + "/test_line_input_large_file.txt"
+  Local i%, loc%, s$
+
+  ' Lines of varying length so that they straddle any read-ahead buffer boundary.
+  Open f$ For Output As #1
+  For i% = 1 To 2000
+    Print #1, Str$(i%) + String$(i% Mod 97, "x")
+  Next
+  Print #1, "foo" + Chr$(13)
+  Print #1, "bar";
+  Close #1
+
+  Open f$ For Input As #1
+  loc% = 1
+  For i% = 1 To 2000
+    assert_false(Eof(#1))
+    Line Input #1, s$
+    assert_string_equals(Str$(i%) + String$(i% Mod 97, "x"), s$)
+    Inc loc%, Len(s$) + Len(CRLF$)
+    assert_int_equals(loc%, Loc(#1))
+  Next
+  Line Input #1, s$
+  assert_string_equals("foo", s$)
+  Line Input #1, s$
+  assert_string_equals("bar", s$)
+  assert_true(Eof(#1))
+  assert_int_equals(Lof(#1) + 1, Loc(#1))
+  Close #1
+End Sub
+
 Sub test_open_for_random()
   MkDir TMPDIR$
   Const f$ = TMPDIR$ + "/test_open_for_random.txt"
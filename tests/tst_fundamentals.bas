@@ -28,6 +28,7 @@ add_test("test_error_correct_after_goto")
 add_test("test_error_correct_after_gosub")
 add_test("test_equals_as_string_terminator")
 add_test("test_if_then_if_then")
+add_test("test_numeric_literals_in_loop")
 
 If InStr(Mm.CmdLine$, "--base") Then run_tests() Else run_tests("--base=1")
 
@@ -284,3 +285,15 @@ Sub test_if_then_if_then()
   If 1 Then If 1 Then assert_true(1) : Exit Sub
   assert_fail("IF THEN IF THEN failed")
 End Sub
+
+Sub test_numeric_literals_in_loop()
+  Local i%, x! = 1.0, y% = 0, z! = 0.0
+  For i% = 1 To 3
+    x! = x! * 1.5 + 42
+    y% = y% + &hFF + &o17 + &b101 + 1000
+    z! = z! + 2.5E+2 + .25
+  Next
+  assert_float_equals(202.875, x!)
+  assert_int_equals(3825, y%)
+  assert_float_equals(750.75, z!)
+End Sub
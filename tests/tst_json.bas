@@ -19,6 +19,9 @@ If sys.is_platform%("pm*") Then Goto skip_tests
 Const BASE% = Mm.Info(Option Base)
 
 add_test("test_json")
+add_test("test_json_given_modified_data")
+add_test("test_json_given_nested_arrays")
+add_test("test_json_given_invalid_length")
 
 skip_tests:
 
@@ -73,6 +76,90 @@ Sub test_json()
   EndIf
 End Sub
 
+' Replaces single quotes with double quotes.
+Function to_json$(s$)
+  Local i%
+  to_json$ = s$
+  For i% = 1 To Len(s$)
+    If Mid$(s$, i%, 1) = "'" Then Mid$(to_json$, i%, 1) = Chr$(34)
+  Next
+End Function
+
+Sub test_json_given_modified_data()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  Local a%(100), b%(100), s$
+  LongString Append a%(), to_json$("{ 'x': 1, 'y': 2 }")
+  assert_string_equals("1", Json$(a%(), "x"))
+  assert_string_equals("2", Json$(a%(), "y"))
+
+  ' Same length, different contents.
+  LongString Replace a%(), "3", 8
+  assert_string_equals("3", Json$(a%(), "x"))
+  assert_string_equals("2", Json$(a%(), "y"))
+
+  ' Modified by direct array write.
+  Poke Var a%(), 8 + 15, Asc("4")
+  assert_string_equals("3", Json$(a%(), "x"))
+  assert_string_equals("4", Json$(a%(), "y"))
+
+  ' Different array, same contents.
+  LongString Copy b%(), a%()
+  assert_string_equals("4", Json$(b%(), "y"))
+  LongString Clear b%()
+  LongString Append b%(), to_json$("{ 'y': 5 }")
+  assert_string_equals("5", Json$(b%(), "y"))
+  assert_string_equals("4", Json$(a%(), "y"))
+
+  ' Invalid JSON.
+  LongString Clear a%()
+  LongString Append a%(), "{ wombat"
+  On Error Skip 1
+  s$ = Json$(a%(), "x")
+  assert_raw_error("Invalid JSON data")
+End Sub
+
+Sub test_json_given_nested_arrays()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  Local a%(100), i%
+  LongString Append a%(), to_json$("{'m': [[1, 2], [3, {'n': [4, 5, 6]}]], 'o': {'p': {'q': 'r'}}}")
+  assert_string_equals("1", Json$(a%(), "m[0][0]"))
+  assert_string_equals("2", Json$(a%(), "m[0][1]"))
+  assert_string_equals("3", Json$(a%(), "m[1][0]"))
+  For i% = 0 To 2
+    assert_string_equals(Str$(i% + 4), Json$(a%(), "m[1][1].n[" + Str$(i%) + "]"))
+  Next
+  assert_string_equals("", Json$(a%(), "m[1][1].n[3]"))
+  assert_string_equals("r", Json$(a%(), "o.p.q"))
+  assert_string_equals("r", Json$(a%(), "o.p.Q"))
+  assert_string_equals("", Json$(a%(), "O.p.q"))
+End Sub
+
+Sub test_json_given_invalid_length()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  Local a%(BASE% + 1), s$
+  LongString Append a%(), to_json$("{'x': 1}")
+  assert_string_equals("1", Json$(a%(), "x"))
+
+  ' Longer than the array.
+  a%(BASE%) = 17
+  On Error Skip 1
+  s$ = Json$(a%(), "x")
+  assert_raw_error("Invalid LONGSTRING length")
+
+  ' Negative.
+  a%(BASE%) = -1
+  On Error Skip 1
+  s$ = Json$(a%(), "x")
+  assert_raw_error("Invalid LONGSTRING length")
+
+  ' Exactly fills the array.
+  a%(BASE%) = 8
+  assert_string_equals("1", Json$(a%(), "x"))
+End Sub
+
 data_test_json:
 Data "text/json"
 Data "{"
@@ -28,6 +28,10 @@ Else
 EndIf
 
 add_test("test_arch")
+add_test("test_background")
+add_test("test_background_given_unknown")
+add_test("test_console")
+add_test("test_console_given_unknown")
 add_test("test_cputime")
 add_test("test_current")
 add_test("test_device")
@@ -47,6 +51,7 @@ add_test("test_filesize_given_directory")
 add_test("test_font_address")
 add_test("test_fontheight")
 add_test("test_fontwidth")
+add_test("test_heap")
 add_test("test_hpos")
 add_test("test_hres")
 add_test("test_line")
@@ -61,10 +66,12 @@ add_test("test_option_fn_key")
 add_test("test_option_resolution")
 add_test("test_option_search_path")
 add_test("test_option_serial")
+add_test("test_option_serial_blocking")
 add_test("test_option_tab")
 add_test("test_path")
 add_test("test_pid")
 add_test("test_pinno")
+add_test("test_txqueue_given_not_serial")
 add_test("test_version")
 add_test("test_vpos")
 add_test("test_vres")
@@ -109,6 +116,55 @@ Sub test_arch()
   assert_string_equals(expected_arch$, Mm.Info$(Arch))
 End Sub
 
+Sub test_background()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+  Local polls% = Mm.Info(Background Polls)
+  Local console% = Mm.Info(Background Console)
+  Local t% = Timer + 50
+  Do While Timer < t% : Loop
+
+  ' Background tasks are rate-limited so should run less often than the
+  ' interpreter polls for them.
+  assert_true(Mm.Info(Background Polls) > polls%)
+  assert_true(Mm.Info(Background Console) > console%)
+  Local runs% = Mm.Info(Background Console) - console%
+  assert_true(runs% < Mm.Info(Background Polls) - polls%)
+  assert_true(Mm.Info(Background Audio) > 0)
+  assert_true(Mm.Info(Background Events) > 0)
+  assert_true(Mm.Info(Background Graphics) > 0)
+  assert_true(Mm.Info(Background Serial) > 0)
+End Sub
+
+Sub test_background_given_unknown()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+  Local dummy%
+  On Error Skip
+  dummy% = Mm.Info(Background Foo)
+  assert_raw_error("Unknown argument")
+End Sub
+
+Sub test_console()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+  Local bytes% = Mm.Info(Console Bytes)
+  Local flushes% = Mm.Info(Console Flushes)
+
+  ' Space followed by backspace so the test output is unaffected.
+  Print " " + Chr$(8);
+  assert_int_equals(bytes% + 2, Mm.Info(Console Bytes))
+
+  ' The FLUSH background task may have already written the output.
+  Flush #0
+  assert_true(Mm.Info(Console Flushes) > flushes%)
+End Sub
+
+Sub test_console_given_unknown()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+  Local dummy%
+  On Error Skip
+  dummy% = Mm.Info(Console Wombat)
+  assert_raw_error("Unknown argument")
+End Sub
+
 Sub test_cputime()
   If Not sys.is_platform%("mmb4l") Then Exit Sub
   Local cputime% = Mm.Info(CpuTime)
@@ -600,6 +656,15 @@ Sub test_fontwidth()
   EndIf
 End Sub
 
+Sub test_heap()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+  Local before% = Mm.Info(Heap)
+  Local s$(10) Length 255
+  assert_int_equals(before% - (11 - BASE%) * 256, Mm.Info(Heap))
+  Erase s$()
+  assert_int_equals(before%, Mm.Info(Heap))
+End Sub
+
 Sub test_hpos()
   If Not sys.is_platform%("mmb4l") Then Exit Sub
 
@@ -930,6 +995,18 @@ Sub test_option_serial()
   EndIf
 End Sub
 
+Sub test_option_serial_blocking()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  assert_string_equals("On", Mm.Info(Option Serial Blocking))
+
+  Option Serial Blocking Off
+  assert_string_equals("Off", Mm.Info(Option Serial Blocking))
+
+  Option Serial Blocking On
+  assert_string_equals("On", Mm.Info(Option Serial Blocking))
+End Sub
+
 Sub test_option_tab()
   If Not sys.is_platform%("mmb4l") Then Exit Sub
 
@@ -1095,6 +1172,18 @@ Sub test_vres()
   EndIf
 End Sub
 
+Sub test_txqueue_given_not_serial()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  MkDir TMPDIR$
+  Open TMPDIR$ + "/test_txqueue.txt" For Output As #1
+  Local dummy%
+  On Error Skip
+  dummy% = Mm.Info(TxQueue #1)
+  assert_raw_error("Not a serial port")
+  Close #1
+End Sub
+
 Sub test_version()
   assert_string_equals(EXPECTED_VERSION$, Left$(Str$(Mm.Info(Version)), Len(EXPECTED_VERSION$)))
 
@@ -28,6 +28,8 @@ add_test("test_exp")
 add_test("test_log")
 add_test("test_sin")
 add_test("test_sqr")
+add_test("test_args_given_brackets")
+add_test("test_args_given_errors")
 
 If InStr(Mm.CmdLine$, "--base") Then run_tests() Else run_tests("--base=1")
 
@@ -100,3 +102,24 @@ End Sub
 Sub test_sqr()
   assert_float_equals(2, Sqr(4), 1e-10)
 End Sub
+
+Sub test_args_given_brackets()
+  Local a$ = "(x)"
+  assert_int_equals(3, Len("a)b"))
+  assert_int_equals(4, Len(UCase$(a$) + ")"))
+  assert_int_equals(6, Abs(-(2 * (1 + 2))))
+  assert_float_equals(2, Sqr(Abs(-4)), 1e-10)
+  assert_int_equals(3, Int(Val("3.5")))
+  assert_int_equals(5, Len(Space$ (5)))
+End Sub
+
+Sub test_args_given_errors()
+  Local x!
+  On Error Skip 1
+  x! = Sqr()
+  assert_raw_error("Syntax")
+
+  On Error Skip 1
+  x! = Sqr(4 5)
+  assert_raw_error("Expression syntax")
+End Sub
@@ -44,6 +44,13 @@ add_test("case insensitive descending sort end",       "tst_case_ins_descending_
 add_test("case insensitive descending sort single",    "tst_case_ins_descending_sort_5")
 add_test("case insensitive descending sort given empty smallest", "tst_case_ins_descending_sort_6")
 add_test("case insensitive descending sort given empty biggest", "tst_case_ins_descending_sort_7")
+add_test("integer ascending sort is stable",           "test_integer_ascending_sort")
+add_test("integer descending sort middle",             "test_integer_descending_sort")
+add_test("float ascending sort is stable",             "test_float_ascending_sort")
+add_test("float descending sort middle",               "test_float_descending_sort")
+add_test("large integer sort",                         "test_large_integer_sort")
+add_test("large float sort",                           "test_large_float_sort")
+add_test("large string sort",                          "test_large_string_sort")
 
 If InStr(Mm.CmdLine$, "--base") Then run_tests() Else run_tests("--base=1")
 
@@ -432,3 +439,118 @@ Sub tst_case_ins_descending_sort_7()
   assert_string_array_equals(exp_a$(), a$())
   assert_int_array_equals(exp_idx%(), idx%())
 End Sub
+
+' Integer ascending sort, equal elements keep their original order.
+Sub test_integer_ascending_sort()
+  Local a%(array.new%(7)) = (3, -1, 2, 3, &h7FFFFFFFFFFFFFFF, -1, &h8000000000000000)
+  Local idx%(array.new%(7))
+
+  Sort a%(), idx%()
+
+  Local exp_a%(array.new%(7)) = (&h8000000000000000, -1, -1, 2, 3, 3, &h7FFFFFFFFFFFFFFF)
+  Local exp_idx%(array.new%(7)) = (base% + 6, base% + 1, base% + 5, base% + 2, base% + 0, base% + 3, base% + 4)
+  assert_int_array_equals(exp_a%(), a%())
+  assert_int_array_equals(exp_idx%(), idx%())
+End Sub
+
+' Integer descending sort of middle 4 elements.
+Sub test_integer_descending_sort()
+  Local a%(array.new%(6)) = (9, 1, 2, 1, 3, 0)
+  Local idx%(array.new%(6))
+
+  Sort a%(), idx%(), &b01, base% + 1, 4
+
+  Local exp_a%(array.new%(6)) = (9, 3, 2, 1, 1, 0)
+  Local exp_idx%(array.new%(6)) = (base% + 0, base% + 4, base% + 2, base% + 1, base% + 3, base% + 5)
+  assert_int_array_equals(exp_a%(), a%())
+  assert_int_array_equals(exp_idx%(), idx%())
+End Sub
+
+' Float ascending sort, equal elements keep their original order.
+Sub test_float_ascending_sort()
+  Local a!(array.new%(6)) = (1.5, -2.25, 1.5, 0.0, -2.25, 1e10)
+  Local idx%(array.new%(6)), i%
+
+  Sort a!(), idx%()
+
+  Local exp_a!(array.new%(6)) = (-2.25, -2.25, 0.0, 1.5, 1.5, 1e10)
+  Local exp_idx%(array.new%(6)) = (base% + 1, base% + 4, base% + 3, base% + 0, base% + 2, base% + 5)
+  For i% = Bound(a!(), 0) To Bound(a!(), 1)
+    assert_float_equals(exp_a!(i%), a!(i%))
+  Next
+  assert_int_array_equals(exp_idx%(), idx%())
+End Sub
+
+' Float descending sort of middle 4 elements.
+Sub test_float_descending_sort()
+  Local a!(array.new%(6)) = (9.0, 0.1, 0.3, 0.1, 0.2, 0.0)
+  Local idx%(array.new%(6)), i%
+
+  Sort a!(), idx%(), &b01, base% + 1, 4
+
+  Local exp_a!(array.new%(6)) = (9.0, 0.3, 0.2, 0.1, 0.1, 0.0)
+  Local exp_idx%(array.new%(6)) = (base% + 0, base% + 2, base% + 4, base% + 1, base% + 3, base% + 5)
+  For i% = Bound(a!(), 0) To Bound(a!(), 1)
+    assert_float_equals(exp_a!(i%), a!(i%))
+  Next
+  assert_int_array_equals(exp_idx%(), idx%())
+End Sub
+
+' Sorting a large array should be quick, O(n log n) or better.
+Sub test_large_integer_sort()
+  Const N% = 20000
+  Local a%(array.new%(N%)), idx%(array.new%(N%)), i%, t!
+
+  For i% = base% To base% + N% - 1
+    a%(i%) = ((i% * 7919) Mod 10007) - 5000
+  Next
+
+  t! = Timer
+  Sort a%(), idx%()
+  assert_true(Timer - t! < 1000)
+
+  For i% = base% + 1 To base% + N% - 1
+    If a%(i% - 1) > a%(i%) Then assert_fail("Not sorted at " + Str$(i%)) : Exit For
+    If a%(i% - 1) = a%(i%) And idx%(i% - 1) > idx%(i%) Then assert_fail("Not stable at " + Str$(i%)) : Exit For
+  Next
+  For i% = base% To base% + N% - 1 Step 997
+    assert_int_equals(((idx%(i%) * 7919) Mod 10007) - 5000, a%(i%))
+  Next
+End Sub
+
+Sub test_large_float_sort()
+  Const N% = 20000
+  Local a!(array.new%(N%)), idx%(array.new%(N%)), i%, t!
+
+  For i% = base% To base% + N% - 1
+    a!(i%) = (((i% * 7919) Mod 10007) - 5000) / 8
+  Next
+
+  t! = Timer
+  Sort a!(), idx%(), &b01
+  assert_true(Timer - t! < 1000)
+
+  For i% = base% + 1 To base% + N% - 1
+    If a!(i% - 1) < a!(i%) Then assert_fail("Not sorted at " + Str$(i%)) : Exit For
+    If a!(i% - 1) = a!(i%) And idx%(i% - 1) > idx%(i%) Then assert_fail("Not stable at " + Str$(i%)) : Exit For
+  Next
+End Sub
+
+Sub test_large_string_sort()
+  Const N% = 10000
+  Local a$(array.new%(N%)) Length 8
+  Local idx%(array.new%(N%)), i%, t!
+
+  For i% = base% To base% + N% - 1
+    a$(i%) = Choice(i% Mod 2, "x", "X") + Hex$((i% * 7919) Mod 4001)
+  Next
+
+  t! = Timer
+  Sort a$(), idx%(), &b10
+  assert_true(Timer - t! < 1000)
+
+  For i% = base% + 1 To base% + N% - 1
+    If UCase$(a$(i% - 1)) > UCase$(a$(i%)) Then assert_fail("Not sorted at " + Str$(i%)) : Exit For
+    If UCase$(a$(i% - 1)) = UCase$(a$(i%)) And idx%(i% - 1) > idx%(i%) Then assert_fail("Not stable at " + Str$(i%)) : Exit For
+  Next
+End Sub
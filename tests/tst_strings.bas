@@ -32,6 +32,7 @@ add_test("test_str2bin_function")
 add_test("test special chars with OPTION ESCAPE","test_option_escape")
 add_test("test special chars in DATA strings","test_option_escape_given_data")
 add_test("test special case &00 and 000","test_option_escape_given_null")
+add_test("test_string_literals_in_loop")
 
 If InStr(Mm.CmdLine$, "--base") Then run_tests() Else run_tests("--base=1")
 
@@ -336,6 +337,17 @@ Sub test_option_escape_given_null()
   assert_raw_error("Null character \\000 in escape sequence - use CHR$(0)")
 End Sub
 
+Sub test_string_literals_in_loop()
+  Local i%, s$
+  For i% = 1 To 3
+    s$ = "abc"
+    Mid$(s$, 1, 1) = "X"
+    Inc s$, "def"
+    assert_string_equals("Xbcdef", s$)
+    assert_string_equals("abc", "abc" + "")
+  Next
+End Sub
+
 string_data_null_1:
 Data "*\&00*"
 
@@ -26,6 +26,7 @@ add_test("test_time")
 add_test("test_timer")
 add_test("test_timer_given_large_value")
 add_test("test_pause")
+add_test("test_pause_is_idle")
 add_test("test_settick")
 
 If InStr(Mm.CmdLine$, "--base") Then run_tests() Else run_tests("--base=1")
@@ -198,6 +199,25 @@ Sub test_pause()
   assert_float_equals(Timer, t% + 1000, 10)
 End Sub
 
+Sub test_pause_is_idle()
+  If Not sys.is_platform%("mmb4l") Then Exit Sub
+
+  ' PAUSE should block rather than spin, so it should use a small fraction of
+  ' the CPU time it would take to busy wait.
+  Local cputime% = Mm.Info(CpuTime)
+  Pause 200
+  assert_true(Mm.Info(CpuTime) - cputime% < 50000000)
+
+  ' Including when there are SETTICK interrupts to service.
+  SetTick 20, inc_t1, 1
+  cputime% = Mm.Info(CpuTime)
+  Pause 200
+  SetTick 0, inc_t1, 1
+  assert_true(Mm.Info(CpuTime) - cputime% < 50000000)
+  assert_true(t1% >= 9)
+  t1% = 0
+End Sub
+
 Sub test_settick()
   SetTick 100, inc_t1, 1
   SetTick  50, inc_t2, 2